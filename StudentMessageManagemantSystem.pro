@@ -1,21 +1,15 @@
-
-QT += core gui widgets sql
-QT += core gui widgets sql concurrent
-TARGET = StudentMessageManagementSystem
-TEMPLATE = app
-CONFIG += c++17
-
-SOURCES += \
-    main.cpp \
-    mainwindow.cpp \
-    StudentMessageManagementSystem.cpp
-
-HEADERS += \
-    mainwindow.h \
-    student.h \
-    binarysearchtree.h \
-    StudentMessageManagementSystem.h
-
-FORMS += \
-    StudentMessageManagementSystem.ui
-
+# 一次构建全部目标: 数据访问库 → 界面程序 / 基准测试 / 命令行工具 / 单元测试
+# 每个子项目在自己的目录下（构建目录中对应同名子目录），生成的 Makefile、目标文件和 moc/uic 输出互不覆盖
+TEMPLATE = subdirs
+
+SUBDIRS += repository app benchmark cli tests
+
+repository.file = repository/StudentRepository.pro
+app.file = app/StudentMessageManagementSystem.pro
+app.depends = repository
+benchmark.file = benchmark/StudentBenchmark.pro
+benchmark.depends = repository
+cli.file = cli/StudentCli.pro
+cli.depends = repository
+tests.file = tests/tests.pro
+tests.depends = repository
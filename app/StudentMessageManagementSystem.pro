@@ -0,0 +1,31 @@
+# 界面程序，源码在上一级目录，由顶层 StudentMessageManagemantSystem.pro 在数据访问库之后构建
+QT += core gui widgets sql concurrent
+TARGET = StudentMessageManagementSystem
+TEMPLATE = app
+CONFIG += c++17
+
+include(../studentrepository.pri)
+
+SOURCES += \
+    $$PWD/../main.cpp \
+    $$PWD/../mainwindow.cpp \
+    $$PWD/../parsebenchmark.cpp \
+    $$PWD/../studenttablemodel.cpp \
+    $$PWD/../StudentMessageManagementSystem.cpp
+
+HEADERS += \
+    $$PWD/../mainwindow.h \
+    $$PWD/../student.h \
+    $$PWD/../binarysearchtree.h \
+    $$PWD/../bplustree.h \
+    $$PWD/../nodearena.h \
+    $$PWD/../parsebenchmark.h \
+    $$PWD/../studenttablemodel.h \
+    $$PWD/../spatialgrid.h \
+    $$PWD/../stringpool.h \
+    $$PWD/../compactstudent.h \
+    $$PWD/../StudentMessageManagementSystem.h
+
+FORMS += \
+    $$PWD/../StudentMessageManagementSystem.ui
+
@@ -0,0 +1,22 @@
+QT += core sql concurrent
+QT -= gui
+TARGET = StudentBenchmark
+TEMPLATE = app
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+include(../studentrepository.pri)
+
+SOURCES += \
+    $$PWD/../benchmarkmain.cpp \
+    $$PWD/../studentbenchmark.cpp
+
+HEADERS += \
+    $$PWD/../studentbenchmark.h \
+    $$PWD/../student.h \
+    $$PWD/../binarysearchtree.h \
+    $$PWD/../spatialgrid.h \
+    $$PWD/../nodearena.h \
+    $$PWD/../stringpool.h \
+    $$PWD/../compactstudent.h \
+    $$PWD/../bplustree.h
@@ -0,0 +1,63 @@
+/**
+ * @file       benchmarkmain.cpp
+ * @brief      基准测试程序（StudentBenchmark）的入口，不创建任何窗口
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0: [lzq] [2026-10-17] [创建文件]
+ */
+
+#include "studentbenchmark.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+/**
+ * @brief 基准测试程序的主入口点
+ * @param argc 命令行参数计数
+ * @param argv 命令行参数数组
+ * @return 0 表示全部测量完成
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("StudentBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless benchmark of the import, export, paged query and tree code paths.");
+    parser.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "Comma separated dataset sizes in rows.", "rows", "10000,1000000,10000000");
+    QCommandLineOption dirOption("dir", "Directory for generated data and the database.", "directory");
+    QCommandLineOption outputOption("output", "Write the JSON report to this file instead of stdout.", "file");
+    QCommandLineOption roundsOption("rounds", "Repetitions of each query measurement.", "count", "5");
+    QCommandLineOption keepOption("keep", "Keep generated data files and the database.");
+    parser.addOptions({sizesOption, dirOption, outputOption, roundsOption, keepOption});
+    parser.process(app);
+
+    BenchmarkOptions options;
+    options.sizes.clear();
+    for (const QString &size : parser.value(sizesOption).split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const qint64 rows = size.trimmed().toLongLong(&ok);
+        if (!ok || rows <= 0) {
+            QTextStream(stderr) << "Invalid dataset size: " << size << Qt::endl;
+            return 2;
+        }
+        options.sizes.append(rows);
+    }
+    bool ok = false;
+    options.rounds = parser.value(roundsOption).toInt(&ok);
+    if (!ok || options.rounds <= 0) {
+        QTextStream(stderr) << "Invalid round count: " << parser.value(roundsOption) << Qt::endl;
+        return 2;
+    }
+    options.workDir = parser.value(dirOption);
+    options.outputPath = parser.value(outputOption);
+    options.keepFiles = parser.isSet(keepOption);
+
+    return runBenchmark(options);
+}
@@ -4,11 +4,18 @@
  * @copyright  Copyright (c) 2025
  * @license    MIT
  * @author     lzq
- * @version    1.0
- * @date       2025-11-13
+ * @version    1.7
+ * @date       2026-10-17
  *
  * @par        版本历史:
  *             V1.0:[lzq] [2025-11-13] [创建文件并实现二叉搜索树核心功能]
+ *             V1.1:[lzq] [2026-10-17] [插入/删除时按AVL规则自平衡，有序学号不再退化为链表]
+ *             V1.2:[lzq] [2026-10-17] [节点改为从NodeArena分块分配，以32位下标代替shared_ptr链接]
+ *             V1.3:[lzq] [2026-10-17] [新增非递归迭代器和forEach/visitUntil访问接口，遍历不再复制数据]
+ *             V1.4:[lzq] [2026-10-17] [节点维护子树规模，size()为O(1)，新增select/rank/seek顺序统计接口]
+ *             V1.5:[lzq] [2026-10-17] [新增可选的姓名哈希索引和X坐标有序索引，删除时改为摘接后继节点]
+ *             V1.6:[lzq] [2026-10-17] [新增出生日期有序索引，最年轻/最年长的前N名学生不再全树遍历]
+ *             V1.7:[lzq] [2026-10-17] [新增地址坐标网格索引，支持矩形、圆形范围查询和k近邻查询]
  *
  * @par        性能与扩展性分析:
  *             当数据量达到千万级时，当前基于内存的二叉搜索树会面临以下问题:
@@ -17,20 +24,30 @@
  *             3. 缓存效率低: 链式结构的内存不连续，CPU缓存命中率低
  *
  *             解决方案:
- *             1. 使用自平衡二叉树(AVL树或红黑树)保证O(log n)性能
- *             2. 采用B+树或B树结构，提高内存空间利用和磁盘I/O效率
+ *             1. 使用自平衡二叉树(AVL树或红黑树)保证O(log n)性能 (V1.1 已采用AVL树)
+ *             2. 采用B+树或B树结构，提高内存空间利用和磁盘I/O效率 (见 bplustree.h)
  *             3. 使用SQLite/MySQL等数据库，支持持久化和大规模数据存储
  *             4. 实现分页加载机制，在需要时才从数据库加载数据到内存
+ *             5. 节点从连续内存块分配并以32位下标链接，缓解内存碎片和缓存效率问题 (V1.2 已采用 nodearena.h)
  */
 
 #ifndef BINARYSEARCHTREE_H
 #define BINARYSEARCHTREE_H
 
 #include "student.h"
+#include "nodearena.h"
+#include "spatialgrid.h"
 #include <QVector>
 #include <QList>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 /**
  * @class BinarySearchTree
@@ -39,11 +56,45 @@
  * 该类实现了一个完整的二叉搜索树，用于存储和管理学生信息。它支持标准的BST操作：插入、删除、
  * 查询和各种遍历方法。
  *
+ * 每次插入和删除后都会沿回溯路径按AVL规则旋转，保证任意节点左右子树高度差不超过1。
+ * 因此即使按递增学号（例如 generate_data.py 生成的 2025%07d）顺序插入，树高也始终为
+ * O(log n)，递归辅助函数的调用深度同样受此约束。
+ *
+ * 节点存放在 NodeArena 分块节点池中，左右孩子以32位下标链接（Nil 表示空）。
+ * 节点池的块地址固定，因此递归辅助函数可以安全地持有指向孩子链接的引用。
+ *
+ * 遍历既可以通过 begin()/end() 迭代器，也可以通过 forEach/visitUntil 访问者完成，
+ * 两者都以 const 引用交出数据，使用固定大小的显式栈而非递归，不分配额外内存。
+ *
+ * 每个节点同时维护子树规模，旋转时与树高一起更新，从而支持O(log n)的顺序统计：
+ * select(k) 取第k名学生、rank(id) 求学号的名次、seek(k) 直接定位到第k名开始迭代，
+ * 内存分页可以直接跳到任意页而无需逐条走过前面的记录。
+ *
+ * 通过 enableSecondaryIndexes() 可以为姓名（哈希索引）、X坐标和出生日期（有序索引）建立二级索引，
+ * 索引保存节点下标，在 insert/deleteStudent/clear 时同步维护。出生日期索引按从年轻到年长排列，
+ * 最年轻/最年长的前N名学生直接从索引两端读取。地址坐标 (X, Y) 可启用均匀网格索引（spatialgrid.h），
+ * 矩形、圆形范围查询和k近邻查询只访问相关的格子。删除有两个孩子的节点时，
+ * 后继节点被整体摘下并接到被删节点的位置，而不是复制数据，因此记录的节点下标终生不变。
+ *
  * @tparam T 数据类型（本应用中为Student）
  */
 template<typename T>
 class BinarySearchTree
 {
+public:
+    /**
+     * @enum SecondaryIndex
+     * @brief 可选二级索引，可按位组合
+     */
+    enum SecondaryIndex
+    {
+        NoIndex = 0x0,       ///< 不建立二级索引，按姓名/坐标查询需要全树遍历
+        NameIndex = 0x1,     ///< 姓名 -> 节点集合的哈希索引
+        CoordXIndex = 0x2,   ///< X坐标 -> 节点集合的有序索引
+        BirthDateIndex = 0x4,///< (出生日期, 学号) -> 节点的有序索引，从年轻到年长
+        SpatialIndex = 0x8   ///< (X, Y) 坐标 -> 节点的网格索引
+    };
+    
 private:
     /**
      * @struct Node
@@ -52,26 +103,104 @@ private:
     struct Node
     {
         T data;                          ///< 存储在该节点中的学生数据
-        std::shared_ptr<Node> left;      ///< 左子树
-        std::shared_ptr<Node> right;     ///< 右子树
+        int left;                        ///< 左子树下标（Nil 表示空）
+        int right;                       ///< 右子树下标（Nil 表示空）
+        int height;                      ///< 以该节点为根的子树高度（叶子为1）
+        int count;                       ///< 以该节点为根的子树中的节点数（叶子为1）
         
         /**
-         * @brief 节点构造函数
-         * @param value 要存储在节点中的数据
+         * @brief 节点构造函数，节点池按块批量默认构造节点
          */
-        Node(const T& value) : data(value), left(nullptr), right(nullptr) {}
+        Node() : data(), left(NodeArena<Node>::Nil), right(NodeArena<Node>::Nil), height(1), count(1) {}
     };
     
-    std::shared_ptr<Node> root;  ///< BST的根节点
+    static constexpr int Nil = NodeArena<Node>::Nil;  ///< 空链接
+    
+    /// 显式遍历栈的容量。AVL树高不超过 1.44 * log2(n + 2)，32位下标下远小于该值
+    static constexpr int MaxHeight = 64;
+    
+    /**
+     * @struct PathStack
+     * @brief 非递归遍历使用的固定容量栈，避免堆分配
+     */
+    struct PathStack
+    {
+        int items[MaxHeight];
+        int depth = 0;
+        
+        void push(int node) { items[depth++] = node; }
+        int pop() { return items[--depth]; }
+        int top() const { return items[depth - 1]; }
+        bool isEmpty() const { return depth == 0; }
+    };
+    
+    NodeArena<Node> nodes;  ///< 节点池，持有全部节点
+    int root;               ///< BST根节点的下标
+    
+    int indexFlags;                       ///< 已启用的二级索引（SecondaryIndex 按位组合）
+    QHash<QString, QSet<int>> nameIndex;  ///< 姓名 -> 节点下标
+    QMap<int, QSet<int>> coordXIndex;     ///< X坐标 -> 节点下标，按坐标有序
+    
+    /**
+     * @struct BirthDateKey
+     * @brief 出生日期索引的键：出生日期晚（年轻）的在前，同一天出生的按学号升序
+     */
+    struct BirthDateKey
+    {
+        qint64 day;         ///< QDate::toJulianDay()
+        QString studentID;
+        
+        bool operator<(const BirthDateKey& other) const
+        {
+            if (day != other.day) return day > other.day;
+            return studentID < other.studentID;
+        }
+    };
+    QMap<BirthDateKey, int> birthDateIndex;  ///< (出生日期, 学号) -> 节点下标，最年轻的在最前
+    std::unique_ptr<SpatialGrid> spatialIndex;  ///< 坐标网格，启用 SpatialIndex 时才分配
     
 public:
+    /**
+     * @class const_iterator
+     * @brief 按学号升序（中序）遍历的只读前向迭代器
+     * @note 迭代器内含固定容量的路径栈，不分配内存；修改树后原有迭代器失效
+     */
+    class const_iterator
+    {
+    public:
+        const_iterator() : tree(nullptr) {}
+        
+        const T& operator*() const { return tree->nodes[path.top()].data; }
+        const T* operator->() const { return &tree->nodes[path.top()].data; }
+        
+        const_iterator& operator++()
+        {
+            int node = path.pop();
+            tree->pushLeftSpine(path, tree->nodes[node].right);
+            return *this;
+        }
+        
+        bool operator==(const const_iterator& other) const
+        {
+            return path.depth == other.path.depth && (path.isEmpty() || path.top() == other.path.top());
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+        
+    private:
+        friend class BinarySearchTree;
+        explicit const_iterator(const BinarySearchTree* t) : tree(t) {}
+        
+        const BinarySearchTree* tree;
+        PathStack path;
+    };
+    
     /**
      * @brief 构造函数 - 初始化一个空的BST
      */
-    BinarySearchTree() : root(nullptr) {}
+    BinarySearchTree() : root(Nil), indexFlags(NoIndex) {}
 
     /**
-     * @brief 析构函数 - 通过shared_ptr自动释放所有节点
+     * @brief 析构函数 - 由节点池整体释放所有节点
      */
     ~BinarySearchTree() = default;
     
@@ -79,11 +208,17 @@ public:
      * @brief 向BST中插入一个新的学生记录
      * @param[in] data 要插入的学生对象
      * @return 如果插入成功返回true，如果学生ID已存在返回false
-     * @note 时间复杂度: 平均情况O(log n)，最坏情况O(n)（非平衡树）
+     * @note 时间复杂度: O(log n)，插入后自动旋转保持平衡
      */
     bool insert(const T& data)
     {
-        return insertRecursive(root, data);
+        int newNode = Nil;
+        if (!insertRecursive(root, data, newNode))
+        {
+            return false;
+        }
+        addToIndexes(newNode);
+        return true;
     }
     
     /**
@@ -91,10 +226,16 @@ public:
      * @param[in] studentID 要删除的学生的ID
      * @return 如果删除成功返回true，如果学生未找到返回false
      * @note 处理所有三种情况：叶子节点、有一个孩子的节点、有两个孩子的节点
-     * @note 时间复杂度: 平均情况O(log n)，最坏情况O(n)
+     * @note 时间复杂度: O(log n)，删除后自动旋转保持平衡
      */
     bool deleteStudent(const QString& studentID)
     {
+        int node = findNode(studentID);
+        if (node == Nil)
+        {
+            return false;
+        }
+        removeFromIndexes(node);
         return deleteRecursive(root, studentID);
     }
     
@@ -103,11 +244,17 @@ public:
      * @param[in] studentID 要查找的ID
      * @param[out] result 如果找到，将包含学生数据
      * @return 如果找到学生返回true，否则返回false
-     * @note 时间复杂度: 平均情况O(log n)，最坏情况O(n)
+     * @note 时间复杂度: O(log n)
      */
     bool search(const QString& studentID, T& result) const
     {
-        return searchRecursive(root, studentID, result);
+        int node = findNode(studentID);
+        if (node == Nil)
+        {
+            return false;
+        }
+        result = nodes[node].data;
+        return true;
     }
     
     /**
@@ -117,22 +264,68 @@ public:
      */
     bool contains(const QString& studentID) const
     {
-        T dummy;
-        return search(studentID, dummy);
+        return findNode(studentID) != Nil;
+    }
+    
+    /**
+     * @brief Enable secondary indexes and build them from the current contents
+     * @param[in] flags Bitwise combination of SecondaryIndex values; indexes not listed are dropped
+     * @note Time Complexity: O(n) to build; afterwards each index is maintained in O(1)/O(log n)
+     *       per insert/deleteStudent
+     */
+    void enableSecondaryIndexes(int flags)
+    {
+        nameIndex.clear();
+        coordXIndex.clear();
+        birthDateIndex.clear();
+        spatialIndex.reset(flags & SpatialIndex ? new SpatialGrid : nullptr);
+        
+        indexFlags = flags;
+        if (indexFlags == NoIndex) return;
+        
+        // 通过栈遍历收集节点下标，与 forEach 相同但需要的是下标而不是数据
+        PathStack stack;
+        pushLeftSpine(stack, root);
+        while (!stack.isEmpty())
+        {
+            int node = stack.pop();
+            addToIndexes(node);
+            pushLeftSpine(stack, nodes[node].right);
+        }
+    }
+    
+    /**
+     * @brief Currently enabled secondary indexes
+     * @return Bitwise combination of SecondaryIndex values
+     */
+    int secondaryIndexes() const
+    {
+        return indexFlags;
     }
     
     /**
      * @brief Get all students with a specific name
      * @param[in] name The name to search for
      * @return QVector containing all students with matching name
-     * @note Time Complexity: O(n) - requires full tree traversal
-     * @note Performance Note: This operation must scan entire tree. For large datasets,
-     *       consider indexing by name or using database backend for faster results
+     * @note Time Complexity: O(1 + k) with NameIndex enabled (results in unspecified order),
+     *       otherwise O(n) - requires full tree traversal (results sorted by ID)
      */
     QVector<T> searchByName(const QString& name) const
     {
         QVector<T> results;
-        searchByNameRecursive(root, name, results);
+        if (indexFlags & NameIndex)
+        {
+            collectIndexed(nameIndex.value(name), results);
+            return results;
+        }
+        
+        // 必须检查所有节点，因为树是按ID排序的，不是按姓名
+        forEach([&](const T& data) {
+            if (data.name == name)
+            {
+                results.push_back(data);
+            }
+        });
         return results;
     }
     
@@ -140,42 +333,203 @@ public:
      * @brief Get all students with a specific address X coordinate
      * @param[in] coordX The X coordinate to search for
      * @return QVector containing all students at that X coordinate
-     * @note Time Complexity: O(n) - requires full tree traversal
+     * @note Time Complexity: O(log n + k) with CoordXIndex enabled (results in unspecified order),
+     *       otherwise O(n) - requires full tree traversal (results sorted by ID)
      */
     QVector<T> searchByAddressCoordX(int coordX) const
     {
         QVector<T> results;
-        searchByAddressCoordXRecursive(root, coordX, results);
+        if (indexFlags & CoordXIndex)
+        {
+            collectIndexed(coordXIndex.value(coordX), results);
+            return results;
+        }
+        
+        // 必须检查所有节点，因为树是按ID排序的，不是按坐标
+        forEach([&](const T& data) {
+            if (data.addressCoordX == coordX)
+            {
+                results.push_back(data);
+            }
+        });
         return results;
     }
     
     /**
-     * @brief Find the youngest student (latest birth date)
+     * @brief Find the youngest student (latest birth date, smallest ID among ties)
      * @param[out] student Will contain the youngest student if found
      * @return true if tree is not empty, false otherwise
-     * @note Time Complexity: O(n) - requires full tree traversal
+     * @note Time Complexity: O(1) with BirthDateIndex enabled,
+     *       otherwise O(n) - requires full tree traversal, but only the result is copied
      */
     bool findYoungestStudent(T& student) const
     {
-        if (!root) return false;
+        if (root == Nil) return false;
         
-        QVector<T> allStudents;
-        inorderTraversalRecursive(root, allStudents);
+        if (indexFlags & BirthDateIndex)
+        {
+            student = nodes[birthDateIndex.first()].data;
+            return true;
+        }
         
-        if (allStudents.isEmpty()) return false;
+        const T* youngest = nullptr;
+        forEach([&](const T& data) {
+            if (!youngest || data.birthDate > youngest->birthDate)
+            {
+                youngest = &data;
+            }
+        });
+        student = *youngest;
+        return true;
+    }
+    
+    /**
+     * @brief Find the oldest student (earliest birth date, largest ID among ties)
+     * @param[out] student Will contain the oldest student if found
+     * @return true if tree is not empty, false otherwise
+     * @note Time Complexity: O(1) with BirthDateIndex enabled, otherwise O(n)
+     */
+    bool findOldestStudent(T& student) const
+    {
+        if (root == Nil) return false;
         
-        T youngest = allStudents[0];
-        for (const auto& s : allStudents)
+        if (indexFlags & BirthDateIndex)
         {
-            if (s.birthDate > youngest.birthDate)
+            student = nodes[birthDateIndex.last()].data;
+            return true;
+        }
+        
+        const T* oldest = nullptr;
+        forEach([&](const T& data) {
+            if (!oldest || !isYounger(data, *oldest))
             {
-                youngest = s;
+                oldest = &data;
             }
-        }
-        student = youngest;
+        });
+        student = *oldest;
         return true;
     }
     
+    /**
+     * @brief Get the n youngest students, youngest first
+     * @param[in] n Maximum number of students to return
+     * @return Up to n students ordered by birth date descending, then ID ascending
+     * @note Time Complexity: O(log n + k) with BirthDateIndex enabled,
+     *       otherwise O(n log k) - one traversal keeping a heap of the best k
+     */
+    QVector<T> youngestStudents(int n) const
+    {
+        QVector<T> results;
+        if (n <= 0 || root == Nil) return results;
+        
+        if (indexFlags & BirthDateIndex)
+        {
+            results.reserve(std::min(n, birthDateIndex.size()));
+            for (auto it = birthDateIndex.cbegin(); it != birthDateIndex.cend() && results.size() < n; ++it)
+            {
+                results.push_back(nodes[it.value()].data);
+            }
+            return results;
+        }
+        
+        return selectTop(n, [](const T& a, const T& b) { return isYounger(a, b); });
+    }
+    
+    /**
+     * @brief Get the n oldest students, oldest first
+     * @param[in] n Maximum number of students to return
+     * @return Up to n students in the exact reverse of the youngestStudents() order
+     * @note Time Complexity: O(log n + k) with BirthDateIndex enabled, otherwise O(n log k)
+     */
+    QVector<T> oldestStudents(int n) const
+    {
+        QVector<T> results;
+        if (n <= 0 || root == Nil) return results;
+        
+        if (indexFlags & BirthDateIndex)
+        {
+            results.reserve(std::min(n, birthDateIndex.size()));
+            for (auto it = birthDateIndex.cend(); it != birthDateIndex.cbegin() && results.size() < n; )
+            {
+                --it;
+                results.push_back(nodes[it.value()].data);
+            }
+            return results;
+        }
+        
+        return selectTop(n, [](const T& a, const T& b) { return isYounger(b, a); });
+    }
+    
+    /**
+     * @brief Get all students whose address lies in a rectangle (bounds inclusive)
+     * @return Matching students sorted by ID
+     * @note Time Complexity: O(cells + k log k) with SpatialIndex enabled, otherwise O(n)
+     */
+    QVector<T> searchInBox(int minX, int minY, int maxX, int maxY) const
+    {
+        QVector<T> results;
+        if (indexFlags & SpatialIndex)
+        {
+            std::vector<int> found;
+            spatialIndex->visitBox(minX, minY, maxX, maxY, [&](const SpatialGrid::Entry& entry) {
+                found.push_back(entry.item);
+            });
+            std::sort(found.begin(), found.end(), [this](int a, int b) {
+                return nodes[a].data.studentID < nodes[b].data.studentID;
+            });
+            results.reserve(int(found.size()));
+            for (int node : found)
+            {
+                results.push_back(nodes[node].data);
+            }
+            return results;
+        }
+        
+        // 树按学号有序，遍历结果天然按学号排序
+        forEach([&](const T& data) {
+            if (data.addressCoordX >= minX && data.addressCoordX <= maxX
+                && data.addressCoordY >= minY && data.addressCoordY <= maxY)
+            {
+                results.push_back(data);
+            }
+        });
+        return results;
+    }
+    
+    /**
+     * @brief Get all students within a distance of (x, y)
+     * @param[in] radius Maximum Euclidean distance (inclusive)
+     * @return Matching students sorted by distance, then ID
+     * @note Time Complexity: O(cells + k log k) with SpatialIndex enabled, otherwise O(n + k log k)
+     */
+    QVector<T> searchInRadius(int x, int y, int radius) const
+    {
+        if (radius < 0) return QVector<T>();
+        return collectByDistance(x, y, qint64(radius) * radius, -1);
+    }
+    
+    /**
+     * @brief Get the k students nearest to (x, y)
+     * @return Up to k students sorted by distance, then ID
+     * @note Time Complexity: O(cells + k log k) with SpatialIndex enabled,
+     *       otherwise O(n log k) - one traversal keeping a heap of the best k
+     */
+    QVector<T> nearestStudents(int x, int y, int k) const
+    {
+        if (k <= 0 || root == Nil) return QVector<T>();
+        
+        if (indexFlags & SpatialIndex)
+        {
+            // 先求第k近的距离，再取该半径内的全部点（含并列）排序后截断，结果与无索引时一致
+            return collectByDistance(x, y, spatialIndex->nearestDistance2(x, y, k), k);
+        }
+        
+        return selectTop(k, [x, y](const T& a, const T& b) {
+            const qint64 da = distance2(a, x, y), db = distance2(b, x, y);
+            return da != db ? da < db : a.studentID < b.studentID;
+        });
+    }
+    
     /**
      * @brief Get all students in pre-order traversal
      * @return QVector of students in pre-order sequence (root, left, right)
@@ -184,7 +538,8 @@ public:
     QVector<T> preorderTraversal() const
     {
         QVector<T> result;
-        preorderTraversalRecursive(root, result);
+        result.reserve(size());
+        forEachPreorder([&](const T& data) { result.push_back(data); });
         return result;
     }
     
@@ -193,11 +548,13 @@ public:
      * @return QVector of students in in-order sequence (left, root, right)
      *         Results are sorted by student ID
      * @note Time Complexity: O(n)
+     * @note Prefer begin()/end() or forEach() when the caller only needs to read each record
      */
     QVector<T> inorderTraversal() const
     {
         QVector<T> result;
-        inorderTraversalRecursive(root, result);
+        result.reserve(size());
+        forEach([&](const T& data) { result.push_back(data); });
         return result;
     }
     
@@ -209,17 +566,122 @@ public:
     QVector<T> postorderTraversal() const
     {
         QVector<T> result;
-        postorderTraversalRecursive(root, result);
+        result.reserve(size());
+        forEachPostorder([&](const T& data) { result.push_back(data); });
         return result;
     }
     
+    /**
+     * @brief Iterator to the student with the smallest ID
+     * @note Time Complexity: O(log n); iteration is O(1) amortized per step
+     */
+    const_iterator begin() const
+    {
+        const_iterator it(this);
+        pushLeftSpine(it.path, root);
+        return it;
+    }
+    
+    /**
+     * @brief Past-the-end iterator
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this);
+    }
+    
+    /**
+     * @brief Visit every student in in-order sequence (sorted by student ID)
+     * @param[in] visitor Called as visitor(const T&) for each student
+     * @note Time Complexity: O(n), no extra memory, no recursion
+     */
+    template<typename Visitor>
+    void forEach(Visitor visitor) const
+    {
+        walkInorder([&](const T& data) {
+            visitor(data);
+            return false;
+        });
+    }
+    
+    /**
+     * @brief Visit students in in-order sequence until the predicate returns true
+     * @param[in] predicate Called as predicate(const T&); returning true stops the walk
+     * @return true if the walk was stopped by the predicate, false if every student was visited
+     */
+    template<typename Predicate>
+    bool visitUntil(Predicate predicate) const
+    {
+        return walkInorder(predicate);
+    }
+    
+    /**
+     * @brief Visit every student in pre-order sequence (root, left, right)
+     */
+    template<typename Visitor>
+    void forEachPreorder(Visitor visitor) const
+    {
+        if (root == Nil) return;
+        
+        PathStack stack;
+        stack.push(root);
+        while (!stack.isEmpty())
+        {
+            int node = stack.pop();
+            visitor(nodes[node].data);
+            // 先压右孩子，保证左子树先被访问
+            if (nodes[node].right != Nil) stack.push(nodes[node].right);
+            if (nodes[node].left != Nil) stack.push(nodes[node].left);
+        }
+    }
+    
+    /**
+     * @brief Visit every student in post-order sequence (left, right, root)
+     */
+    template<typename Visitor>
+    void forEachPostorder(Visitor visitor) const
+    {
+        PathStack stack;
+        int lastVisited = Nil;
+        int node = root;
+        while (node != Nil || !stack.isEmpty())
+        {
+            if (node != Nil)
+            {
+                stack.push(node);
+                node = nodes[node].left;
+                continue;
+            }
+            
+            int top = stack.top();
+            // 右子树存在且尚未访问时先进入右子树，否则访问栈顶节点
+            if (nodes[top].right != Nil && nodes[top].right != lastVisited)
+            {
+                node = nodes[top].right;
+            }
+            else
+            {
+                visitor(nodes[top].data);
+                lastVisited = stack.pop();
+            }
+        }
+    }
+    
     /**
      * @brief Clear all students from the tree
-     * @note All nodes are automatically deallocated via shared_ptr
+     * @note The node arena releases its chunks in one pass; no recursive destructor cascade
      */
     void clear()
     {
-        root = nullptr;
+        nodes.clear();
+        root = Nil;
+        nameIndex.clear();
+        coordXIndex.clear();
+        birthDateIndex.clear();
+        if (spatialIndex)
+        {
+            spatialIndex->clear();
+        }
     }
     
     /**
@@ -228,51 +690,265 @@ public:
      */
     bool isEmpty() const
     {
-        return root == nullptr;
+        return root == Nil;
     }
     
     /**
      * @brief Get the total number of students in the tree
      * @return Number of nodes in the tree
-     * @note Time Complexity: O(n)
+     * @note Time Complexity: O(1) - read from the root's subtree count
      */
     int size() const
     {
-        return sizeRecursive(root);
+        return nodeCount(root);
+    }
+    
+    /**
+     * @brief Get the k-th student in ascending ID order
+     * @param[in] k Zero-based position, 0 <= k < size()
+     * @param[out] result Will contain the student data if k is in range
+     * @return true if k is in range, false otherwise
+     * @note Time Complexity: O(log n)
+     */
+    bool select(int k, T& result) const
+    {
+        const_iterator it = seek(k);
+        if (it == end()) return false;
+        
+        result = *it;
+        return true;
+    }
+    
+    /**
+     * @brief Get the zero-based position of a student in ascending ID order
+     * @param[in] studentID The ID to look up
+     * @return Position of the student, or -1 if the ID is not in the tree
+     * @note Time Complexity: O(log n)
+     */
+    int rank(const QString& studentID) const
+    {
+        int before = 0;
+        int node = root;
+        while (node != Nil)
+        {
+            if (studentID < nodes[node].data.studentID)
+            {
+                node = nodes[node].left;
+            }
+            else if (studentID > nodes[node].data.studentID)
+            {
+                // 左子树和当前节点都排在目标之前
+                before += nodeCount(nodes[node].left) + 1;
+                node = nodes[node].right;
+            }
+            else
+            {
+                return before + nodeCount(nodes[node].left);
+            }
+        }
+        return -1;
+    }
+    
+    /**
+     * @brief Iterator positioned at the k-th student in ascending ID order
+     * @param[in] k Zero-based position
+     * @return Iterator to the k-th student, or end() if k is out of range
+     * @note Time Complexity: O(log n). Paging reads a page as seek(page * pageSize)
+     *       followed by pageSize increments, without visiting earlier records
+     */
+    const_iterator seek(int k) const
+    {
+        const_iterator it(this);
+        if (k < 0 || k >= size()) return it;
+        
+        // 与中序迭代器的栈状态保持一致：只压入向左走过的祖先，目标节点位于栈顶
+        int node = root;
+        while (node != Nil)
+        {
+            int leftCount = nodeCount(nodes[node].left);
+            if (k < leftCount)
+            {
+                it.path.push(node);
+                node = nodes[node].left;
+            }
+            else if (k == leftCount)
+            {
+                it.path.push(node);
+                break;
+            }
+            else
+            {
+                k -= leftCount + 1;
+                node = nodes[node].right;
+            }
+        }
+        return it;
+    }
+    
+    /**
+     * @brief Get the height (maximum depth) of the tree
+     * @return Number of nodes on the longest root-to-leaf path, 0 for an empty tree
+     * @note Time Complexity: O(1). For an AVL tree this never exceeds ~1.44 * log2(n + 2)
+     */
+    int height() const
+    {
+        return nodeHeight(root);
+    }
+    
+    /**
+     * @brief Get the number of bytes each node occupies in the arena
+     * @return sizeof(Node): the student record plus two 32-bit links, the height and the subtree count
+     * @note Heap storage owned by the record itself (QString contents) is not included
+     */
+    static constexpr std::size_t bytesPerNode()
+    {
+        return NodeArena<Node>::bytesPerNode();
+    }
+    
+    /**
+     * @brief Get the number of bytes currently reserved by the node arena
+     * @return Total bytes of all allocated chunks and bookkeeping
+     */
+    std::size_t memoryUsage() const
+    {
+        return nodes.memoryUsage();
     }
     
 private:
+    // ==================== AVL 平衡辅助方法 ====================
+    
+    /**
+     * @brief Height of a possibly empty subtree
+     */
+    int nodeHeight(int node) const
+    {
+        return node == Nil ? 0 : nodes[node].height;
+    }
+    
+    /**
+     * @brief Number of nodes in a possibly empty subtree
+     */
+    int nodeCount(int node) const
+    {
+        return node == Nil ? 0 : nodes[node].count;
+    }
+    
+    /**
+     * @brief Recompute a node's height and subtree count from its children
+     */
+    void updateNode(int node)
+    {
+        nodes[node].height = 1 + std::max(nodeHeight(nodes[node].left), nodeHeight(nodes[node].right));
+        nodes[node].count = 1 + nodeCount(nodes[node].left) + nodeCount(nodes[node].right);
+    }
+    
+    /**
+     * @brief Balance factor: height(left) - height(right)
+     */
+    int balanceFactor(int node) const
+    {
+        return nodeHeight(nodes[node].left) - nodeHeight(nodes[node].right);
+    }
+    
+    /**
+     * @brief Right rotation around node; node is replaced by its left child
+     */
+    void rotateRight(int& node)
+    {
+        int pivot = nodes[node].left;
+        nodes[node].left = nodes[pivot].right;
+        updateNode(node);
+        nodes[pivot].right = node;
+        updateNode(pivot);
+        node = pivot;
+    }
+    
+    /**
+     * @brief Left rotation around node; node is replaced by its right child
+     */
+    void rotateLeft(int& node)
+    {
+        int pivot = nodes[node].right;
+        nodes[node].right = nodes[pivot].left;
+        updateNode(node);
+        nodes[pivot].left = node;
+        updateNode(pivot);
+        node = pivot;
+    }
+    
+    /**
+     * @brief Restore the AVL invariant at node after one of its subtrees changed height
+     * @param[in,out] node Subtree root, replaced by the new root if a rotation happens
+     */
+    void rebalance(int& node)
+    {
+        updateNode(node);
+        int balance = balanceFactor(node);
+        
+        // 左子树过高: LL 型单旋, LR 型先对左孩子左旋
+        if (balance > 1)
+        {
+            if (balanceFactor(nodes[node].left) < 0)
+            {
+                rotateLeft(nodes[node].left);
+            }
+            rotateRight(node);
+        }
+        // 右子树过高: RR 型单旋, RL 型先对右孩子右旋
+        else if (balance < -1)
+        {
+            if (balanceFactor(nodes[node].right) > 0)
+            {
+                rotateRight(nodes[node].right);
+            }
+            rotateLeft(node);
+        }
+    }
+    
+
     // ==================== 递归辅助方法 ====================
     
     /**
      * @brief Recursive helper for insertion
      * @param[in,out] node Current node in traversal
      * @param[in] data The student data to insert
+     * @param[out] newNode Index of the newly allocated node
      * @return true if inserted, false if ID already exists
      */
-    bool insertRecursive(std::shared_ptr<Node>& node, const T& data)
+    bool insertRecursive(int& node, const T& data, int& newNode)
     {
-        if (!node)
+        if (node == Nil)
         {
-            node = std::make_shared<Node>(data);
+            // 节点池的块不会移动，因此 node 引用在分配后仍然有效
+            node = nodes.allocate();
+            nodes[node].data = data;
+            newNode = node;
             return true;
         }
         
+        bool inserted;
         // 如果数据小于当前节点，向左子树插入
-        if (data < node->data)
+        if (data < nodes[node].data)
         {
-            return insertRecursive(node->left, data);
+            inserted = insertRecursive(nodes[node].left, data, newNode);
         }
         // 如果数据大于当前节点，向右子树插入
-        else if (node->data < data)
+        else if (nodes[node].data < data)
         {
-            return insertRecursive(node->right, data);
+            inserted = insertRecursive(nodes[node].right, data, newNode);
         }
         // 重复的ID - 插入失败
         else
         {
             return false;
         }
+        
+        // 回溯时修正高度并在失衡处旋转
+        if (inserted)
+        {
+            rebalance(node);
+        }
+        return inserted;
     }
     
     /**
@@ -281,191 +957,319 @@ private:
      * @param[in] studentID The ID of student to delete
      * @return true if deleted, false if not found
      */
-    bool deleteRecursive(std::shared_ptr<Node>& node, const QString& studentID)
+    bool deleteRecursive(int& node, const QString& studentID)
     {
-        if (!node) return false;
+        if (node == Nil) return false;
         
+        bool deleted;
         // 定位要删除的节点
-        if (studentID < node->data.studentID)
+        if (studentID < nodes[node].data.studentID)
         {
-            return deleteRecursive(node->left, studentID);
+            deleted = deleteRecursive(nodes[node].left, studentID);
         }
-        else if (studentID > node->data.studentID)
+        else if (studentID > nodes[node].data.studentID)
         {
-            return deleteRecursive(node->right, studentID);
+            deleted = deleteRecursive(nodes[node].right, studentID);
         }
         else
         {
             // 找到要删除的节点
             // 情况 1: 节点是叶子节点（没有子节点）
-            if (!node->left && !node->right)
+            if (nodes[node].left == Nil && nodes[node].right == Nil)
             {
-                node = nullptr;
+                nodes.release(node);
+                node = Nil;
                 return true;
             }
-            // 情况 2: 节点只有右子节点
-            else if (!node->left)
+            // 情况 2: 节点只有右子节点（AVL性质保证该子节点是叶子，无需再平衡）
+            else if (nodes[node].left == Nil)
             {
-                node = node->right;
+                int removed = node;
+                node = nodes[node].right;
+                nodes.release(removed);
                 return true;
             }
             // 情况 3: 节点只有左子节点
-            else if (!node->right)
+            else if (nodes[node].right == Nil)
             {
-                node = node->left;
+                int removed = node;
+                node = nodes[node].left;
+                nodes.release(removed);
                 return true;
             }
             // 情况 4: 节点有两个子节点
             else
             {
-                // 找到中序后继节点（右子树中最小的节点）
-                std::shared_ptr<Node> successorParent = node;
-                std::shared_ptr<Node> successor = node->right;
-                
-                while (successor->left)
-                {
-                    successorParent = successor;
-                    successor = successor->left;
-                }
-                
-                // 用后继节点的数据替换当前节点的数据
-                node->data = successor->data;
-                
-                // 删除后继节点
-                if (successorParent == node)
-                {
-                    // 后继节点是当前节点的右子节点
-                    node->right = successor->right;
-                }
-                else
-                {
-                    // 后继节点在当前节点右子节点的左子树中
-                    successorParent->left = successor->right;
-                }
+                // 从右子树中摘下中序后继节点（右子树中最小的节点），摘除路径上的节点会重新平衡；
+                // 然后让后继节点整体顶替当前节点，记录本身不发生复制，二级索引中的下标保持有效
+                int successor = detachMin(nodes[node].right);
+                nodes[successor].left = nodes[node].left;
+                nodes[successor].right = nodes[node].right;
                 
-                return true;
+                int removed = node;
+                node = successor;
+                nodes.release(removed);
+                deleted = true;
             }
         }
+        
+        // 回溯时修正高度并在失衡处旋转
+        if (deleted)
+        {
+            rebalance(node);
+        }
+        return deleted;
     }
     
     /**
-     * @brief Recursive helper for searching by ID
-     * @param[in] node Current node in traversal
-     * @param[in] studentID The ID to search for
-     * @param[out] result Will contain the student data if found
-     * @return true if found, false otherwise
+     * @brief Detach the minimum node of a subtree without releasing it
+     * @param[in,out] node Subtree root, updated as the subtree is rebalanced
+     * @return Index of the detached node
      */
-    bool searchRecursive(const std::shared_ptr<Node>& node, 
-                       const QString& studentID, T& result) const
+    int detachMin(int& node)
     {
-        if (!node) return false;
+        if (nodes[node].left == Nil)
+        {
+            int min = node;
+            node = nodes[node].right;
+            return min;
+        }
         
-        if (studentID < node->data.studentID)
+        int min = detachMin(nodes[node].left);
+        rebalance(node);
+        return min;
+    }
+    
+    /**
+     * @brief Iterative lookup of the node holding a student ID
+     * @return Node index, or Nil if not found
+     */
+    int findNode(const QString& studentID) const
+    {
+        int node = root;
+        while (node != Nil)
+        {
+            if (studentID < nodes[node].data.studentID)
+            {
+                node = nodes[node].left;
+            }
+            else if (studentID > nodes[node].data.studentID)
+            {
+                node = nodes[node].right;
+            }
+            else
+            {
+                return node;
+            }
+        }
+        return Nil;
+    }
+    
+    /**
+     * @brief Register a node in every enabled secondary index
+     */
+    void addToIndexes(int node)
+    {
+        if (indexFlags & NameIndex)
         {
-            return searchRecursive(node->left, studentID, result);
+            nameIndex[nodes[node].data.name].insert(node);
         }
-        else if (studentID > node->data.studentID)
+        if (indexFlags & CoordXIndex)
         {
-            return searchRecursive(node->right, studentID, result);
+            coordXIndex[nodes[node].data.addressCoordX].insert(node);
         }
-        else
+        if (indexFlags & BirthDateIndex)
         {
-            result = node->data;
-            return true;
+            birthDateIndex.insert(birthDateKey(nodes[node].data), node);
+        }
+        if (indexFlags & SpatialIndex)
+        {
+            spatialIndex->insert(nodes[node].data.addressCoordX, nodes[node].data.addressCoordY, node);
         }
     }
     
     /**
-     * @brief Recursive helper for searching by name
-     * @param[in] node Current node in traversal
-     * @param[in] name The name to search for
-     * @param[out] results Vector to accumulate results
+     * @brief Remove a node from every enabled secondary index, dropping empty buckets
      */
-    void searchByNameRecursive(const std::shared_ptr<Node>& node, 
-                              const QString& name, QVector<T>& results) const
+    void removeFromIndexes(int node)
     {
-        if (!node) return;
-        
-        // 检查当前节点
-        if (node->data.name == name)
+        if (indexFlags & NameIndex)
+        {
+            auto it = nameIndex.find(nodes[node].data.name);
+            if (it != nameIndex.end())
+            {
+                it.value().remove(node);
+                if (it.value().isEmpty()) nameIndex.erase(it);
+            }
+        }
+        if (indexFlags & CoordXIndex)
         {
-            results.push_back(node->data);
+            auto it = coordXIndex.find(nodes[node].data.addressCoordX);
+            if (it != coordXIndex.end())
+            {
+                it.value().remove(node);
+                if (it.value().isEmpty()) coordXIndex.erase(it);
+            }
         }
-
-        // 搜索左右两个子树（必须检查两个子树，因为树是按ID排序的，不是按姓名）
-        searchByNameRecursive(node->left, name, results);
-        searchByNameRecursive(node->right, name, results);
+        if (indexFlags & BirthDateIndex)
+        {
+            birthDateIndex.remove(birthDateKey(nodes[node].data));
+        }
+        if (indexFlags & SpatialIndex)
+        {
+            spatialIndex->remove(nodes[node].data.addressCoordX, nodes[node].data.addressCoordY, node);
+        }
+    }
+    
+    static BirthDateKey birthDateKey(const T& data)
+    {
+        return {data.birthDate.toJulianDay(), data.studentID};
     }
     
     /**
-     * @brief Recursive helper for searching by address X coordinate
-     * @param[in] node Current node in traversal
-     * @param[in] coordX The X coordinate to search for
-     * @param[out] results Vector to accumulate results
+     * @brief Birth-date order used by the youngest/oldest queries (same order as birthDateIndex)
+     */
+    static bool isYounger(const T& a, const T& b)
+    {
+        return birthDateKey(a) < birthDateKey(b);
+    }
+    
+    static qint64 distance2(const T& data, int x, int y)
+    {
+        const qint64 dx = qint64(data.addressCoordX) - x;
+        const qint64 dy = qint64(data.addressCoordY) - y;
+        return dx * dx + dy * dy;
+    }
+    
+    /**
+     * @brief Collect the students within radius2 of (x, y), sorted by distance then ID
+     * @param[in] limit Keep only the first limit results (-1 keeps all)
      */
-    void searchByAddressCoordXRecursive(const std::shared_ptr<Node>& node, 
-                                      int coordX, QVector<T>& results) const
+    QVector<T> collectByDistance(int x, int y, qint64 radius2, int limit) const
     {
-        if (!node) return;
+        QVector<T> results;
+        if (radius2 < 0) return results;
         
-        // 检查当前节点
-        if (node->data.addressCoordX == coordX)
+        std::vector<std::pair<qint64, int>> found;  // (距离平方, 节点下标)
+        if (indexFlags & SpatialIndex)
+        {
+            spatialIndex->visitRadius(x, y, radius2, [&](const SpatialGrid::Entry& entry, qint64 d2) {
+                found.emplace_back(d2, entry.item);
+            });
+        }
+        else
         {
-            results.push_back(node->data);
+            PathStack stack;
+            pushLeftSpine(stack, root);
+            while (!stack.isEmpty())
+            {
+                int node = stack.pop();
+                const qint64 d2 = distance2(nodes[node].data, x, y);
+                if (d2 <= radius2)
+                {
+                    found.emplace_back(d2, node);
+                }
+                pushLeftSpine(stack, nodes[node].right);
+            }
         }
         
-        // 搜索左右两个子树（必须检查两个子树，因为树是按ID排序的，不是按坐标）
-        searchByAddressCoordXRecursive(node->left, coordX, results);
-        searchByAddressCoordXRecursive(node->right, coordX, results);
+        std::sort(found.begin(), found.end(), [this](const std::pair<qint64, int>& a, const std::pair<qint64, int>& b) {
+            return a.first != b.first ? a.first < b.first
+                                      : nodes[a.second].data.studentID < nodes[b.second].data.studentID;
+        });
+        if (limit >= 0 && int(found.size()) > limit)
+        {
+            found.resize(std::size_t(limit));
+        }
+        results.reserve(int(found.size()));
+        for (const auto& item : found)
+        {
+            results.push_back(nodes[item.second].data);
+        }
+        return results;
     }
     
     /**
-     * @brief Recursive helper for pre-order traversal (root, left, right)
+     * @brief Select the first n records under a strict ordering with one traversal
+     * @param[in] n      Number of records to keep
+     * @param[in] before Strict weak ordering; before(a, b) means a ranks ahead of b
+     * @return Up to n records sorted by before
+     * @note Time Complexity: O(n log k), keeping a max-heap of k pointers instead of copying the tree
      */
-    void preorderTraversalRecursive(const std::shared_ptr<Node>& node, 
-                                   QVector<T>& result) const
+    template<typename Before>
+    QVector<T> selectTop(int n, Before before) const
     {
-        if (!node) return;
+        // 堆顶是当前入选记录中排名最靠后的一个
+        std::vector<const T*> heap;
+        heap.reserve(std::min(n, size()));
+        auto heapLess = [&](const T* a, const T* b) { return before(*a, *b); };
+        forEach([&](const T& data) {
+            if (int(heap.size()) < n)
+            {
+                heap.push_back(&data);
+                std::push_heap(heap.begin(), heap.end(), heapLess);
+            }
+            else if (before(data, *heap.front()))
+            {
+                std::pop_heap(heap.begin(), heap.end(), heapLess);
+                heap.back() = &data;
+                std::push_heap(heap.begin(), heap.end(), heapLess);
+            }
+        });
         
-        result.push_back(node->data);
-        preorderTraversalRecursive(node->left, result);
-        preorderTraversalRecursive(node->right, result);
+        std::sort_heap(heap.begin(), heap.end(), heapLess);
+        QVector<T> results;
+        results.reserve(int(heap.size()));
+        for (const T* data : heap)
+        {
+            results.push_back(*data);
+        }
+        return results;
     }
     
     /**
-     * @brief Recursive helper for in-order traversal (left, root, right)
-     *        Results will be sorted by student ID
+     * @brief Copy the records of an index bucket into results
      */
-    void inorderTraversalRecursive(const std::shared_ptr<Node>& node, 
-                                  QVector<T>& result) const
+    void collectIndexed(const QSet<int>& bucket, QVector<T>& results) const
     {
-        if (!node) return;
-        
-        inorderTraversalRecursive(node->left, result);
-        result.push_back(node->data);
-        inorderTraversalRecursive(node->right, result);
+        results.reserve(bucket.size());
+        for (int node : bucket)
+        {
+            results.push_back(nodes[node].data);
+        }
     }
     
     /**
-     * @brief Recursive helper for post-order traversal (left, right, root)
+     * @brief Push node and its chain of left children onto the stack
      */
-    void postorderTraversalRecursive(const std::shared_ptr<Node>& node, 
-                                    QVector<T>& result) const
+    void pushLeftSpine(PathStack& stack, int node) const
     {
-        if (!node) return;
-        
-        postorderTraversalRecursive(node->left, result);
-        postorderTraversalRecursive(node->right, result);
-        result.push_back(node->data);
+        while (node != Nil)
+        {
+            stack.push(node);
+            node = nodes[node].left;
+        }
     }
     
     /**
-     * @brief Recursive helper to count nodes
+     * @brief Iterative in-order walk shared by forEach and visitUntil
+     * @return true if visit returned true and stopped the walk early
      */
-    int sizeRecursive(const std::shared_ptr<Node>& node) const
+    template<typename Visit>
+    bool walkInorder(Visit visit) const
     {
-        if (!node) return 0;
-        return 1 + sizeRecursive(node->left) + sizeRecursive(node->right);
+        PathStack stack;
+        pushLeftSpine(stack, root);
+        while (!stack.isEmpty())
+        {
+            int node = stack.pop();
+            if (visit(nodes[node].data))
+            {
+                return true;
+            }
+            pushLeftSpine(stack, nodes[node].right);
+        }
+        return false;
     }
 };
 
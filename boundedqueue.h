@@ -0,0 +1,102 @@
+﻿/**
+ * @file       boundedqueue.h
+ * @brief      多线程流水线使用的有界阻塞队列
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，为导入流水线提供带背压的线程间队列]
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QWaitCondition>
+
+/**
+ * @class BoundedQueue
+ * @brief 容量有限的多生产者/多消费者阻塞队列
+ *
+ * 队列满时 push() 阻塞生产者（背压），队列空时 pop() 阻塞消费者。
+ * 生产者全部结束后调用 close()，消费者取完剩余元素后 pop() 返回false。
+ *
+ * @tparam T 元素类型，必须可移动
+ */
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(int capacity) : capacity(capacity), closed(false) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * @brief 放入一个元素，队列满时等待
+     * @param[in] item 要放入的元素
+     * @return 队列已关闭时返回false，元素被丢弃
+     */
+    bool push(T item)
+    {
+        QMutexLocker locker(&mutex);
+        while (items.size() >= capacity && !closed)
+        {
+            notFull.wait(&mutex);
+        }
+        if (closed)
+        {
+            return false;
+        }
+        items.enqueue(std::move(item));
+        notEmpty.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 取出一个元素，队列空时等待
+     * @param[out] item 取出的元素
+     * @return 队列已关闭且已取空时返回false
+     */
+    bool pop(T& item)
+    {
+        QMutexLocker locker(&mutex);
+        while (items.isEmpty() && !closed)
+        {
+            notEmpty.wait(&mutex);
+        }
+        if (items.isEmpty())
+        {
+            return false;
+        }
+        item = items.dequeue();
+        notFull.wakeOne();
+        return true;
+    }
+
+    /**
+     * @brief 关闭队列：不再接受新元素，唤醒所有等待的线程
+     */
+    void close()
+    {
+        QMutexLocker locker(&mutex);
+        closed = true;
+        notEmpty.wakeAll();
+        notFull.wakeAll();
+    }
+
+private:
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    QQueue<T> items;
+    const int capacity;
+    bool closed;
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,777 @@
+﻿/**
+ * @file       bplustree.h
+ * @brief      面向缓存的内存B+树，作为BinarySearchTree之外的另一种学生索引
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件并实现B+树的插入、删除、查询和范围扫描]
+ *             V1.1:[lzq] [2026-10-17] [更正节点大小和填充率说明，新增 isValid() 结构检查]
+ *
+ * @par        设计说明:
+ *             1. 宽节点: NodeBytes 只限定键数组的大小（节点按64字节对齐），不是整个节点的大小。
+ *                叶子中与键并列存放完整的 T 值，以 Student 为例每个值都有五个 QString 和一个 QDate，
+ *                一个叶子合计数KB；QString 键本身也只是指向堆内存的句柄，比较时仍要访问节点外的字符数据。
+ *                宽节点的收益在于树高约为 log_B(n)（千万级数据通常只有3~4层）、一次二分查找
+ *                只在一个键数组内进行；要让节点真正紧凑，应使用定长键和定长值（见 compactstudent.h）
+ *             2. 键值分离: 叶子节点中键和值分别存放在两个数组中，查找时只扫描键数组
+ *             3. 叶子链表: 所有叶子按键序双向链接，范围扫描沿链表前进，不需要递归也不需要
+ *                把结果复制到QVector
+ *             4. 节点存放在 NodeArena 分块节点池中，节点之间以32位下标链接
+ *             5. 追加优化: 在最右侧节点末尾插入（如递增学号）时，分裂让左节点保持满载，
+ *                顺序导入得到的节点接近100%填充，而不是对半分裂后的50%
+ *
+ * @par        填充策略:
+ *             追加分裂得到的新右节点只有一个键（内部节点为一个分隔键、两个孩子），低于
+ *             MinLeafCount / MinInnerCount。这类节点不会因插入而被补足，只有在删除使其计数继续下降时
+ *             才按常规规则向兄弟借键或合并。因此"非根节点至少半满"只对删除路径成立，
+ *             整棵树保证的是: 非根节点至少有一个键且不超过容量、所有叶子位于同一层、
+ *             叶子链表与键序一致，isValid() 检查的正是这些条件。
+ */
+
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include "student.h"
+#include "nodearena.h"
+#include <QVector>
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @struct StudentIDKey
+ * @brief  从Student中提取B+树排序键（学号）的默认键提取器
+ */
+struct StudentIDKey
+{
+    const QString& operator()(const Student& student) const
+    {
+        return student.studentID;
+    }
+};
+
+/**
+ * @class BPlusTree
+ * @brief 键唯一的内存B+树
+ *
+ * 提供与 BinarySearchTree 相同的 insert/deleteStudent/search/contains 接口，另外支持
+ * 按键序的迭代器和 [low, high] 区间扫描。所有数据只存放在叶子节点，内部节点只保存分隔键。
+ *
+ * @tparam Key       键类型（本应用中为QString学号）
+ * @tparam T         数据类型（本应用中为Student）
+ * @tparam KeyOf     从T中提取Key的函数对象
+ * @tparam NodeBytes 每个节点键数组的目标字节数，决定节点扇出
+ */
+template<typename Key, typename T, typename KeyOf = StudentIDKey, std::size_t NodeBytes = 512>
+class BPlusTree
+{
+public:
+    /// 叶子节点容量：键数组约占 NodeBytes 字节
+    static constexpr int LeafCapacity =
+        NodeBytes / sizeof(Key) < 8 ? 8 : static_cast<int>(NodeBytes / sizeof(Key));
+    /// 内部节点容量：键数组加孩子数组约占 NodeBytes 字节
+    static constexpr int InnerCapacity =
+        NodeBytes / (sizeof(Key) + sizeof(int)) < 8 ? 8 : static_cast<int>(NodeBytes / (sizeof(Key) + sizeof(int)));
+
+private:
+    static constexpr int MinLeafCount = LeafCapacity / 2;    ///< 非根叶子的最少键数
+    static constexpr int MinInnerCount = InnerCapacity / 2;  ///< 非根内部节点的最少键数
+
+    /**
+     * @struct LeafNode
+     * @brief 叶子节点，数组多留一个槽位用于分裂前的暂时溢出
+     */
+    struct alignas(64) LeafNode
+    {
+        int count;                       ///< 当前键数
+        int prev;                        ///< 前一个叶子（Nil 表示无）
+        int next;                        ///< 后一个叶子（Nil 表示无）
+        Key keys[LeafCapacity + 1];      ///< 有序键数组
+        T values[LeafCapacity + 1];      ///< 与键一一对应的数据
+
+        LeafNode() : count(0), prev(-1), next(-1) {}
+    };
+
+    /**
+     * @struct InnerNode
+     * @brief 内部节点，children[i] 子树中的键都小于 keys[i]，children[i+1] 中的键都不小于 keys[i]
+     */
+    struct alignas(64) InnerNode
+    {
+        int count;                           ///< 当前分隔键数，孩子数为 count + 1
+        int level;                           ///< 节点层级，1 表示孩子是叶子节点
+        Key keys[InnerCapacity + 1];         ///< 有序分隔键
+        int children[InnerCapacity + 2];     ///< 孩子下标
+
+        InnerNode() : count(0), level(1) {}
+    };
+
+    static constexpr int Nil = NodeArena<LeafNode>::Nil;  ///< 空链接
+
+    NodeArena<LeafNode, 8> leaves;    ///< 叶子节点池
+    NodeArena<InnerNode, 8> inners;   ///< 内部节点池
+    int root;                         ///< 根节点下标（rootLevel 为0时指向叶子）
+    int rootLevel;                    ///< 根节点层级，0 表示根是叶子
+    int firstLeaf;                    ///< 最左侧叶子，用于从头扫描
+    int count;                        ///< 记录总数
+
+public:
+    /**
+     * @class const_iterator
+     * @brief 沿叶子链表前进的只读前向迭代器，不分配内存
+     */
+    class const_iterator
+    {
+    public:
+        const_iterator() : tree(nullptr), leaf(Nil), pos(0) {}
+
+        const T& operator*() const { return tree->leaves[leaf].values[pos]; }
+        const T* operator->() const { return &tree->leaves[leaf].values[pos]; }
+
+        /**
+         * @brief 当前位置的键
+         */
+        const Key& key() const { return tree->leaves[leaf].keys[pos]; }
+
+        const_iterator& operator++()
+        {
+            if (++pos >= tree->leaves[leaf].count)
+            {
+                leaf = tree->leaves[leaf].next;
+                pos = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return leaf == other.leaf && pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class BPlusTree;
+        const_iterator(const BPlusTree* t, int l, int p) : tree(t), leaf(l), pos(p) {}
+
+        const BPlusTree* tree;
+        int leaf;
+        int pos;
+    };
+
+    /**
+     * @brief 构造函数 - 初始化一棵空树
+     */
+    BPlusTree() : root(Nil), rootLevel(0), firstLeaf(Nil), count(0) {}
+
+    /**
+     * @brief 插入一条记录
+     * @param[in] data 要插入的数据，键由 KeyOf 提取
+     * @return 插入成功返回true，键已存在返回false
+     * @note 时间复杂度: O(log n)
+     */
+    bool insert(const T& data)
+    {
+        const Key& key = KeyOf()(data);
+
+        if (root == Nil)
+        {
+            root = leaves.allocate();
+            rootLevel = 0;
+            firstLeaf = root;
+        }
+
+        Key separator;
+        int newSibling = Nil;
+        if (!insertRecursive(root, rootLevel, true, key, data, separator, newSibling))
+        {
+            return false;
+        }
+
+        // 根节点分裂，树长高一层
+        if (newSibling != Nil)
+        {
+            int newRoot = inners.allocate();
+            InnerNode& node = inners[newRoot];
+            node.level = rootLevel + 1;
+            node.count = 1;
+            node.keys[0] = separator;
+            node.children[0] = root;
+            node.children[1] = newSibling;
+            root = newRoot;
+            ++rootLevel;
+        }
+
+        ++count;
+        return true;
+    }
+
+    /**
+     * @brief 根据键删除记录
+     * @param[in] key 要删除记录的键
+     * @return 删除成功返回true，键不存在返回false
+     * @note 下溢的节点先向兄弟借键，借不到再与兄弟合并
+     * @note 时间复杂度: O(log n)
+     */
+    bool deleteStudent(const Key& key)
+    {
+        if (root == Nil || !removeRecursive(root, rootLevel, key))
+        {
+            return false;
+        }
+        --count;
+
+        // 根节点收缩
+        if (rootLevel > 0 && inners[root].count == 0)
+        {
+            int oldRoot = root;
+            root = inners[oldRoot].children[0];
+            --rootLevel;
+            inners.release(oldRoot);
+        }
+        else if (rootLevel == 0 && leaves[root].count == 0)
+        {
+            leaves.release(root);
+            root = Nil;
+            firstLeaf = Nil;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 根据键查找记录
+     * @param[in] key 要查找的键
+     * @param[out] result 如果找到，将包含记录数据
+     * @return 找到返回true，否则返回false
+     * @note 时间复杂度: O(log n)，每层只访问一个节点
+     */
+    bool search(const Key& key, T& result) const
+    {
+        const_iterator it = lowerBound(key);
+        if (it == end() || it.key() != key)
+        {
+            return false;
+        }
+        result = *it;
+        return true;
+    }
+
+    /**
+     * @brief 检查键是否存在
+     */
+    bool contains(const Key& key) const
+    {
+        const_iterator it = lowerBound(key);
+        return it != end() && it.key() == key;
+    }
+
+    /**
+     * @brief 第一个不小于 key 的位置
+     * @note 时间复杂度: O(log n)
+     */
+    const_iterator lowerBound(const Key& key) const
+    {
+        if (root == Nil)
+        {
+            return end();
+        }
+
+        int leaf = findLeaf(key);
+        const LeafNode& node = leaves[leaf];
+        int pos = static_cast<int>(std::lower_bound(node.keys, node.keys + node.count, key) - node.keys);
+        if (pos == node.count)
+        {
+            // 该叶子中所有键都小于 key，结果位于下一个叶子的开头
+            return const_iterator(this, node.next, 0);
+        }
+        return const_iterator(this, leaf, pos);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, firstLeaf, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, Nil, 0);
+    }
+
+    /**
+     * @brief 按键序访问 [low, high] 区间内的所有记录
+     * @param[in] low     区间下界（包含）
+     * @param[in] high    区间上界（包含）
+     * @param[in] visitor 对每条记录调用 visitor(const T&)
+     * @return 访问的记录数
+     * @note 时间复杂度: O(log n + k)，沿叶子链表顺序读取，不复制数据
+     */
+    template<typename Visitor>
+    int rangeScan(const Key& low, const Key& high, Visitor visitor) const
+    {
+        int visited = 0;
+        for (const_iterator it = lowerBound(low); it != end() && !(high < it.key()); ++it)
+        {
+            visitor(*it);
+            ++visited;
+        }
+        return visited;
+    }
+
+    /**
+     * @brief 按键序获取所有记录
+     * @return 按键升序排列的记录
+     * @note 与 BinarySearchTree::inorderTraversal 对应；只需顺序扫描时应优先使用迭代器或 rangeScan
+     */
+    QVector<T> inorderTraversal() const
+    {
+        QVector<T> result;
+        result.reserve(count);
+        for (const_iterator it = begin(); it != end(); ++it)
+        {
+            result.push_back(*it);
+        }
+        return result;
+    }
+
+    /**
+     * @brief 清空所有记录
+     */
+    void clear()
+    {
+        leaves.clear();
+        inners.clear();
+        root = Nil;
+        rootLevel = 0;
+        firstLeaf = Nil;
+        count = 0;
+    }
+
+    bool isEmpty() const
+    {
+        return count == 0;
+    }
+
+    /**
+     * @brief 记录总数
+     * @note 时间复杂度: O(1)
+     */
+    int size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief 树高（层数），空树为0
+     */
+    int height() const
+    {
+        return root == Nil ? 0 : rootLevel + 1;
+    }
+
+    /**
+     * @brief 检查树的结构不变式，供测试和调试使用
+     * @return 以下条件全部成立时返回true:
+     *         各节点的键严格递增且落在父节点分隔键划定的区间内；非根节点的键数在 [1, 容量] 之间；
+     *         内部节点的层级与所在深度一致（所有叶子位于同一层）；叶子链表的 prev/next 与中序一致；
+     *         叶子中的记录总数等于 size()
+     * @note 时间复杂度: O(n)
+     */
+    bool isValid() const
+    {
+        if (root == Nil)
+        {
+            return count == 0 && firstLeaf == Nil;
+        }
+
+        int nextLeaf = firstLeaf;
+        int prevLeaf = Nil;
+        int records = 0;
+        if (!isValidNode(root, rootLevel, nullptr, nullptr, nextLeaf, prevLeaf, records))
+        {
+            return false;
+        }
+        return nextLeaf == Nil && records == count;
+    }
+
+    /**
+     * @brief 节点池当前占用的总字节数
+     */
+    std::size_t memoryUsage() const
+    {
+        return leaves.memoryUsage() + inners.memoryUsage();
+    }
+
+private:
+    /**
+     * @brief 内部节点中键 key 所在的孩子序号
+     */
+    static int childIndex(const InnerNode& node, const Key& key)
+    {
+        return static_cast<int>(std::upper_bound(node.keys, node.keys + node.count, key) - node.keys);
+    }
+
+    /**
+     * @brief 从根向下定位键 key 所在的叶子
+     */
+    int findLeaf(const Key& key) const
+    {
+        int node = root;
+        for (int level = rootLevel; level > 0; --level)
+        {
+            const InnerNode& inner = inners[node];
+            node = inner.children[childIndex(inner, key)];
+        }
+        return node;
+    }
+
+    /**
+     * @brief isValid() 的递归部分
+     * @param[in]     low      子树中键的下界（包含），nullptr 表示无下界
+     * @param[in]     high     子树中键的上界（不包含），nullptr 表示无上界
+     * @param[in,out] nextLeaf 按中序应访问到的下一个叶子
+     * @param[in,out] prevLeaf 按中序上一个访问到的叶子
+     * @param[in,out] records  已访问叶子中的记录数
+     */
+    bool isValidNode(int node, int level, const Key* low, const Key* high,
+                     int& nextLeaf, int& prevLeaf, int& records) const
+    {
+        if (level == 0)
+        {
+            const LeafNode& leaf = leaves[node];
+            if (node != nextLeaf || leaf.prev != prevLeaf || leaf.count < 1 || leaf.count > LeafCapacity)
+            {
+                return false;
+            }
+            for (int i = 0; i < leaf.count; ++i)
+            {
+                if ((i > 0 && !(leaf.keys[i - 1] < leaf.keys[i]))
+                    || (low && leaf.keys[i] < *low) || (high && !(leaf.keys[i] < *high)))
+                {
+                    return false;
+                }
+            }
+            prevLeaf = node;
+            nextLeaf = leaf.next;
+            records += leaf.count;
+            return true;
+        }
+
+        const InnerNode& inner = inners[node];
+        if (inner.level != level || inner.count < 1 || inner.count > InnerCapacity)
+        {
+            return false;
+        }
+        for (int i = 0; i < inner.count; ++i)
+        {
+            if ((i > 0 && !(inner.keys[i - 1] < inner.keys[i]))
+                || (low && inner.keys[i] < *low) || (high && !(inner.keys[i] < *high)))
+            {
+                return false;
+            }
+        }
+        for (int i = 0; i <= inner.count; ++i)
+        {
+            const Key* childLow = i == 0 ? low : &inner.keys[i - 1];
+            const Key* childHigh = i == inner.count ? high : &inner.keys[i];
+            if (!isValidNode(inner.children[i], level - 1, childLow, childHigh, nextLeaf, prevLeaf, records))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 递归插入
+     * @param[in]  node       当前节点
+     * @param[in]  level      当前节点层级（0 为叶子）
+     * @param[in]  rightmost  当前节点是否为本层最右侧的节点
+     * @param[out] separator  当前节点分裂时，新右兄弟的分隔键
+     * @param[out] newSibling 当前节点分裂时，新右兄弟的下标；未分裂为 Nil
+     * @return 插入成功返回true，键已存在返回false
+     */
+    bool insertRecursive(int node, int level, bool rightmost, const Key& key, const T& data,
+                         Key& separator, int& newSibling)
+    {
+        if (level == 0)
+        {
+            LeafNode& leaf = leaves[node];
+            int pos = static_cast<int>(std::lower_bound(leaf.keys, leaf.keys + leaf.count, key) - leaf.keys);
+            if (pos < leaf.count && leaf.keys[pos] == key)
+            {
+                return false;
+            }
+
+            std::move_backward(leaf.keys + pos, leaf.keys + leaf.count, leaf.keys + leaf.count + 1);
+            std::move_backward(leaf.values + pos, leaf.values + leaf.count, leaf.values + leaf.count + 1);
+            leaf.keys[pos] = key;
+            leaf.values[pos] = data;
+            ++leaf.count;
+
+            if (leaf.count > LeafCapacity)
+            {
+                newSibling = splitLeaf(node, rightmost && pos == LeafCapacity);
+                separator = leaves[newSibling].keys[0];
+            }
+            return true;
+        }
+
+        int idx = childIndex(inners[node], key);
+        bool childRightmost = rightmost && idx == inners[node].count;
+        Key childSeparator;
+        int childSibling = Nil;
+        if (!insertRecursive(inners[node].children[idx], level - 1, childRightmost, key, data,
+                             childSeparator, childSibling))
+        {
+            return false;
+        }
+
+        if (childSibling != Nil)
+        {
+            InnerNode& inner = inners[node];
+            std::move_backward(inner.keys + idx, inner.keys + inner.count, inner.keys + inner.count + 1);
+            std::move_backward(inner.children + idx + 1, inner.children + inner.count + 1,
+                               inner.children + inner.count + 2);
+            inner.keys[idx] = childSeparator;
+            inner.children[idx + 1] = childSibling;
+            ++inner.count;
+
+            if (inner.count > InnerCapacity)
+            {
+                newSibling = splitInner(node, childRightmost, separator);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 将溢出的叶子分裂，并接入叶子链表
+     * @param[in] appending 是否为在整棵树末尾追加导致的分裂；是则左节点保持满载
+     * @return 新右兄弟的下标
+     */
+    int splitLeaf(int node, bool appending)
+    {
+        int sibling = leaves.allocate();
+        LeafNode& left = leaves[node];
+        LeafNode& right = leaves[sibling];
+
+        int keep = appending ? LeafCapacity : left.count / 2;
+        right.count = left.count - keep;
+        std::move(left.keys + keep, left.keys + left.count, right.keys);
+        std::move(left.values + keep, left.values + left.count, right.values);
+        clearSlots(left, keep, left.count);
+        left.count = keep;
+
+        right.next = left.next;
+        right.prev = node;
+        if (left.next != Nil)
+        {
+            leaves[left.next].prev = sibling;
+        }
+        left.next = sibling;
+        return sibling;
+    }
+
+    /**
+     * @brief 将溢出的内部节点分裂，中间键上移
+     * @param[in]  appending 是否为在整棵树末尾追加导致的分裂；是则左节点保持满载
+     * @param[out] separator 上移到父节点的分隔键
+     * @return 新右兄弟的下标
+     */
+    int splitInner(int node, bool appending, Key& separator)
+    {
+        int sibling = inners.allocate();
+        InnerNode& left = inners[node];
+        InnerNode& right = inners[sibling];
+
+        // 追加时右节点只取走最后一个分隔键和两个孩子，保证每个非根内部节点至少有一个分隔键
+        int mid = appending ? left.count - 2 : left.count / 2;
+        separator = left.keys[mid];
+        right.level = left.level;
+        right.count = left.count - mid - 1;
+        std::move(left.keys + mid + 1, left.keys + left.count, right.keys);
+        std::copy(left.children + mid + 1, left.children + left.count + 1, right.children);
+        for (int i = mid; i < left.count; ++i)
+        {
+            left.keys[i] = Key();
+        }
+        left.count = mid;
+        return sibling;
+    }
+
+    /**
+     * @brief 递归删除
+     * @return 删除成功返回true，键不存在返回false
+     * @note 返回后调用方负责检查 node 是否下溢
+     */
+    bool removeRecursive(int node, int level, const Key& key)
+    {
+        if (level == 0)
+        {
+            LeafNode& leaf = leaves[node];
+            int pos = static_cast<int>(std::lower_bound(leaf.keys, leaf.keys + leaf.count, key) - leaf.keys);
+            if (pos == leaf.count || leaf.keys[pos] != key)
+            {
+                return false;
+            }
+            std::move(leaf.keys + pos + 1, leaf.keys + leaf.count, leaf.keys + pos);
+            std::move(leaf.values + pos + 1, leaf.values + leaf.count, leaf.values + pos);
+            --leaf.count;
+            clearSlots(leaf, leaf.count, leaf.count + 1);
+            return true;
+        }
+
+        int idx = childIndex(inners[node], key);
+        if (!removeRecursive(inners[node].children[idx], level - 1, key))
+        {
+            return false;
+        }
+
+        if (level == 1)
+        {
+            if (leaves[inners[node].children[idx]].count < MinLeafCount)
+            {
+                fixLeafUnderflow(node, idx);
+            }
+        }
+        else if (inners[inners[node].children[idx]].count < MinInnerCount)
+        {
+            fixInnerUnderflow(node, idx);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 修复父节点 parent 的第 idx 个孩子（叶子）的下溢
+     */
+    void fixLeafUnderflow(int parent, int idx)
+    {
+        InnerNode& p = inners[parent];
+        LeafNode& child = leaves[p.children[idx]];
+
+        // 向左兄弟借最后一个键
+        if (idx > 0 && leaves[p.children[idx - 1]].count > MinLeafCount)
+        {
+            LeafNode& left = leaves[p.children[idx - 1]];
+            std::move_backward(child.keys, child.keys + child.count, child.keys + child.count + 1);
+            std::move_backward(child.values, child.values + child.count, child.values + child.count + 1);
+            child.keys[0] = std::move(left.keys[left.count - 1]);
+            child.values[0] = std::move(left.values[left.count - 1]);
+            ++child.count;
+            --left.count;
+            clearSlots(left, left.count, left.count + 1);
+            p.keys[idx - 1] = child.keys[0];
+            return;
+        }
+
+        // 向右兄弟借第一个键
+        if (idx < p.count && leaves[p.children[idx + 1]].count > MinLeafCount)
+        {
+            LeafNode& right = leaves[p.children[idx + 1]];
+            child.keys[child.count] = std::move(right.keys[0]);
+            child.values[child.count] = std::move(right.values[0]);
+            ++child.count;
+            std::move(right.keys + 1, right.keys + right.count, right.keys);
+            std::move(right.values + 1, right.values + right.count, right.values);
+            --right.count;
+            clearSlots(right, right.count, right.count + 1);
+            p.keys[idx] = right.keys[0];
+            return;
+        }
+
+        // 借不到则与兄弟合并，总是把右侧节点并入左侧节点
+        int leftIdx = idx > 0 ? idx - 1 : idx;
+        int leftNode = p.children[leftIdx];
+        int rightNode = p.children[leftIdx + 1];
+        LeafNode& left = leaves[leftNode];
+        LeafNode& right = leaves[rightNode];
+
+        std::move(right.keys, right.keys + right.count, left.keys + left.count);
+        std::move(right.values, right.values + right.count, left.values + left.count);
+        left.count += right.count;
+        left.next = right.next;
+        if (right.next != Nil)
+        {
+            leaves[right.next].prev = leftNode;
+        }
+        leaves.release(rightNode);
+        removeFromParent(p, leftIdx);
+    }
+
+    /**
+     * @brief 修复父节点 parent 的第 idx 个孩子（内部节点）的下溢
+     */
+    void fixInnerUnderflow(int parent, int idx)
+    {
+        InnerNode& p = inners[parent];
+        InnerNode& child = inners[p.children[idx]];
+
+        // 经由父节点从左兄弟旋转一个键过来
+        if (idx > 0 && inners[p.children[idx - 1]].count > MinInnerCount)
+        {
+            InnerNode& left = inners[p.children[idx - 1]];
+            std::move_backward(child.keys, child.keys + child.count, child.keys + child.count + 1);
+            std::copy_backward(child.children, child.children + child.count + 1,
+                               child.children + child.count + 2);
+            child.keys[0] = std::move(p.keys[idx - 1]);
+            child.children[0] = left.children[left.count];
+            ++child.count;
+            p.keys[idx - 1] = std::move(left.keys[left.count - 1]);
+            left.keys[left.count - 1] = Key();
+            --left.count;
+            return;
+        }
+
+        // 经由父节点从右兄弟旋转一个键过来
+        if (idx < p.count && inners[p.children[idx + 1]].count > MinInnerCount)
+        {
+            InnerNode& right = inners[p.children[idx + 1]];
+            child.keys[child.count] = std::move(p.keys[idx]);
+            child.children[child.count + 1] = right.children[0];
+            ++child.count;
+            p.keys[idx] = std::move(right.keys[0]);
+            std::move(right.keys + 1, right.keys + right.count, right.keys);
+            std::copy(right.children + 1, right.children + right.count + 1, right.children);
+            --right.count;
+            right.keys[right.count] = Key();
+            return;
+        }
+
+        // 与兄弟合并，父节点的分隔键下移到合并后的节点中
+        int leftIdx = idx > 0 ? idx - 1 : idx;
+        int rightNode = p.children[leftIdx + 1];
+        InnerNode& left = inners[p.children[leftIdx]];
+        InnerNode& right = inners[rightNode];
+
+        left.keys[left.count] = p.keys[leftIdx];
+        std::move(right.keys, right.keys + right.count, left.keys + left.count + 1);
+        std::copy(right.children, right.children + right.count + 1, left.children + left.count + 1);
+        left.count += right.count + 1;
+        inners.release(rightNode);
+        removeFromParent(p, leftIdx);
+    }
+
+    /**
+     * @brief 合并后从父节点中移除分隔键 keys[keyIdx] 和孩子 children[keyIdx + 1]
+     */
+    static void removeFromParent(InnerNode& p, int keyIdx)
+    {
+        std::move(p.keys + keyIdx + 1, p.keys + p.count, p.keys + keyIdx);
+        std::copy(p.children + keyIdx + 2, p.children + p.count + 1, p.children + keyIdx + 1);
+        --p.count;
+        p.keys[p.count] = Key();
+    }
+
+    /**
+     * @brief 重置叶子中 [from, to) 的空闲槽位，及时释放其持有的资源（如QString）
+     */
+    static void clearSlots(LeafNode& leaf, int from, int to)
+    {
+        for (int i = from; i < to; ++i)
+        {
+            leaf.keys[i] = Key();
+            leaf.values[i] = T();
+        }
+    }
+};
+
+#endif // BPLUSTREE_H
@@ -0,0 +1,19 @@
+QT += core sql concurrent
+QT -= gui
+TARGET = StudentCli
+TEMPLATE = app
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+include(../studentrepository.pri)
+
+# 峰值常驻内存（GetProcessMemoryInfo）
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    $$PWD/../climain.cpp \
+    $$PWD/../studentcli.cpp
+
+HEADERS += \
+    $$PWD/../studentcli.h \
+    $$PWD/../student.h
@@ -0,0 +1,69 @@
+/**
+ * @file       climain.cpp
+ * @brief      命令行批处理程序（StudentCli）的入口，不创建任何窗口
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0: [lzq] [2026-10-17] [创建文件]
+ */
+
+#include "studentcli.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+/**
+ * @brief 命令行批处理程序的主入口点
+ * @param argc 命令行参数计数
+ * @param argv 命令行参数数组
+ * @return 0 表示成功，1 表示执行失败，2 表示参数错误
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("StudentCli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless batch tool for the student database.\n\n"
+        "Commands:\n"
+        "  import <file>                  Import a text or .snap file\n"
+        "  export <file>                  Export to text, or to a snapshot if the name ends in .snap\n"
+        "  query id <studentID>...        Students by ID\n"
+        "  query name <name>              Students with the name, by ID\n"
+        "  query x <X>                    Students at coordinate X, by ID\n"
+        "  query box <X1> <Y1> <X2> <Y2>  Students in the box, by ID\n"
+        "  query radius <X> <Y> <R>       Students within R of (X, Y), nearest first\n"
+        "  query nearest <X> <Y> <K>      The K students nearest to (X, Y)\n"
+        "  stats                          Row counts, birth date range and database size\n\n"
+        "Query results are written to stdout in the import format; the report\n"
+        "(rows, rows/s, peak RSS) is written to stderr. Options go before the command.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "import, export, query or stats, followed by its arguments.");
+    QCommandLineOption dbOption("db", "Database file.", "file", "students.db");
+    QCommandLineOption jsonOption("json", "Print the report (and stats) as one line of JSON.");
+    QCommandLineOption limitOption("limit", "Maximum rows written by name/x/box/radius queries.", "rows", "0");
+    QCommandLineOption replaceOption("replace", "Delete all students before importing (uses the bulk load path).");
+    parser.addOptions({dbOption, jsonOption, limitOption, replaceOption});
+    // 命令之后的参数都是位置参数，负坐标不会被当作选项
+    parser.setOptionsAfterPositionalArgumentsMode(QCommandLineParser::ParseAsPositionalArguments);
+    parser.process(app);
+
+    CliOptions options;
+    options.databasePath = parser.value(dbOption);
+    options.arguments = parser.positionalArguments();
+    options.json = parser.isSet(jsonOption);
+    options.replace = parser.isSet(replaceOption);
+    bool ok = false;
+    options.limit = parser.value(limitOption).toInt(&ok);
+    if (!ok || options.limit < 0) {
+        QTextStream(stderr) << "Invalid row limit: " << parser.value(limitOption) << Qt::endl;
+        return 2;
+    }
+
+    return runCli(options);
+}
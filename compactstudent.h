@@ -0,0 +1,250 @@
+﻿/**
+ * @file       compactstudent.h
+ * @brief      内存存储使用的紧凑学生记录（32字节定长）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，定义紧凑记录及其与 Student 的相互转换]
+ *
+ * @par        设计说明:
+ *             Student 含五个 QString 和一个 QDate，64位平台上结构体本身56字节，每个非空
+ *             QString 另有一块带引用计数头的 UTF-16 堆内存，一条记录合计超过150字节，且分散在
+ *             多处堆内存中。CompactStudent 把一条记录压缩为32字节、无指针的定长结构:
+ *             - 学号: 纯数字学号（最多17位，可含前导零）编码为 (位数 << 57) | 数值，
+ *               其余学号放入字符串池，存 (1 << 63) | 池编号，两种编码都可无损还原；
+ *             - 出生日期: 儒略日（32位），无效日期为 InvalidDay；
+ *             - 性别: 1字节编号，对应池中最多256种不同的性别文本；
+ *             - 姓名、地址: 字符串池编号（32位）；坐标保持32位整数。
+ *             一个缓存行可容纳两条记录，顺序扫描时不需要追随任何指针。
+ *
+ *             编码后的学号按 (位数, 数值) 排序: 位数相同的纯数字学号与字符串顺序一致，
+ *             位数不同时短的在前；非数字学号排在所有数字学号之后。
+ *             作为内存存储时配合 BPlusTree 使用，见 CompactStudentTree。
+ */
+
+#ifndef COMPACTSTUDENT_H
+#define COMPACTSTUDENT_H
+
+#include "student.h"
+#include "stringpool.h"
+#include "bplustree.h"
+
+#include <QDate>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include <climits>
+
+/**
+ * @class StudentStringPool
+ * @brief 紧凑记录共用的字符串池：姓名、地址、非数字学号共用一个池，性别单独编号
+ */
+class StudentStringPool
+{
+public:
+    static constexpr int MaxGenders = 256;  ///< 性别编号为1字节
+
+    /**
+     * @brief 取得性别文本的编号
+     * @param[out] code 编号
+     * @return 性别种类已满 MaxGenders 且为新文本时返回false
+     */
+    bool internGender(const QString& gender, quint8& code)
+    {
+        quint32 id = genders.find(gender);
+        if (id == StringPool::NotFound)
+        {
+            if (genders.size() >= MaxGenders)
+            {
+                return false;
+            }
+            id = genders.intern(gender);
+        }
+        code = quint8(id);
+        return true;
+    }
+
+    QString gender(quint8 code) const
+    {
+        return genders.string(code);
+    }
+
+    StringPool text;      ///< 姓名、地址、非数字学号
+    StringPool genders;   ///< 性别（空字符串编号为0）
+
+    qint64 memoryUsage() const
+    {
+        return text.memoryUsage() + genders.memoryUsage();
+    }
+
+    void clear()
+    {
+        text.clear();
+        genders.clear();
+    }
+};
+
+/**
+ * @struct CompactStudent
+ * @brief  32字节的定长学生记录，字符串字段保存在 StudentStringPool 中
+ */
+struct CompactStudent
+{
+    static constexpr qint32 InvalidDay = INT_MIN;        ///< 无效出生日期
+    static constexpr quint64 PooledIDFlag = 1ULL << 63;  ///< 学号存放在字符串池中
+    static constexpr int DigitShift = 57;                ///< 数字学号的位数所在的位
+    static constexpr int MaxDigits = 17;                 ///< 10^17 < 2^57
+
+    quint64 id;          ///< 编码后的学号，见 encodeID()
+    quint32 name;        ///< 姓名在字符串池中的编号
+    quint32 address;     ///< 地址名在字符串池中的编号
+    qint32 birthDay;     ///< 出生日期的儒略日
+    qint32 coordX;       ///< 地址横坐标
+    qint32 coordY;       ///< 地址纵坐标
+    quint8 gender;       ///< 性别编号
+
+    CompactStudent()
+        : id(0), name(0), address(0), birthDay(InvalidDay), coordX(0), coordY(0), gender(0)
+    {
+    }
+
+    /**
+     * @brief 数字学号的编码，不是不超过 MaxDigits 位的纯数字时返回false
+     */
+    static bool encodeNumericID(const QString& studentID, quint64& key)
+    {
+        const int digits = studentID.size();
+        if (digits == 0 || digits > MaxDigits)
+        {
+            return false;
+        }
+        quint64 value = 0;
+        for (QChar ch : studentID)
+        {
+            const ushort unicode = ch.unicode();
+            if (unicode < '0' || unicode > '9')
+            {
+                return false;
+            }
+            value = value * 10 + (unicode - '0');
+        }
+        key = (quint64(digits) << DigitShift) | value;
+        return true;
+    }
+
+    /**
+     * @brief 学号的编码，非数字学号加入字符串池
+     */
+    static quint64 encodeID(const QString& studentID, StudentStringPool& pool)
+    {
+        quint64 key;
+        if (encodeNumericID(studentID, key))
+        {
+            return key;
+        }
+        return PooledIDFlag | pool.text.intern(studentID);
+    }
+
+    /**
+     * @brief 查找用的学号编码，不修改字符串池
+     * @return 非数字学号不在池中（即不可能存在该记录）时返回false
+     */
+    static bool findID(const QString& studentID, const StudentStringPool& pool, quint64& key)
+    {
+        if (encodeNumericID(studentID, key))
+        {
+            return true;
+        }
+        const quint32 pooled = pool.text.find(studentID);
+        key = PooledIDFlag | pooled;
+        return pooled != StringPool::NotFound;
+    }
+
+    static QString decodeID(quint64 key, const StudentStringPool& pool)
+    {
+        if (key & PooledIDFlag)
+        {
+            return pool.text.string(quint32(key & ~PooledIDFlag));
+        }
+        const int digits = int(key >> DigitShift);
+        quint64 value = key & ((1ULL << DigitShift) - 1);
+        QString text(digits, QChar('0'));
+        for (int i = digits - 1; i >= 0 && value != 0; --i)
+        {
+            text[i] = QChar(ushort('0' + value % 10));
+            value /= 10;
+        }
+        return text;
+    }
+
+    /**
+     * @brief 由 Student 构造紧凑记录，字符串字段加入池中
+     * @return 性别种类超过 StudentStringPool::MaxGenders 时返回false
+     */
+    static bool fromStudent(const Student& student, StudentStringPool& pool, CompactStudent& record)
+    {
+        quint8 genderCode;
+        if (!pool.internGender(student.gender, genderCode))
+        {
+            return false;
+        }
+        record.id = encodeID(student.studentID, pool);
+        record.name = pool.text.intern(student.name);
+        record.address = pool.text.intern(student.addressName);
+        record.birthDay = student.birthDate.isValid() ? qint32(student.birthDate.toJulianDay()) : InvalidDay;
+        record.coordX = student.addressCoordX;
+        record.coordY = student.addressCoordY;
+        record.gender = genderCode;
+        return true;
+    }
+
+    /**
+     * @brief 还原为 Student
+     */
+    Student toStudent(const StudentStringPool& pool) const
+    {
+        return Student(decodeID(id, pool),
+                       pool.text.string(name),
+                       birthDay == InvalidDay ? QDate() : QDate::fromJulianDay(birthDay),
+                       pool.gender(gender),
+                       pool.text.string(address),
+                       coordX,
+                       coordY);
+    }
+
+    bool operator<(const CompactStudent& other) const
+    {
+        return id < other.id;
+    }
+
+    bool operator==(const CompactStudent& other) const
+    {
+        return id == other.id;
+    }
+};
+
+static_assert(sizeof(CompactStudent) == 32, "CompactStudent should stay 32 bytes");
+
+/**
+ * @struct CompactStudentKey
+ * @brief  BPlusTree 的键提取器：编码后的学号
+ */
+struct CompactStudentKey
+{
+    const quint64& operator()(const CompactStudent& student) const
+    {
+        return student.id;
+    }
+};
+
+/**
+ * @brief 以紧凑记录为数据的B+树，键为编码后的学号（8字节定长整数）
+ */
+typedef BPlusTree<quint64, CompactStudent, CompactStudentKey> CompactStudentTree;
+
+#endif // COMPACTSTUDENT_H
@@ -0,0 +1,145 @@
+﻿/**
+ * @file       connectionmanager.cpp
+ * @brief      SQLite 连接管理的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [增加 statement() 预编译语句缓存]
+ */
+
+#include "connectionmanager.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QSqlQuery>
+
+QAtomicInt ConnectionManager::pooledCount(0);
+
+ConnectionManager::ConnectionManager()
+    : name("students.db"), currentProfile(ConnectionProfile::performance()), nextSerial(0)
+{
+}
+
+ConnectionManager& ConnectionManager::instance()
+{
+    static ConnectionManager manager;
+    return manager;
+}
+
+void ConnectionManager::setDatabaseName(const QString& databaseName)
+{
+    QMutexLocker locker(&mutex);
+    name = databaseName;
+}
+
+void ConnectionManager::setProfile(const ConnectionProfile& profile)
+{
+    QMutexLocker locker(&mutex);
+    currentProfile = profile;
+}
+
+QString ConnectionManager::databaseName() const
+{
+    QMutexLocker locker(&mutex);
+    return name;
+}
+
+ConnectionProfile ConnectionManager::profile() const
+{
+    QMutexLocker locker(&mutex);
+    return currentProfile;
+}
+
+QSqlDatabase ConnectionManager::connection()
+{
+    // 本线程已有连接时直接复用
+    if (threadConnections.hasLocalData()) {
+        {
+            QSqlDatabase database = QSqlDatabase::database(threadConnections.localData()->name, false);
+            if (database.isOpen()) {
+                return database;
+            }
+        }
+        threadConnections.setLocalData(nullptr); // 删除旧句柄并移除失效的连接
+    }
+
+    const QString connectionName = QString("students_connection_%1").arg(nextSerial.fetchAndAddRelaxed(1));
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    database.setDatabaseName(databaseName());
+
+    // 打开失败的连接也登记到本线程，下次调用时由上面的分支移除并重试
+    ThreadConnection* handle = new ThreadConnection;
+    handle->name = connectionName;
+    threadConnections.setLocalData(handle);
+    pooledCount.ref();
+
+    if (!database.open()) {
+        qWarning() << "Failed to open database connection:" << database.lastError().text();
+        return database;
+    }
+    if (!applyProfile(database, profile())) {
+        qWarning() << "Failed to apply connection profile to" << connectionName;
+    }
+    return database;
+}
+
+QSqlQuery& ConnectionManager::statement(const QString& sql)
+{
+    QSqlDatabase database = connection();
+    ThreadConnection* handle = threadConnections.localData();
+
+    CachedStatement*& cached = handle->statements[sql];
+    if (!cached) {
+        cached = new CachedStatement{QSqlQuery(database), false};
+    }
+    // prepare 失败（例如数据库当时未打开）时下次请求再试
+    if (!cached->prepared) {
+        cached->prepared = cached->query.prepare(sql);
+        if (!cached->prepared) {
+            qWarning() << "Failed to prepare statement:" << cached->query.lastError().text() << sql;
+        }
+    }
+    return cached->query;
+}
+
+bool ConnectionManager::applyProfile(QSqlDatabase& database, const ConnectionProfile& profile)
+{
+    QSqlQuery query(database);
+    bool success = true;
+
+    // busy_timeout 放在最前面，后面切换 journal_mode 时如果其他连接正在写入也会等待
+    success &= query.exec(QString("PRAGMA busy_timeout = %1").arg(profile.busyTimeoutMs));
+    success &= query.exec(QString("PRAGMA journal_mode = %1").arg(profile.journalMode));
+    success &= query.exec(QString("PRAGMA synchronous = %1").arg(profile.synchronous));
+    success &= query.exec(QString("PRAGMA mmap_size = %1").arg(profile.mmapSize));
+    success &= query.exec(QString("PRAGMA cache_size = %1").arg(-qint64(profile.cacheSizeKiB)));
+    success &= query.exec(QString("PRAGMA temp_store = %1").arg(profile.tempStore));
+    if (!success) {
+        qWarning() << "PRAGMA failed:" << query.lastError().text();
+    }
+    return success;
+}
+
+int ConnectionManager::pooledConnectionCount() const
+{
+    return pooledCount.loadRelaxed();
+}
+
+ConnectionManager::ThreadConnection::~ThreadConnection()
+{
+    // 语句必须先于连接释放
+    qDeleteAll(statements);
+    statements.clear();
+    {
+        QSqlDatabase database = QSqlDatabase::database(name, false);
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+    pooledCount.deref();
+}
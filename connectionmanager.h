@@ -0,0 +1,151 @@
+﻿/**
+ * @file       connectionmanager.h
+ * @brief      SQLite 连接管理：性能参数配置与按线程复用的连接池
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，统一管理各线程的数据库连接和PRAGMA配置]
+ *             V1.1:[lzq] [2026-10-17] [每个连接增加预编译语句缓存]
+ *
+ * @par        设计说明:
+ *             Qt 的 QSqlDatabase 连接只能在创建它的线程中使用，因此连接池按线程划分：
+ *             每个线程第一次调用 connection() 时打开一个连接并应用性能配置，之后一直复用，
+ *             直到该线程结束时自动关闭。QtConcurrent 的线程池会复用线程，后台任务因此
+ *             不再为每次导入/导出重新打开数据库、重新预热页缓存。
+ *             默认配置使用 WAL 日志，后台线程的读取可以与写入同时进行。
+ *
+ *             每个连接附带一个以SQL文本为键的预编译语句缓存: 同一形状的查询只 prepare 一次，
+ *             之后只重新绑定参数并执行，省去SQLite的解析和查询规划。为此所有会变化的值
+ *             （过滤条件、游标、LIMIT/OFFSET）都必须以 ? 参数绑定，不能拼接进SQL文本，
+ *             缓存的条目数因此只取决于代码中查询形状的数量，不需要淘汰。
+ */
+
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QThreadStorage>
+
+/**
+ * @struct ConnectionProfile
+ * @brief 每个连接打开后执行的 PRAGMA 配置
+ */
+struct ConnectionProfile
+{
+    QString journalMode = "WAL";            ///< journal_mode（WAL 允许读写并发）
+    QString synchronous = "NORMAL";         ///< synchronous（WAL 下 NORMAL 不会损坏数据库）
+    qint64 mmapSize = 256LL * 1024 * 1024;  ///< mmap_size，字节，0 表示不使用内存映射
+    int cacheSizeKiB = 64 * 1024;           ///< 每个连接的页缓存大小，KiB
+    QString tempStore = "MEMORY";           ///< temp_store（排序、临时索引放在内存中）
+    int busyTimeoutMs = 5000;               ///< busy_timeout，写锁冲突时的等待时间
+
+    /**
+     * @brief 面向大数据量的默认配置
+     */
+    static ConnectionProfile performance()
+    {
+        return ConnectionProfile();
+    }
+
+    /**
+     * @brief SQLite 的默认配置（回滚日志、FULL同步、2MB页缓存、不使用mmap）
+     */
+    static ConnectionProfile sqliteDefaults()
+    {
+        ConnectionProfile profile;
+        profile.journalMode = "DELETE";
+        profile.synchronous = "FULL";
+        profile.mmapSize = 0;
+        profile.cacheSizeKiB = 2000;
+        profile.tempStore = "DEFAULT";
+        profile.busyTimeoutMs = 0;
+        return profile;
+    }
+};
+
+/**
+ * @class ConnectionManager
+ * @brief 进程内唯一的连接管理器
+ */
+class ConnectionManager
+{
+public:
+    static ConnectionManager& instance();
+
+    /**
+     * @brief 设置数据库文件和配置，应在第一次调用 connection() 之前设置
+     */
+    void setDatabaseName(const QString& name);
+    void setProfile(const ConnectionProfile& profile);
+
+    QString databaseName() const;
+    ConnectionProfile profile() const;
+
+    /**
+     * @brief 获取当前线程的数据库连接
+     * @return 已打开并应用了配置的连接；打开失败时返回的连接 isOpen() 为false，
+     *         可通过 lastError() 获取原因，下次调用会重试
+     */
+    QSqlDatabase connection();
+
+    /**
+     * @brief 获取当前线程连接上缓存的预编译语句
+     * @param[in] sql SQL文本，可变的值一律用 ? 占位
+     * @return 已 prepare 的语句。第一次请求时 prepare，之后直接返回同一对象；
+     *         prepare 失败时返回的语句 lastError() 有效，下次请求会重新 prepare
+     * @note 用 bindValue(序号, 值) 绑定参数后 exec()；读完结果后调用 finish()，
+     *       以便及时结束读事务（WAL 下未结束的读事务会阻止检查点）
+     */
+    QSqlQuery& statement(const QString& sql);
+
+    /**
+     * @brief 对一个已打开的连接应用配置
+     * @return 全部 PRAGMA 执行成功返回true
+     */
+    static bool applyProfile(QSqlDatabase& database, const ConnectionProfile& profile);
+
+    /**
+     * @brief 连接池中的连接数（所有线程）
+     */
+    int pooledConnectionCount() const;
+
+private:
+    ConnectionManager();
+
+    ConnectionManager(const ConnectionManager&) = delete;
+    ConnectionManager& operator=(const ConnectionManager&) = delete;
+
+    /**
+     * @brief 线程局部的连接句柄，线程结束时由 QThreadStorage 析构并移除连接
+     */
+    struct CachedStatement
+    {
+        QSqlQuery query;
+        bool prepared;
+    };
+
+    struct ThreadConnection
+    {
+        QString name;
+        QHash<QString, CachedStatement*> statements;  ///< SQL文本 -> 已prepare的语句
+        ~ThreadConnection();
+    };
+
+    QThreadStorage<ThreadConnection*> threadConnections;
+    mutable QMutex mutex;                   ///< 保护 name 和 currentProfile
+    QString name;
+    ConnectionProfile currentProfile;
+    QAtomicInt nextSerial;                  ///< 用于生成唯一的连接名
+    static QAtomicInt pooledCount;          ///< 所有线程的连接总数
+};
+
+#endif // CONNECTIONMANAGER_H
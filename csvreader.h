@@ -0,0 +1,223 @@
+﻿/**
+ * @file       csvreader.h
+ * @brief      基于内存映射的零拷贝CSV读取工具
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，提供文件映射和基于字节区间的字段解析]
+ *
+ * @par        设计说明:
+ *             整个文件通过 QFile::map 映射到内存，直接在UTF-8字节上查找逗号和换行，
+ *             整数和日期从字节区间中直接解析，不经过 QString / QStringList。
+ *             只有最终要存储的文本字段才转换为 QString，每行的堆分配从十几次降到四次。
+ */
+
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QByteArray>
+#include <QDate>
+#include <QFile>
+#include <QString>
+
+#include <climits>
+
+/**
+ * @struct ByteSpan
+ * @brief 指向映射区域（或缓冲区）中一段字节的只读视图，不持有内存
+ */
+struct ByteSpan
+{
+    const char* data = nullptr;
+    int size = 0;
+
+    ByteSpan() = default;
+    ByteSpan(const char* begin, const char* end) : data(begin), size(int(end - begin)) {}
+
+    bool isEmpty() const { return size == 0; }
+    const char* begin() const { return data; }
+    const char* end() const { return data + size; }
+
+    /**
+     * @brief 去掉首尾的ASCII空白字符（与 QString::trimmed 对ASCII输入的结果一致）
+     */
+    ByteSpan trimmed() const
+    {
+        const char* b = begin();
+        const char* e = end();
+        while (b < e && isSpace(*b)) ++b;
+        while (e > b && isSpace(e[-1])) --e;
+        return ByteSpan(b, e);
+    }
+
+    /**
+     * @brief 转换为 QString（UTF-8解码），只对需要存储的字段调用
+     */
+    QString toString() const
+    {
+        return QString::fromUtf8(data, size);
+    }
+
+    /**
+     * @brief 解析十进制整数
+     * @return 解析结果；格式错误或溢出时返回0（与 QString::toInt 一致）
+     */
+    int toInt() const
+    {
+        const char* p = begin();
+        const char* e = end();
+        bool negative = false;
+        if (p < e && (*p == '-' || *p == '+'))
+        {
+            negative = (*p == '-');
+            ++p;
+        }
+        if (p == e)
+        {
+            return 0;
+        }
+
+        long long value = 0;
+        for (; p < e; ++p)
+        {
+            unsigned digit = unsigned(*p - '0');
+            if (digit > 9)
+            {
+                return 0;
+            }
+            value = value * 10 + digit;
+            if (value > static_cast<long long>(INT_MAX) + 1)
+            {
+                return 0;
+            }
+        }
+        if (negative)
+        {
+            value = -value;
+        }
+        return (value < INT_MIN || value > INT_MAX) ? 0 : int(value);
+    }
+
+    /**
+     * @brief 按 "yyyy-MM-dd" 解析日期
+     * @return 格式不符或日期不存在时返回无效的 QDate
+     */
+    QDate toDate() const
+    {
+        if (size != 10 || data[4] != '-' || data[7] != '-')
+        {
+            return QDate();
+        }
+        int year = 0, month = 0, day = 0;
+        if (!digits(data, 4, year) || !digits(data + 5, 2, month) || !digits(data + 8, 2, day))
+        {
+            return QDate();
+        }
+        return QDate(year, month, day);
+    }
+
+private:
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    static bool digits(const char* p, int count, int& value)
+    {
+        value = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            unsigned digit = unsigned(p[i] - '0');
+            if (digit > 9)
+            {
+                return false;
+            }
+            value = value * 10 + int(digit);
+        }
+        return true;
+    }
+};
+
+/**
+ * @class MappedFile
+ * @brief 以只读方式映射整个文件；无法映射时（如管道、特殊文件系统）退回一次性读入
+ */
+class MappedFile
+{
+public:
+    MappedFile() : mapped(nullptr), length(0), skipped(0) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief 打开并映射文件
+     * @param[in] filePath 文件路径
+     * @return 成功返回true；失败时可通过 errorString() 获取原因
+     */
+    bool open(const QString& filePath)
+    {
+        close();
+        file.setFileName(filePath);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            return false;
+        }
+
+        length = file.size();
+        if (length > 0)
+        {
+            mapped = file.map(0, length);
+            if (!mapped)
+            {
+                fallback = file.readAll();
+                length = fallback.size();
+            }
+        }
+
+        // 跳过UTF-8 BOM
+        const char* bytes = data();
+        if (length >= 3 && bytes[0] == '\xEF' && bytes[1] == '\xBB' && bytes[2] == '\xBF')
+        {
+            skipped = 3;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        if (mapped)
+        {
+            file.unmap(mapped);
+            mapped = nullptr;
+        }
+        fallback.clear();
+        length = 0;
+        skipped = 0;
+        file.close();
+    }
+
+    const char* begin() const { return data() + skipped; }
+    const char* end() const { return data() + length; }
+    QString errorString() const { return file.errorString(); }
+    bool isMapped() const { return mapped != nullptr; }
+
+private:
+    const char* data() const
+    {
+        return mapped ? reinterpret_cast<const char*>(mapped) : fallback.constData();
+    }
+
+    QFile file;
+    uchar* mapped;         ///< 映射地址，未映射时为nullptr
+    QByteArray fallback;   ///< 无法映射时读入的文件内容
+    qint64 length;         ///< 文件字节数
+    qint64 skipped;        ///< 跳过的BOM字节数
+};
+
+#endif // CSVREADER_H
@@ -0,0 +1,184 @@
+﻿/**
+ * @file       delimiterscanner.cpp
+ * @brief      向量化分隔符扫描的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，实现标量、SSE2和AVX2三种扫描]
+ */
+
+#include "delimiterscanner.h"
+
+#include <QtAlgorithms>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define DELIMITERSCANNER_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#endif
+
+#if defined(DELIMITERSCANNER_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define DELIMITERSCANNER_SSE2
+#endif
+
+// AVX2 函数单独标记目标指令集，其余代码仍按基线指令集编译，不支持的CPU上不会被调用
+#if defined(DELIMITERSCANNER_X86) && (defined(__GNUC__) || defined(__clang__))
+#  define DELIMITERSCANNER_AVX2
+#  define DELIMITERSCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(DELIMITERSCANNER_X86) && defined(_MSC_VER)
+#  define DELIMITERSCANNER_AVX2
+#  define DELIMITERSCANNER_TARGET_AVX2
+#endif
+
+namespace
+{
+    /**
+     * @brief 把位掩码中每个置位对应的偏移写入 out
+     */
+    inline quint32* emitMask(quint32 mask, quint32 base, quint32* out)
+    {
+        while (mask) {
+            *out++ = base + qCountTrailingZeroBits(mask);
+            mask &= mask - 1;
+        }
+        return out;
+    }
+
+    quint32* scanScalar(const char* begin, const char* p, const char* end, quint32* out)
+    {
+        for (; p < end; ++p) {
+            if (*p == ',' || *p == '\n') {
+                *out++ = quint32(p - begin);
+            }
+        }
+        return out;
+    }
+
+#ifdef DELIMITERSCANNER_SSE2
+    quint32* scanSse2(const char* begin, const char* end, quint32* out)
+    {
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const char* p = begin;
+        for (; end - p >= 16; p += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+            out = emitMask(quint32(_mm_movemask_epi8(hits)), quint32(p - begin), out);
+        }
+        return scanScalar(begin, p, end, out);
+    }
+#endif
+
+#ifdef DELIMITERSCANNER_AVX2
+    DELIMITERSCANNER_TARGET_AVX2
+    quint32* scanAvx2(const char* begin, const char* end, quint32* out)
+    {
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        const char* p = begin;
+        for (; end - p >= 32; p += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, comma), _mm256_cmpeq_epi8(bytes, newline));
+            out = emitMask(quint32(_mm256_movemask_epi8(hits)), quint32(p - begin), out);
+        }
+        return scanScalar(begin, p, end, out);
+    }
+
+    bool cpuHasAvx2()
+    {
+#  if defined(_MSC_VER) && !defined(__clang__)
+        // 需要CPU支持AVX2，并且操作系统保存YMM寄存器（OSXSAVE + XCR0）
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#  else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#  endif
+    }
+#endif
+}
+
+DelimiterScanner::Kernel DelimiterScanner::bestKernel()
+{
+    static const Kernel best = isSupported(AVX2) ? AVX2 : (isSupported(SSE2) ? SSE2 : Scalar);
+    return best;
+}
+
+bool DelimiterScanner::isSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case Scalar:
+        return true;
+    case SSE2:
+#ifdef DELIMITERSCANNER_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case AVX2:
+#ifdef DELIMITERSCANNER_AVX2
+    {
+        static const bool available = cpuHasAvx2();
+        return available;
+    }
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char* DelimiterScanner::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Scalar: return "scalar";
+    case SSE2:   return "sse2";
+    case AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+int DelimiterScanner::scan(Kernel kernel, const char* begin, const char* end, std::vector<quint32>& offsets)
+{
+    // 按最坏情况（每个字节都是分隔符）准备空间，扫描时直接写指针；
+    // 缓冲区只增不减，重复使用时不会再做清零
+    if (offsets.size() < size_t(end - begin)) {
+        offsets.resize(size_t(end - begin));
+    }
+    quint32* out = offsets.data();
+
+    switch (kernel) {
+#ifdef DELIMITERSCANNER_AVX2
+    case AVX2:
+        out = scanAvx2(begin, end, out);
+        break;
+#endif
+#ifdef DELIMITERSCANNER_SSE2
+    case SSE2:
+        out = scanSse2(begin, end, out);
+        break;
+#endif
+    default:
+        out = scanScalar(begin, begin, end, out);
+        break;
+    }
+
+    return int(out - offsets.data());
+}
@@ -0,0 +1,73 @@
+﻿/**
+ * @file       delimiterscanner.h
+ * @brief      导入文件的向量化分隔符扫描（SSE2/AVX2，运行时选择，带标量回退）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，按16/32字节一组查找逗号和换行]
+ *
+ * @par        设计说明:
+ *             解析前先对整个数据块做一次扫描，得到所有逗号和换行符的偏移（结构索引），
+ *             之后按索引切分字段，不再逐字节比较。SIMD 版本一次比较16或32个字节，
+ *             用 movemask 得到位掩码后逐位取出偏移。AVX2 是否可用在运行时检测，
+ *             非x86平台或不支持时使用标量实现，结果完全相同。
+ */
+
+#ifndef DELIMITERSCANNER_H
+#define DELIMITERSCANNER_H
+
+#include <QtGlobal>
+
+#include <vector>
+
+/**
+ * @class DelimiterScanner
+ * @brief 查找数据块中全部逗号和换行符的位置
+ */
+class DelimiterScanner
+{
+public:
+    /**
+     * @brief 扫描实现
+     */
+    enum Kernel
+    {
+        Scalar,     ///< 逐字节比较
+        SSE2,       ///< 每次16字节
+        AVX2        ///< 每次32字节
+    };
+
+    /**
+     * @brief 当前CPU上最快的可用实现（首次调用时检测并缓存）
+     */
+    static Kernel bestKernel();
+
+    /**
+     * @brief 当前CPU和编译目标是否支持指定实现
+     */
+    static bool isSupported(Kernel kernel);
+
+    static const char* kernelName(Kernel kernel);
+
+    /**
+     * @brief 查找 [begin, end) 中所有 ',' 和 '\n' 的偏移
+     * @param[in]  kernel  使用的实现，必须是 isSupported() 的
+     * @param[in]  begin   数据起始地址
+     * @param[in]  end     数据结束地址，数据长度不超过 4GB
+     * @param[out] offsets 输出缓冲区，前 n 项为按升序排列的偏移（相对 begin）；
+     *                     容量不足时自动扩大，建议在多次调用间复用
+     * @return 找到的分隔符个数 n
+     */
+    static int scan(Kernel kernel, const char* begin, const char* end, std::vector<quint32>& offsets);
+
+    static int scan(const char* begin, const char* end, std::vector<quint32>& offsets)
+    {
+        return scan(bestKernel(), begin, end, offsets);
+    }
+};
+
+#endif // DELIMITERSCANNER_H
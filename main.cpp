@@ -4,15 +4,18 @@
  * @copyright  Copyright (c) 2025
  * @license    MIT
  * @author     lzq
- * @version    1.0
- * @date       2025-11-13
+ * @version    1.1
+ * @date       2026-10-17
  *
  * @par        版本历史:
  *             V1.0: [lzq] [2025-11-13] [创建文件并实现主入口功能]
+ *             V1.1: [lzq] [2026-10-17] [增加 --parse-benchmark 命令行模式]
  */
 
 #include "mainwindow.h"
+#include "parsebenchmark.h"
 #include <QtWidgets/QApplication>
+#include <QCoreApplication>
 
 /**
  * @brief 应用程序的主入口点
@@ -22,6 +25,12 @@
  */
 int main(int argc, char *argv[])
 {
+    // 纯解析基准测试: StudentMessageManagementSystem --parse-benchmark <file>，不创建窗口
+    if (argc >= 3 && qstrcmp(argv[1], "--parse-benchmark") == 0) {
+        QCoreApplication app(argc, argv);
+        return runParseBenchmark(QString::fromLocal8Bit(argv[2]));
+    }
+
     // 创建QApplication实例，这是所有Qt应用程序的核心
     QApplication app(argc, argv);
 
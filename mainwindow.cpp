@@ -4,18 +4,53 @@
  * @copyright  Copyright (c) 2025
  * @license    MIT
  * @author     lzq
- * @version    1.1 (重构以使用Qt Designer UI)
- * @date       2025-11-13
+ * @version    2.6 (数据访问层)
+ * @date       2026-10-17
  *
  * @par        版本历史:
  *             V1.0: [lzq] [2025-11-13] [创建文件并实现基本功能]
  *             V1.1: [lzq] [2025-11-13] [重构UI到.ui文件，仅保留业务逻辑]
+ *             V1.2: [lzq] [2026-10-17] [分页查询由LIMIT/OFFSET改为基于游标的键集分页]
+ *             V1.3: [lzq] [2026-10-17] [由触发器维护的记录数缓存代替每次查询前的COUNT(*)]
+ *             V1.4: [lzq] [2026-10-17] [文件导入改用 StudentImporter 多线程流水线]
+ *             V1.5: [lzq] [2026-10-17] [导入到空表时使用批量导入: 先删索引和计数触发器，导入后重建]
+ *             V1.6: [lzq] [2026-10-17] [数据库连接统一由 ConnectionManager 提供（性能配置 + 按线程复用）]
+ *             V1.7: [lzq] [2026-10-17] [查询路径改用按连接缓存的预编译语句，翻页不再重新解析SQL]
+ *             V1.8: [lzq] [2026-10-17] [查询、计数和结果格式化移到工作线程，主线程不再等待SQLite]
+ *             V1.9: [lzq] [2026-10-17] [列表结果改用 StudentTableModel + QTableView 按需加载，去掉翻页按钮]
+ *             V2.0: [lzq] [2026-10-17] [新增出生日期索引，最年轻学生查询支持前N名且不再全表排序]
+ *             V2.1: [lzq] [2026-10-17] [新增坐标R树索引（SQLite rtree 模块），支持矩形范围、半径范围和k近邻查询]
+ *             V2.2: [lzq] [2026-10-17] [性别和地址名改为 student_strings 字典编号，旧数据库启动时一次性转换]
+ *             V2.3: [lzq] [2026-10-17] [导出改用 StudentExporter 多线程流水线]
+ *             V2.4: [lzq] [2026-10-17] [支持保存/加载二进制列式快照（*.snap）]
+ *             V2.5: [lzq] [2026-10-17] [表结构维护移入 StudentSchema，导入流程移入 StudentImporter::importFile()]
+ *             V2.6: [lzq] [2026-10-17] [所有 students 表的读写改为调用 StudentRepository，界面中不再有查询SQL]
  *
  * @par        大数据处理说明:
- *             (保留为空)
+ *             列表类查询（按姓名/X坐标查询、各种排序显示）的结果显示在表格视图中，记录由
+ *             StudentTableModel 随滚动按块读取（键集游标定位，见 studenttablemodel.h），
+ *             内存中只保留有限的块，视图只渲染可见的行，不再有固定每页100行的翻页。
+ *
+ *             记录数不再通过 COUNT(*) 扫描得到: students_total / students_name_counts /
+ *             students_coordx_counts 三张计数表由 students 上的触发器在插入、删除、更新（含导入时的
+ *             UPSERT）时同步维护，查询总数只需一次主键查找。计数表尚未建立时在后台重建，期间总数
+ *             显示为估算值（随已加载的行数抬高），重建完成后再刷新为精确值。
+ *
+ *             所有查询（表格数据、总数、按学号、最年轻学生）都在 QtConcurrent 线程池中用该线程
+ *             自己的连接执行，结果通过 QMetaObject::invokeMethod 排队送回主线程。每次查询分配
+ *             递增的序号，用户发起新查询后，旧请求在读取下一行前发现序号过期即停止，已在路上的
+ *             结果也会被丢弃。
+ *
+ *             地址坐标 (X, Y) 由 students_rtree（rtree_i32 虚拟表）索引，同样由触发器与 students
+ *             同步。矩形/半径范围查询只访问R树中相交的节点，k近邻查询先求出第k近的距离再按
+ *             半径查询，结果都在表格中按需加载。旧数据库首次启动时在后台建立R树，建立完成前
+ *             （或 SQLite 未编译 rtree 模块时）范围查询退回 X 坐标索引上的范围扫描。
  */
 
 #include "mainwindow.h"
+#include "connectionmanager.h"
+#include "studentrepository.h"
+#include "studentschema.h"
 #include "ui_StudentMessageManagementSystem.h" // UI文件生成的头文件
 
 #include <QInputDialog>
@@ -33,6 +68,11 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QDebug>
+#include <QHeaderView>
+#include <QTableView>
+#include <QRegularExpression>
+#include <algorithm>
+#include <memory>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::StudentMessageManagementSystemClass) // 正确初始化ui指针
@@ -49,10 +89,30 @@ MainWindow::MainWindow(QWidget *parent)
     // 创建表（如果不存在）
     createTable();
 
-    // 初始化分页变量
-    currentPage = 0;
-    totalPages = 0;
+    // 初始化结果表格状态
+    tableGeneration = 0;
     totalCount = 0;
+    countPending = false;
+    totalIsExact = true;
+    countsReady = false;
+    spatialReady = false;
+    latestGeneration = std::make_shared<QAtomicInt>(0);
+
+    // 结果表格: 固定行高，不按内容计算列宽，渲染代价只与可见行数有关
+    studentModel = new StudentTableModel(this);
+    ui->resultView->setModel(studentModel);
+    ui->resultView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->resultView->verticalHeader()->setDefaultSectionSize(ui->resultView->fontMetrics().height() + 6);
+    ui->resultView->horizontalHeader()->setStretchLastSection(true);
+    ui->resultView->hide();
+    connect(studentModel, &StudentTableModel::rowsFetched, this, &MainWindow::onRowsFetched);
+    connect(studentModel, &StudentTableModel::queryFailed, this, &MainWindow::onTableQueryFailed);
+
+    // 计数表尚未建立（如旧版本数据库）时在后台重建
+    ensureCountCache();
+
+    // 坐标R树尚未建立时在后台建立
+    ensureSpatialIndex();
 
     // 设置初始状态信息
     updateStatus("Ready");
@@ -73,36 +133,23 @@ MainWindow::MainWindow(QWidget *parent)
     // 查询菜单
     connect(ui->actionQueryByID, &QAction::triggered, this, &MainWindow::onQueryByID);
 
-    // 使用 lambda 表达式确保 resetPage 参数为 true
-    connect(ui->actionQueryByName, &QAction::triggered, this, [this](){
-        onQueryByName(true);
-    });
+    connect(ui->actionQueryByName, &QAction::triggered, this, &MainWindow::onQueryByName);
     connect(ui->actionQueryYoungest, &QAction::triggered, this, &MainWindow::onQueryYoungestStudent);
-    connect(ui->actionQueryByCoordX, &QAction::triggered, this, [this](){
-        onQueryByAddressCoordX(true);
-    });
+    connect(ui->actionQueryByCoordX, &QAction::triggered, this, &MainWindow::onQueryByAddressCoordX);
+    connect(ui->actionQueryInBox, &QAction::triggered, this, &MainWindow::onQueryInBox);
+    connect(ui->actionQueryInRadius, &QAction::triggered, this, &MainWindow::onQueryInRadius);
+    connect(ui->actionQueryNearest, &QAction::triggered, this, &MainWindow::onQueryNearest);
 
     // 显示菜单
-    // 同样修复所有带 bool 参数的槽的连接
-    connect(ui->actionDisplayPreorder, &QAction::triggered, this, [this](){
-        onDisplaySortByName(true);
-    });
-    connect(ui->actionDisplayInorder, &QAction::triggered, this, [this](){
-        onDisplaySortByID_ASC(true);
-    });
-    connect(ui->actionDisplayPostorder, &QAction::triggered, this, [this](){
-        onDisplaySortByID_DESC(true);
-    });
+    connect(ui->actionDisplayPreorder, &QAction::triggered, this, &MainWindow::onDisplaySortByName);
+    connect(ui->actionDisplayInorder, &QAction::triggered, this, &MainWindow::onDisplaySortByID_ASC);
+    connect(ui->actionDisplayPostorder, &QAction::triggered, this, &MainWindow::onDisplaySortByID_DESC);
 
     // 帮助菜单
     connect(ui->actionAbout, &QAction::triggered, this, &MainWindow::onAbout);
 
-    // 分页按钮连接
-    connect(ui->prevPageButton, &QPushButton::clicked, this, &MainWindow::onPrevPage);
-    connect(ui->nextPageButton, &QPushButton::clicked, this, &MainWindow::onNextPage);
-
-    // 更新分页控件初始状态
-    updatePageControls();
+    // 结果标签初始状态
+    updateResultLabel();
 
     // 更新菜单项文本
     ui->actionDisplayPreorder->setText(QString::fromUtf8("按姓名排序"));
@@ -115,7 +162,7 @@ MainWindow::MainWindow(QWidget *parent)
         QString::fromUtf8("主要功能:\n") +
         QString::fromUtf8("* 文件: 新建, 打开, 保存, 退出\n") +
         QString::fromUtf8("* 编辑: 添加和删除学生记录\n") +
-        QString::fromUtf8("* 查询: 按学号、姓名查询，最小年龄、按地址坐标查询\n") +
+        QString::fromUtf8("* 查询: 按学号、姓名查询，最小年龄、按地址坐标查询，矩形/半径范围和最近的k名学生\n") +
         QString::fromUtf8("* 显示: 按姓名排序、按ID升序、按ID降序\n") +
         QString::fromUtf8("* 帮助: 关于软件\n"));
 }
@@ -130,12 +177,12 @@ MainWindow::~MainWindow()
 
 void MainWindow::initDatabase()
 {
-    // 初始化数据库连接
-    db = QSqlDatabase::addDatabase("QSQLITE");
-    db.setDatabaseName("students.db");
+    // 初始化数据库连接（GUI线程的连接，已应用 WAL / mmap / 页缓存等性能配置）
+    ConnectionManager::instance().setDatabaseName("students.db");
+    db = ConnectionManager::instance().connection();
 
     // 打开数据库
-    if (!db.open()) {
+    if (!db.isOpen()) {
         QMessageBox::critical(this, "Database Error",
                              "Failed to open database: " + db.lastError().text());
         return;
@@ -146,45 +193,121 @@ void MainWindow::initDatabase()
 
 void MainWindow::createTable()
 {
-    QSqlQuery query(db);
-
-    // 创建学生表
-    bool success = query.exec("CREATE TABLE IF NOT EXISTS students ("
-                            "studentID TEXT PRIMARY KEY NOT NULL,"
-                            "name TEXT NOT NULL,"
-                            "birthDate TEXT NOT NULL,"
-                            "gender TEXT NOT NULL,"
-                            "addressName TEXT NOT NULL,"
-                            "addressCoordX INTEGER NOT NULL,"
-                            "addressCoordY INTEGER NOT NULL"
-                            ");");
-
-    if (!success) {
-        qDebug() << "Failed to create students table:" << query.lastError().text();
+    // 字典表、学生表、二级索引和计数缓存（见 studentschema.h），旧版本的表在这里一次性转换
+    bool migrated = false;
+    QString error;
+    if (!StudentSchema::create(db, migrated, error)) {
+        qDebug() << error;
         return;
     }
+    if (migrated) {
+        updateStatus("Students table converted to the current format");
+    }
 
-    // 为name字段创建索引，优化查询性能
-    success = query.exec("CREATE INDEX IF NOT EXISTS idx_students_name ON students(name);");
-    if (!success) {
-        qDebug() << "Failed to create index on name:" << query.lastError().text();
+    updateStatus("Database tables and indexes created successfully");
+}
+
+void MainWindow::ensureCountCache()
+{
+    // students_total 中有记录说明计数表已建立，并由触发器维护至今
+    QSqlQuery query(db);
+    if (StudentSchema::hasCountCache(query)) {
+        countsReady = true;
         return;
     }
 
-    // 为addressCoordX字段创建索引，优化查询性能
-    success = query.exec("CREATE INDEX IF NOT EXISTS idx_students_addressCoordX ON students(addressCoordX);");
-    if (!success) {
-        qDebug() << "Failed to create index on addressCoordX:" << query.lastError().text();
+    countsReady = false;
+    (void)QtConcurrent::run([this]() {
+        bool success = false;
+        QSqlDatabase threadDb = ConnectionManager::instance().connection();
+        if (threadDb.isOpen()) {
+            success = StudentSchema::rebuildCountCache(threadDb);
+        } else {
+            qWarning() << "Failed to open database in count thread:" << threadDb.lastError().text();
+        }
+
+        // 返回主线程: 计数就绪后把当前显示的估算值刷新为精确值
+        QMetaObject::invokeMethod(this, [this, success]() {
+            countsReady = success;
+            // 总数仍在读取中时由读取完成的回调负责刷新（见 startTableQuery）
+            if (success && !totalIsExact && tableGeneration != 0 && !countPending) {
+                refreshTotalCount();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::ensureSpatialIndex()
+{
+    // R树与触发器在同一个事务中建立并填充，表存在即说明内容完整
+    QSqlQuery query(db);
+    if (StudentSchema::hasSpatialTable(query)) {
+        spatialReady = StudentSchema::createSpatialTriggers(query);
         return;
     }
 
-    updateStatus("Database tables and indexes created successfully");
+    (void)QtConcurrent::run([this]() {
+        bool success = false;
+        QSqlDatabase threadDb = ConnectionManager::instance().connection();
+        if (threadDb.isOpen()) {
+            QString error;
+            success = StudentSchema::createSpatialIndex(threadDb, error);
+            if (!success) {
+                // SQLite 未编译 rtree 模块时也会走到这里，范围查询继续使用 X 坐标索引
+                qWarning() << "Spatial index unavailable:" << error;
+            }
+        } else {
+            qWarning() << "Failed to open database in spatial index thread:" << threadDb.lastError().text();
+        }
+
+        QMetaObject::invokeMethod(this, [this, success]() {
+            spatialReady = success;
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief 在工作线程重新读取当前表格查询的精确总数，只更新结果标签，不重新读取记录
+ */
+void MainWindow::refreshTotalCount()
+{
+    const StudentTableModel::Query spec = lastTableQuery;
+    const int generation = tableGeneration;
+    std::shared_ptr<QAtomicInt> latest = latestGeneration;
+    (void)QtConcurrent::run([this, spec, generation, latest]() {
+        int count = 0;
+        bool exact = false;
+        QString error;
+        if (!StudentRepository::count(spec, true, count, exact, error)) {
+            qWarning() << "Failed to refresh total count:" << error;
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, count, generation, latest]() {
+            // 期间开始了新查询时，总数由新查询负责
+            if (latest->loadRelaxed() != generation || countPending) {
+                return;
+            }
+            totalCount = count;
+            totalIsExact = true;
+            updateResultLabel();
+        }, Qt::QueuedConnection);
+    });
+}
+
+QString MainWindow::countText(int count, bool exact)
+{
+    return exact ? QString::number(count) : QString("~%1").arg(count);
+}
+
+QString MainWindow::totalCountText() const
+{
+    return countText(totalCount, totalIsExact);
 }
 
 // ==================== 辅助函数 (Helper Functions) ====================
 // create...Menu() 函数已被移除
 
-QString MainWindow::formatStudentInfo(const Student &student) const
+QString MainWindow::formatStudentInfo(const Student &student)
 {
     return QString("ID: %1\n"
                    "Name: %2\n"
@@ -201,23 +324,6 @@ QString MainWindow::formatStudentInfo(const Student &student) const
         .arg(student.addressCoordY);
 }
 
-QString MainWindow::formatMultipleStudents(const QVector<Student> &students) const
-{
-    if (students.isEmpty())
-    {
-        return "No matching students found";
-    }
-
-    QString result;
-    for (int i = 0; i < students.size(); ++i)
-    {
-        result += QString("===== Student %1 =====\n").arg(i + 1);
-        result += formatStudentInfo(students[i]);
-        result += "\n";
-    }
-    return result;
-}
-
 void MainWindow::updateStatus(const QString &message)
 {
     // statusBar() 是QMainWindow的内置函数，可以直接使用
@@ -226,6 +332,10 @@ void MainWindow::updateStatus(const QString &message)
 
 void MainWindow::displayOutput(const QString &text)
 {
+    // 文本结果与表格结果共用一块区域，显示文本时隐藏表格
+    ui->resultView->hide();
+    ui->displayArea->show();
+
     // 通过ui指针访问.ui文件中定义的displayArea控件
     ui->displayArea->setText(text);
 }
@@ -236,6 +346,12 @@ void MainWindow::appendOutput(const QString &text)
     ui->displayArea->append(text);
 }
 
+void MainWindow::showResultTable()
+{
+    ui->displayArea->hide();
+    ui->resultView->show();
+}
+
 // ==================== File Menu Implementation ====================
 
 void MainWindow::onNewContactList()
@@ -247,15 +363,23 @@ void MainWindow::onNewContactList()
 
     if (result == QMessageBox::Yes)
     {
-        QSqlQuery query(db);
-        bool success = query.exec("DELETE FROM students;");
+        QString error;
+        bool success = StudentSchema::clear(db, spatialReady, error);
+        if (success) {
+            countsReady = true;
+            // 清空前发起的查询结果已失效
+            beginQuery();
+            studentModel->clear();
+            tableGeneration = 0;
+            updateResultLabel();
+        }
 
         if (success) {
             displayOutput("Contact list cleared");
             updateStatus("Contact list cleared");
         } else {
             QMessageBox::warning(this, "Error",
-                                "Failed to clear contact list: " + query.lastError().text());
+                                "Failed to clear contact list: " + error);
             updateStatus("Failed to clear contact list");
         }
     }
@@ -270,7 +394,7 @@ void MainWindow::onLoadFromFile()
     // 打开文件对话框选择要加载的数据文件
     QString filePath = QFileDialog::getOpenFileName(this,
                                                     "Open File", "",
-                                                    "Text Files (*.txt *.csv);;All Files (*)");
+                                                    "Text Files (*.txt *.csv);;Snapshot Files (*.snap);;All Files (*)");
 
     // 如果用户取消选择则返回
     if (filePath.isEmpty())
@@ -284,18 +408,16 @@ void MainWindow::onLoadFromFile()
     // 使用QtConcurrent将文件导入任务放到后台线程执行
     (void)QtConcurrent::run([this, filePath]() {
 
-        // --- 1. 为这个新线程创建独立的数据库连接 ---
-        // 我们需要一个唯一的连接名称，例如基于线程ID
-        QString connectionName = QString("importer_thread_%1").arg(quintptr(QThread::currentThreadId()));
+        // --- 1. 取得本线程的数据库连接（由连接池复用，线程结束时自动关闭） ---
         int successCount = 0;
         int failCount = 0;
+        QString rebuildError;
+        bool rebuildRestored = false;
 
-        // 使用花括号确保 QSqlDatabase 对象在 lambda 结束前被销毁
         {
-            QSqlDatabase threadDb = QSqlDatabase::addDatabase("QSQLITE", connectionName);
-            threadDb.setDatabaseName("students.db");
+            QSqlDatabase threadDb = ConnectionManager::instance().connection();
 
-            if (!threadDb.open()) {
+            if (!threadDb.isOpen()) {
                 qWarning() << "Thread DB Error: Failed to open database in thread:" << threadDb.lastError().text();
                 // 返回主线程报告错误
                 QMetaObject::invokeMethod(this, [this]() {
@@ -306,134 +428,72 @@ void MainWindow::onLoadFromFile()
                 return;
             }
 
-            // 尝试打开选中的文件
-            QFile file(filePath);
-            if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-            {
-                qWarning() << "Cannot open file in thread:" << filePath;
-                QMetaObject::invokeMethod(this, [this]() {
-                    QMessageBox::critical(this, "Error", "Cannot open file in background thread.");
+            // --- 2. 读取/并行解析/单线程写入 流水线 ---
+            // 表为空时使用批量导入（先删除二级索引和触发器，导入后一次性重建），见 StudentImporter::importFile()
+            ImportResult result = StudentRepository::importFile(threadDb, filePath);
+            successCount = result.successCount;
+            failCount = result.failCount;
+
+            if (result.status == ImportResult::RebuildFailed) {
+                // 记录已导入，但计数缓存和R树已被标记为不可用，二级索引和计数触发器也不存在。
+                // 先在本线程恢复索引和触发器（逐行维护从此继续），计数和R树由主线程交给后台重建
+                qWarning() << "Rebuild after import failed:" << result.error;
+                rebuildError = result.error;
+                QSqlQuery ddl(threadDb);
+                rebuildRestored = StudentSchema::createSecondaryIndexes(ddl) && StudentSchema::createCountTriggers(ddl);
+                if (!rebuildRestored) {
+                    qWarning() << "Failed to restore indexes and count triggers:" << ddl.lastError().text();
+                }
+            } else if (result.status != ImportResult::Ok) {
+                qWarning() << "Import failed:" << result.error;
+                QString message;
+                switch (result.status) {
+                case ImportResult::FileOpenFailed:
+                    message = "Cannot open file in background thread.";
+                    break;
+                case ImportResult::InvalidFormat:
+                    message = "Invalid or corrupted snapshot file: " + result.error;
+                    break;
+                default:
+                    message = "Failed to start database transaction.";
+                    break;
+                }
+                QMetaObject::invokeMethod(this, [this, message]() {
+                    QMessageBox::critical(this, "Error", message);
                     this->setEnabled(true);
                     updateStatus("Import failed");
                 }, Qt::QueuedConnection);
-                threadDb.close(); // 关闭数据库连接
                 return;
             }
-
-            QTextStream in(&file);
-
-            // --- 2. 边读边插，分批处理 ---
-            const int BATCH_SIZE = 5000; // 每5000条插入一次
-            QVariantList studentIDs, names, birthDates, genders, addressNames, coordXs, coordYs;
-
-            // 开始事务
-            if (!threadDb.transaction()) {
-                 qWarning() << "Failed to start transaction:" << threadDb.lastError().text();
-                 QMetaObject::invokeMethod(this, [this]() {
-                     QMessageBox::critical(this, "Error", "Failed to start database transaction.");
-                     this->setEnabled(true);
-                     updateStatus("Import failed");
-                 }, Qt::QueuedConnection);
-                 file.close();
-                 threadDb.close();
-                 return;
-            }
-
-            QSqlQuery query(threadDb);
-            query.prepare("INSERT OR REPLACE INTO students (studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY) "
-                          "VALUES (?, ?, ?, ?, ?, ?, ?)");
-
-            while (!in.atEnd())
-            {
-                QString line = in.readLine().trimmed();
-                if (line.isEmpty()) continue;
-
-                QStringList parts = line.split(',');
-                if (parts.size() != 7) {
-                    failCount++;
-                    continue;
-                }
-
-                QDate birthDate = QDate::fromString(parts[2].trimmed(), "yyyy-MM-dd");
-                if (parts[0].trimmed().isEmpty() || !birthDate.isValid()) {
-                    failCount++;
-                    continue;
-                }
-
-                // 添加到批处理列表
-                studentIDs.append(parts[0].trimmed());
-                names.append(parts[1].trimmed());
-                birthDates.append(birthDate);
-                genders.append(parts[3].trimmed());
-                addressNames.append(parts[4].trimmed());
-                coordXs.append(parts[5].trimmed().toInt());
-                coordYs.append(parts[6].trimmed().toInt());
-
-                // --- 3. 达到批处理大小，执行插入 ---
-                if (studentIDs.size() >= BATCH_SIZE) {
-                    query.addBindValue(studentIDs);
-                    query.addBindValue(names);
-                    query.addBindValue(birthDates);
-                    query.addBindValue(genders);
-                    query.addBindValue(addressNames);
-                    query.addBindValue(coordXs);
-                    query.addBindValue(coordYs);
-
-                    if (!query.execBatch()) {
-                        qWarning() << "Batch insert failed:" << query.lastError().text();
-                        failCount += studentIDs.size(); // 这批全都算失败
-                    } else {
-                        successCount += studentIDs.size();
-                    }
-
-                    // 清空列表以备下一批
-                    studentIDs.clear(); names.clear(); birthDates.clear(); genders.clear();
-                    addressNames.clear(); coordXs.clear(); coordYs.clear();
-                }
-            }
-
-            // --- 4. 插入剩余的记录 ---
-            if (!studentIDs.isEmpty()) {
-                query.addBindValue(studentIDs);
-                query.addBindValue(names);
-                query.addBindValue(birthDates);
-                query.addBindValue(genders);
-                query.addBindValue(addressNames);
-                query.addBindValue(coordXs);
-                query.addBindValue(coordYs);
-
-                if (!query.execBatch()) {
-                    qWarning() << "Final batch insert failed:" << query.lastError().text();
-                    failCount += studentIDs.size();
-                } else {
-                    successCount += studentIDs.size();
-                }
-            }
-
-            file.close();
-
-            // 提交事务
-            if (!threadDb.commit()) {
-                qWarning() << "[Debug] 数据库错误: 事务提交失败!" << threadDb.lastError().text();
-                qWarning() << "Transaction commit failed:" << threadDb.lastError().text();
-                failCount = successCount + failCount; // 提交失败，所有都算失败
-                successCount = 0;
-                threadDb.rollback();
-            }
-
-            threadDb.close();
         }
 
-        // --- 5. 移除线程特定的数据库连接 ---
-        QSqlDatabase::removeDatabase(connectionName);
-
-        // --- 6. 导入完成，返回主线程更新UI ---
-        QMetaObject::invokeMethod(this, [this, successCount, failCount]() {
+        // --- 3. 导入完成，返回主线程更新UI ---
+        QMetaObject::invokeMethod(this, [this, successCount, failCount, rebuildError, rebuildRestored]() {
             QString message = QString("Successfully imported %1 records\nFailed (parse/insert): %2")
                                   .arg(successCount)
                                   .arg(failCount);
             displayOutput(message);
             updateStatus(message);
+            if (!rebuildError.isEmpty()) {
+                // 计数表重建完成前，总数按最大 rowid 估算，带姓名/X坐标过滤时按已读行数估算；
+                // R树重建完成前，范围查询走X坐标索引
+                countsReady = false;
+                spatialReady = false;
+                QString fallback;
+                if (rebuildRestored) {
+                    // 与启动时相同: 计数表和R树都已标记为不存在，在后台重新统计、重新建立
+                    ensureCountCache();
+                    ensureSpatialIndex();
+                    fallback = "Counts are estimates and spatial queries use the X coordinate index "
+                               "until they are rebuilt in the background.";
+                } else {
+                    fallback = "Counts are estimates and spatial queries use the X coordinate index "
+                               "until the application is restarted.";
+                }
+                QMessageBox::warning(this, "Warning",
+                                     "Records were imported, but rebuilding indexes failed: " + rebuildError
+                                         + "\n" + fallback);
+            }
             this->setEnabled(true);
         }, Qt::QueuedConnection);
     });
@@ -443,7 +503,7 @@ void MainWindow::onSaveToFile()
 {
     QString filePath = QFileDialog::getSaveFileName(this,
                                                     "Save File", "",
-                                                    "Text Files (*.txt *.csv);;All Files (*)");
+                                                    "Text Files (*.txt *.csv);;Snapshot Files (*.snap);;All Files (*)");
 
     if (filePath.isEmpty())
         return;
@@ -455,62 +515,25 @@ void MainWindow::onSaveToFile()
 
     // --- 使用 QtConcurrent 在后台线程执行导出 ---
     (void)QtConcurrent::run([this, filePath]() {
-        QString connectionName = QString("exporter_thread_%1").arg(quintptr(QThread::currentThreadId()));
-        int recordCount = 0;
-        bool exportError = false;
-        QString lastError;
-
-        { // 数据库连接的范围
-            QSqlDatabase threadDb = QSqlDatabase::addDatabase("QSQLITE", connectionName);
-            threadDb.setDatabaseName("students.db");
-
-            if (!threadDb.open()) {
-                qWarning() << "Failed to open database in export thread:" << threadDb.lastError().text();
-                exportError = true;
-                lastError = threadDb.lastError().text();
-            } else {
-                QFile file(filePath); // 在这个线程中创建文件对象
-                if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                    qWarning() << "Failed to open file in export thread:" << file.errorString();
-                    exportError = true;
-                    lastError = "Cannot create file in background thread.";
-                } else {
-                    QTextStream out(&file);
-                    QSqlQuery query(threadDb);
-                    // (关键) 使用 query.setForwardOnly(true) 优化大查询，减少内存缓冲
-                    query.setForwardOnly(true);
-
-                    if (query.exec("SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                                    "FROM students ORDER BY studentID")) {
-                        while (query.next()) {
-                            out << query.value(0).toString() << ","
-                                << query.value(1).toString() << ","
-                                << query.value(2).toString() << "," // 日期在数据库中存为TEXT
-                                << query.value(3).toString() << ","
-                                << query.value(4).toString() << ","
-                                << query.value(5).toInt() << ","
-                                << query.value(6).toInt() << "\n";
-                            recordCount++;
-                        }
-                    } else {
-                        qWarning() << "Failed to query students in export thread:" << query.lastError().text();
-                        exportError = true;
-                        lastError = query.lastError().text();
-                    }
-                    file.close();
-                }
-                threadDb.close();
-            }
-        } // 数据库连接在此销毁
-        QSqlDatabase::removeDatabase(connectionName);
+        // 扩展名为 .snap 时保存二进制列式快照，否则由导出流水线写文本
+        const ExportResult result = StudentRepository::exportFile(filePath);
+        const qint64 recordCount = result.recordCount;
+        const bool exportError = (result.status != ExportResult::Ok);
+        const bool mixedSnapshot = result.mixedSnapshot;
+        const QString lastError = (result.status == ExportResult::FileOpenFailed)
+                                      ? "Cannot create file in background thread."
+                                      : result.error;
 
         // --- 返回主线程更新UI ---
-        QMetaObject::invokeMethod(this, [this, recordCount, exportError, lastError]() {
+        QMetaObject::invokeMethod(this, [this, recordCount, exportError, mixedSnapshot, lastError]() {
             if (exportError) {
                 QMessageBox::critical(this, "Error", "Failed to export data: " + lastError);
                 updateStatus("Export failed.");
             } else {
                 QString message = QString("Saved %1 records to file").arg(recordCount);
+                if (mixedSnapshot) {
+                    message += " (the database changed during export; the file may mix old and new data)";
+                }
                 displayOutput(message);
                 updateStatus(message);
             }
@@ -530,10 +553,14 @@ void MainWindow::onInsertStudent()
         return;
 
     // 检查学号是否已经存在
-    QSqlQuery query(db);
-    query.prepare("SELECT studentID FROM students WHERE studentID = ?");
-    query.addBindValue(studentID);
-    if (!query.exec() || query.next())
+    bool duplicate = false;
+    QString error;
+    if (!StudentRepository::exists(studentID, duplicate, error))
+    {
+        QMessageBox::critical(this, "Error", "Failed to check student ID: " + error);
+        return;
+    }
+    if (duplicate)
     {
         QMessageBox::warning(this, "Error", "Student ID already exists");
         return;
@@ -569,18 +596,8 @@ void MainWindow::onInsertStudent()
     if (!ok)
         return;
 
-    // 使用INSERT INTO插入学生数据，不允许覆盖
-    query.prepare("INSERT INTO students (studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY) "
-                 "VALUES (?, ?, ?, ?, ?, ?, ?)");
-    query.addBindValue(studentID);
-    query.addBindValue(name);
-    query.addBindValue(birthDate); // QDate类型会自动转换为字符串
-    query.addBindValue(gender);
-    query.addBindValue(addressName);
-    query.addBindValue(coordX);
-    query.addBindValue(coordY);
-
-    if (query.exec())
+    const Student student(studentID, name, birthDate, gender, addressName, coordX, coordY);
+    if (StudentRepository::insert(student, error))
     {
         QString message = QString("Student %1 (%2) added successfully").arg(studentID, name);
         displayOutput(message);
@@ -588,7 +605,7 @@ void MainWindow::onInsertStudent()
     }
     else
     {
-        QMessageBox::critical(this, "Error", "Failed to add student: " + query.lastError().text());
+        QMessageBox::critical(this, "Error", "Failed to add student: " + error);
     }
 }
 
@@ -604,11 +621,13 @@ void MainWindow::onDeleteStudent()
 
     if (result == QMessageBox::Yes)
     {
-        QSqlQuery query(db);
-        query.prepare("DELETE FROM students WHERE studentID = ?");
-        query.addBindValue(studentID);
-
-        if (query.exec() && query.numRowsAffected() > 0)
+        bool removed = false;
+        QString error;
+        if (!StudentRepository::remove(studentID, removed, error))
+        {
+            QMessageBox::critical(this, "Error", "Failed to delete student: " + error);
+        }
+        else if (removed)
         {
             QString message = QString("Student %1 deleted").arg(studentID);
             displayOutput(message);
@@ -623,6 +642,29 @@ void MainWindow::onDeleteStudent()
 
 // ==================== Query Menu Implementation ====================
 
+/**
+ * @brief 在工作线程执行 work()，结果送回主线程后交给 done()
+ *
+ * work 只能使用 ConnectionManager 提供的本线程连接，不能访问成员变量；
+ * 在结果送达前用户又发起了其他查询时，done 不会被调用。
+ */
+template<typename Result, typename Work, typename Done>
+void MainWindow::runQueryAsync(Work work, Done done)
+{
+    const int generation = beginQuery();
+    std::shared_ptr<QAtomicInt> latest = latestGeneration;
+    updateStatus("Querying...");
+
+    (void)QtConcurrent::run([this, work, done, generation, latest]() {
+        Result result = work();
+        QMetaObject::invokeMethod(this, [done, result, generation, latest]() {
+            if (latest->loadRelaxed() == generation) {
+                done(result);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
 void MainWindow::onQueryByID()
 {
     bool ok;
@@ -631,436 +673,259 @@ void MainWindow::onQueryByID()
     if (!ok || studentID.isEmpty())
         return;
 
-    QSqlQuery query(db);
-    query.prepare("SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                 "FROM students WHERE studentID = ?");
-    query.addBindValue(studentID);
-
-    if (query.exec() && query.next())
-    {
-        // 构造Student对象
-        Student result;
-        result.studentID = query.value(0).toString();
-        result.name = query.value(1).toString();
-        result.birthDate = query.value(2).toDate();
-        result.gender = query.value(3).toString();
-        result.addressName = query.value(4).toString();
-        result.addressCoordX = query.value(5).toInt();
-        result.addressCoordY = query.value(6).toInt();
-
-        QString output = "===== Query Result =====\n";
-        output += formatStudentInfo(result);
-        displayOutput(output);
-        updateStatus("Query successful");
-    }
-    else
-    {
-        displayOutput(QString("Student with ID %1 not found").arg(studentID));
-        updateStatus("Query failed");
-    }
+    // 结果为空表示没有找到
+    runQueryAsync<QVector<Student>>([studentID]() {
+        QVector<Student> found;
+        Student student;
+        bool exists = false;
+        QString error;
+        if (StudentRepository::getById(studentID, student, exists, error) && exists)
+        {
+            found.append(student);
+        }
+        return found;
+    }, [this, studentID](const QVector<Student> &found) {
+        if (!found.isEmpty())
+        {
+            QString output = "===== Query Result =====\n";
+            output += formatStudentInfo(found.first());
+            displayOutput(output);
+            updateStatus("Query successful");
+        }
+        else
+        {
+            displayOutput(QString("Student with ID %1 not found").arg(studentID));
+            updateStatus("Query failed");
+        }
+    });
 }
 
-void MainWindow::onQueryByName(bool resetPage)
+void MainWindow::onQueryByName()
 {
-    QString name;
+    bool ok;
+    QString name = QInputDialog::getText(this, "Query by Name", "Enter Name:", QLineEdit::Normal, "", &ok);
 
-    // Handle page reset if requested
-    if (resetPage) {
-        bool ok;
-        name = QInputDialog::getText(this, "Query by Name", "Enter Name:", QLineEdit::Normal, "", &ok);
+    if (!ok || name.isEmpty())
+        return;
 
-        if (!ok || name.isEmpty())
-            return;
+    // 精确匹配名称，按学号排序；总数从计数缓存获取
+    startTableQuery({"name", name, "studentID", false},
+                    {QString("Query Results for '%1'").arg(name),
+                     QString("No students found with name %1").arg(name),
+                     "Query complete - no results",
+                     "Query complete - found %1 results"});
+}
 
-        currentPage = 0;
-        lastQueryType = "queryByName";
-        lastQueryParam = name;
+void MainWindow::onQueryYoungestStudent()
+{
+    bool ok;
+    int count = QInputDialog::getInt(this, "Query Youngest", "Number of students:", 1, 1, 1000, 1, &ok);
 
-        // 查询 1: 获取总记录数（精确匹配名称）- 仅在重置页面时执行
-        QSqlQuery countQuery(db);
-        countQuery.prepare("SELECT COUNT(*) FROM students WHERE name = ?");
-        countQuery.addBindValue(name);
+    if (!ok)
+        return;
 
-        if (!countQuery.exec() || !countQuery.next()) {
-            QMessageBox::critical(this, "Error", "Failed to query total count: " + countQuery.lastError().text());
-            updatePageControls();
+    // 结果为空表示通讯录为空；排序与 idx_students_birthDate_id 一致，只读取索引的前 count 项
+    runQueryAsync<QVector<Student>>([count]() {
+        QVector<Student> found;
+        QString error;
+        if (!StudentRepository::youngest(count, found, error))
+        {
+            qWarning() << "Failed to query youngest students:" << error;
+        }
+        return found;
+    }, [this](const QVector<Student> &found) {
+        if (found.isEmpty())
+        {
+            displayOutput("Contact list is empty");
+            updateStatus("Query failed");
             return;
         }
-        totalCount = countQuery.value(0).toInt();
-        totalPages = (totalCount + PageSize - 1) / PageSize;
-    } else {
-        // Use the last query parameter
-        name = lastQueryParam.toString();
-    }
-
-    if (totalCount == 0) {
-        displayOutput(QString("No students found with name %1").arg(name));
-        updateStatus("Query complete - no results");
-        updatePageControls();
-        return;
-    }
-
-    // 查询 2: 获取当前页的数据（精确匹配名称，按学号排序）
-    QSqlQuery query(db);
-
-    // ==================== 修复开始 ====================
-    // 将 LIMIT 和 OFFSET 值直接格式化到字符串中
-    int offset = currentPage * PageSize;
-    QString sql = QString(
-                      "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                      "FROM students WHERE name = ? ORDER BY studentID LIMIT %1 OFFSET %2"
-                      ).arg(PageSize).arg(offset);
-
-    query.prepare(sql);
-    query.addBindValue(name); // 仅绑定 'name'
-    // ==================== 修复结束 ====================
-
-    if (!query.exec()) {
-        QMessageBox::critical(this, "Error", "Failed to query students: " + query.lastError().text());
-        updatePageControls();
-        return;
-    }
 
-    QVector<Student> results;
-    while (query.next()) {
-        Student student;
-        student.studentID = query.value(0).toString();
-        student.name = query.value(1).toString();
-        student.birthDate = query.value(2).toDate();
-        student.gender = query.value(3).toString();
-        student.addressName = query.value(4).toString();
-        student.addressCoordX = query.value(5).toInt();
-        student.addressCoordY = query.value(6).toInt();
-        results.append(student);
-    }
-
-    // Simplified output - pagination info now shown in pageLabel
-    QString output = QString("===== Query Results for '%1' (Total %2 records) =====\n\n").arg(name).arg(totalCount);
-    output += formatMultipleStudents(results);
-    displayOutput(output);
-    updateStatus(QString("Query complete - found %1 results").arg(totalCount));
-    updatePageControls();
+        if (found.size() == 1)
+        {
+            QString output = "===== Youngest Student =====\n";
+            output += formatStudentInfo(found.first());
+            displayOutput(output);
+        }
+        else
+        {
+            QString output = QString("===== Youngest %1 Students =====\n\n").arg(found.size());
+            for (int i = 0; i < found.size(); ++i)
+            {
+                output += QString("===== Student %1 =====\n").arg(i + 1);
+                output += formatStudentInfo(found[i]);
+                output += "\n";
+            }
+            displayOutput(output);
+        }
+        updateStatus("Query successful");
+    });
 }
 
-void MainWindow::onQueryYoungestStudent()
+void MainWindow::onQueryByAddressCoordX()
 {
-    QSqlQuery query(db);
-    query.prepare("SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                 "FROM students ORDER BY birthDate DESC LIMIT 1");
+    bool ok;
+    int coordX = QInputDialog::getInt(this, "Query by Coordinate X", "Enter Coordinate X:", 0, -10000, 10000, 1, &ok);
 
-    if (!query.exec() || !query.next())
-    {
-        displayOutput("Contact list is empty");
-        updateStatus("Query failed");
+    if (!ok)
         return;
-    }
 
-    // 构造Student对象
-    Student youngest;
-    youngest.studentID = query.value(0).toString();
-    youngest.name = query.value(1).toString();
-    youngest.birthDate = query.value(2).toDate();
-    youngest.gender = query.value(3).toString();
-    youngest.addressName = query.value(4).toString();
-    youngest.addressCoordX = query.value(5).toInt();
-    youngest.addressCoordY = query.value(6).toInt();
-
-    QString output = "===== Youngest Student =====\n";
-    output += formatStudentInfo(youngest);
-    displayOutput(output);
-    updateStatus("Query successful");
+    // 精确匹配addressCoordX，按学号排序
+    startTableQuery({"addressCoordX", coordX, "studentID", false},
+                    {QString("Query Results for X = %1").arg(coordX),
+                     QString("No students found at coordinate X = %1").arg(coordX),
+                     "Query complete - no results",
+                     "Query complete - found %1 results"});
 }
 
-void MainWindow::onQueryByAddressCoordX(bool resetPage)
+/**
+ * @brief 读取用逗号或空格分隔的 count 个整数参数，其中前 coordinates 个是坐标
+ * @return 用户确认、格式正确且坐标在 [-CoordLimit, CoordLimit] 内返回true；否则提示后返回false
+ */
+bool MainWindow::getCoordinates(const QString &title, const QString &label, int count, int coordinates,
+                                QVector<int> &values)
 {
-    int coordX;
-
-    // Handle page reset if requested
-    if (resetPage) {
-        bool ok;
-        coordX = QInputDialog::getInt(this, "Query by Coordinate X", "Enter Coordinate X:", 0, -10000, 10000, 1, &ok);
-
-        if (!ok)
-            return;
-
-        currentPage = 0;
-        lastQueryType = "queryByAddressCoordX";
-        lastQueryParam = coordX;
-
-        // 查询 1: 获取总记录数（精确匹配addressCoordX）- 仅在重置页面时执行
-        QSqlQuery countQuery(db);
-        countQuery.prepare("SELECT COUNT(*) FROM students WHERE addressCoordX = ?");
-        countQuery.addBindValue(coordX);
-
-        if (!countQuery.exec() || !countQuery.next()) {
-            QMessageBox::critical(this, "Error", "Failed to query total count: " + countQuery.lastError().text());
-            updatePageControls();
-            return;
+    bool ok;
+    QString text = QInputDialog::getText(this, title, label, QLineEdit::Normal, "", &ok);
+    if (!ok || text.trimmed().isEmpty())
+        return false;
+
+    const QStringList parts = text.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts);
+    values.clear();
+    for (const QString &part : parts) {
+        bool isNumber = false;
+        const int value = part.toInt(&isNumber);
+        if (!isNumber) {
+            break;
         }
-        totalCount = countQuery.value(0).toInt();
-        totalPages = (totalCount + PageSize - 1) / PageSize;
-    } else {
-        // Use the last query parameter
-        coordX = lastQueryParam.toInt();
+        values.append(value);
     }
-
-    if (totalCount == 0) {
-        displayOutput(QString("No students found at coordinate X = %1").arg(coordX));
-        updateStatus("Query complete - no results");
-        updatePageControls();
-        return;
+    if (values.size() != count || parts.size() != count) {
+        QMessageBox::warning(this, "Input Error", QString("Please enter %1 integers.").arg(count));
+        return false;
     }
+    for (int i = 0; i < coordinates; ++i) {
+        if (values[i] < -StudentRepository::CoordLimit || values[i] > StudentRepository::CoordLimit) {
+            QMessageBox::warning(this, "Input Error",
+                                 QString("Coordinates must be between %1 and %2.")
+                                     .arg(-StudentRepository::CoordLimit)
+                                     .arg(StudentRepository::CoordLimit));
+            return false;
+        }
+    }
+    return true;
+}
 
-    // 查询 2: 获取当前页的数据（精确匹配addressCoordX，按学号排序）
-    QSqlQuery query(db);
-
-    // ==================== 修复开始 ====================
-    // 将 LIMIT 和 OFFSET 值直接格式化到字符串中
-    int offset = currentPage * PageSize;
-    QString sql = QString(
-                      "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                      "FROM students WHERE addressCoordX = ? ORDER BY studentID LIMIT %1 OFFSET %2"
-                      ).arg(PageSize).arg(offset);
+void MainWindow::onQueryInBox()
+{
+    QVector<int> v;
+    if (!getCoordinates("Query in Box", "Enter X1, Y1, X2, Y2:", 4, 4, v))
+        return;
 
-    query.prepare(sql);
-    query.addBindValue(coordX); // 仅绑定 'coordX'
-    // ==================== 修复结束 ====================
+    const int minX = std::min(v[0], v[2]), maxX = std::max(v[0], v[2]);
+    const int minY = std::min(v[1], v[3]), maxY = std::max(v[1], v[3]);
 
+    // 矩形内的学生按学号排序；R树只访问与矩形相交的节点
+    startTableQuery(StudentTableModel::Query::box(minX, minY, maxX, maxY, spatialReady),
+                    {QString("Students in [%1, %2] x [%3, %4]").arg(minX).arg(maxX).arg(minY).arg(maxY),
+                     "No students found in the box",
+                     "Query complete - no results",
+                     "Query complete - found %1 results"});
+}
 
-    if (!query.exec()) {
-        QMessageBox::critical(this, "Error", "Failed to query students: " + query.lastError().text());
-        updatePageControls();
+void MainWindow::onQueryInRadius()
+{
+    QVector<int> v;
+    if (!getCoordinates("Query in Radius", "Enter X, Y, Radius:", 3, 2, v))
+        return;
+    if (v[2] < 0) {
+        QMessageBox::warning(this, "Input Error", "Radius must not be negative.");
         return;
     }
 
-    QVector<Student> results;
-    while (query.next()) {
-        Student student;
-        student.studentID = query.value(0).toString();
-        student.name = query.value(1).toString();
-        student.birthDate = query.value(2).toDate();
-        student.gender = query.value(3).toString();
-        student.addressName = query.value(4).toString();
-        student.addressCoordX = query.value(5).toInt();
-        student.addressCoordY = query.value(6).toInt();
-        results.append(student);
+    // 半径内的学生由近到远排序
+    startTableQuery(StudentTableModel::Query::circle(v[0], v[1], qint64(v[2]) * v[2], 0, spatialReady),
+                    {QString("Students within %1 of (%2, %3)").arg(v[2]).arg(v[0]).arg(v[1]),
+                     "No students found within the radius",
+                     "Query complete - no results",
+                     "Query complete - found %1 results"});
+}
+
+void MainWindow::onQueryNearest()
+{
+    QVector<int> v;
+    if (!getCoordinates("Query Nearest", "Enter X, Y, Count:", 3, 2, v))
+        return;
+    if (v[2] <= 0) {
+        QMessageBox::warning(this, "Input Error", "Count must be positive.");
+        return;
     }
 
-    // Simplified output - pagination info now shown in pageLabel
-    QString output = QString("===== Query Results for X = %1 (Total %2 records) =====\n\n").arg(coordX).arg(totalCount);
-    output += formatMultipleStudents(results);
-    displayOutput(output);
-    updateStatus(QString("Query complete - found %1 results").arg(totalCount));
-    updatePageControls();
+    // 先求出第k近的距离，再作为半径查询读取前k名（同距离按学号取舍）
+    const int x = v[0], y = v[1], k = v[2];
+    const bool useRtree = spatialReady;
+    struct Radius
+    {
+        bool success;
+        qint64 radius2;
+        QString error;
+    };
+    runQueryAsync<Radius>([x, y, k, useRtree]() {
+        Radius result{false, -1, QString()};
+        result.success = StudentRepository::nearestRadius2(x, y, k, useRtree, result.radius2, result.error);
+        return result;
+    }, [this, x, y, k, useRtree](const Radius &result) {
+        if (!result.success) {
+            QMessageBox::critical(this, "Error", "Failed to query nearest students: " + result.error);
+            updateStatus("Query failed");
+            return;
+        }
+        if (result.radius2 < 0) {
+            displayOutput("Contact list is empty");
+            updateStatus("Query failed");
+            return;
+        }
+        startTableQuery(StudentTableModel::Query::circle(x, y, result.radius2, k, useRtree),
+                        {QString("%1 Nearest Students to (%2, %3)").arg(k).arg(x).arg(y),
+                         "Contact list is empty",
+                         "Query complete - no results",
+                         "Query complete - found %1 results"});
+    });
 }
 // mainwindow.cpp
 
 /**
  * @brief 按姓名排序显示学生信息
  */
-void MainWindow::onDisplaySortByName(bool resetPage)
+void MainWindow::onDisplaySortByName()
 {
-    // Handle page reset if requested
-    if (resetPage) {
-        currentPage = 0;
-        lastQueryType = "displaySortByName";
-        lastQueryParam = QVariant();
-
-        // 查询 1: 获取总记录数
-        QSqlQuery countQuery(db);
-        countQuery.prepare("SELECT COUNT(*) FROM students");
-
-        if (!countQuery.exec() || !countQuery.next()) {
-            QMessageBox::critical(this, "Error", "Failed to query total count: " + countQuery.lastError().text());
-            return;
-        }
-        totalCount = countQuery.value(0).toInt();
-        totalPages = (totalCount + PageSize - 1) / PageSize;
-    }
-
-    if (totalCount == 0) {
-        displayOutput("Contact list is empty");
-        updatePageControls();
-        return;
-    }
-
-    QSqlQuery query(db);
-
-    // ==================== 修复开始 ====================
-    // 将 LIMIT 和 OFFSET 值直接格式化到字符串中
-    int offset = currentPage * PageSize;
-    QString sql = QString(
-                      "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                      "FROM students ORDER BY name LIMIT %1 OFFSET %2"
-                      ).arg(PageSize).arg(offset);
-
-    // 因为没有 '?' 占位符, 我们可以直接 .exec(sql)
-    if (!query.exec(sql)) {
-        // ==================== 修复结束 ====================
-        QMessageBox::critical(this, "Error", "Failed to query students: " + query.lastError().text());
-        updatePageControls();
-        return;
-    }
-
-    QVector<Student> students;
-    while (query.next()) {
-        Student student;
-        student.studentID = query.value(0).toString();
-        student.name = query.value(1).toString();
-        student.birthDate = query.value(2).toDate();
-        student.gender = query.value(3).toString();
-        student.addressName = query.value(4).toString();
-        student.addressCoordX = query.value(5).toInt();
-        student.addressCoordY = query.value(6).toInt();
-        students.append(student);
-    }
-
-    QString output = QString("===== Display Sorted by Name (Total %1 records) =====\n\n").arg(totalCount);
-    output += formatMultipleStudents(students);
-    displayOutput(output);
-    updateStatus(QString("Display complete (Sorted by Name) - %1 total records").arg(totalCount));
-    updatePageControls();
+    startTableQuery({QString(), QVariant(), "name", false},
+                    {"Display Sorted by Name",
+                     "Contact list is empty",
+                     QString(),
+                     "Display complete (Sorted by Name) - %1 total records"});
 }
 /**
- * @brief (已修复) 显示中序遍历（按ID排序）
- *
- * 修复了 QSqlQuery 对象重用 bug。
- * (逻辑正确，保持不变)
+ * @brief 按学号升序显示学生信息
  */
-void MainWindow::onDisplaySortByID_ASC(bool resetPage)
+void MainWindow::onDisplaySortByID_ASC()
 {
-    // Handle page reset if requested
-    if (resetPage) {
-        currentPage = 0;
-        lastQueryType = "displaySortByID_ASC"; // <-- 更新查询类型
-        lastQueryParam = QVariant();
-
-        // 查询 1: 获取总记录数
-        QSqlQuery countQuery(db);
-        countQuery.prepare("SELECT COUNT(*) FROM students");
-
-        if (!countQuery.exec() || !countQuery.next()) {
-            QMessageBox::critical(this, "Error", "Failed to query total count: " + countQuery.lastError().text());
-            return;
-        }
-        totalCount = countQuery.value(0).toInt();
-        totalPages = (totalCount + PageSize - 1) / PageSize;
-    }
-
-    if (totalCount == 0) {
-        displayOutput("Contact list is empty");
-        updatePageControls();
-        return;
-    }
-
-    QSqlQuery query(db);
-
-    // ==================== 修复开始 ====================
-    // 将 LIMIT 和 OFFSET 值直接格式化到字符串中
-    int offset = currentPage * PageSize;
-    QString sql = QString(
-                      "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                      "FROM students ORDER BY studentID LIMIT %1 OFFSET %2"
-                      ).arg(PageSize).arg(offset);
-
-    // 因为没有 '?' 占位符, 我们可以直接 .exec(sql)
-    if (!query.exec(sql)) {
-        // ==================== 修复结束 ====================
-        QMessageBox::critical(this, "Error", "Failed to query students: " + query.lastError().text());
-        updatePageControls();
-        return;
-    }
-
-    QVector<Student> students;
-    while (query.next()) {
-        Student student;
-        student.studentID = query.value(0).toString();
-        student.name = query.value(1).toString();
-        student.birthDate = query.value(2).toDate();
-        student.gender = query.value(3).toString();
-        student.addressName = query.value(4).toString();
-        student.addressCoordX = query.value(5).toInt();
-        student.addressCoordY = query.value(6).toInt();
-        students.append(student);
-    }
-
-    // Simplified output - pagination info now shown in pageLabel
-    QString output = QString("===== Display Sorted by ID (Ascending) (Total %1 records) =====\n\n")
-                         .arg(totalCount);
-    output += formatMultipleStudents(students);
-    displayOutput(output);
-    updateStatus(QString("Display complete (Sorted by ID Ascending) - %1 total records").arg(totalCount));
-    updatePageControls();
+    startTableQuery({QString(), QVariant(), "studentID", false},
+                    {"Display Sorted by ID (Ascending)",
+                     "Contact list is empty",
+                     QString(),
+                     "Display complete (Sorted by ID Ascending) - %1 total records"});
 }
 /**
- * @brief (已修复) 显示后序遍历（修复为按ID倒序排序）
- *
- * 修复了 QSqlQuery 对象重用 bug。
- * [修复] 逻辑修复：将查询改为 ORDER BY studentID DESC，以区别于中序遍历。
+ * @brief 按学号降序显示学生信息
  */
-void MainWindow::onDisplaySortByID_DESC(bool resetPage)
+void MainWindow::onDisplaySortByID_DESC()
 {
-    // Handle page reset if requested
-    if (resetPage) {
-        currentPage = 0;
-        lastQueryType = "displaySortByID_DESC"; // <-- 确保类型正确
-        lastQueryParam = QVariant();
-
-        // 查询 1: 获取总记录数
-        QSqlQuery countQuery(db);
-        countQuery.prepare("SELECT COUNT(*) FROM students");
-
-        if (!countQuery.exec() || !countQuery.next()) {
-            QMessageBox::critical(this, "Error", "Failed to query total count: " + countQuery.lastError().text());
-            return;
-        }
-        totalCount = countQuery.value(0).toInt();
-        totalPages = (totalCount + PageSize - 1) / PageSize;
-    }
-
-    if (totalCount == 0) {
-        displayOutput("Contact list is empty");
-        updatePageControls();
-        return;
-    }
-
-    QSqlQuery query(db);
-
-    // ==================== 修复开始 ====================
-    // 将 LIMIT 和 OFFSET 值直接格式化到字符串中
-    int offset = currentPage * PageSize;
-    QString sql = QString(
-                      "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
-                      "FROM students ORDER BY studentID DESC LIMIT %1 OFFSET %2"
-                      ).arg(PageSize).arg(offset);
-
-    // 因为没有 '?' 占位符, 我们可以直接 .exec(sql)
-    if (!query.exec(sql)) {
-        // ==================== 修复结束 ====================
-        QMessageBox::critical(this, "Error", "Failed to query students: " + query.lastError().text());
-        updatePageControls();
-        return;
-    }
-
-    QVector<Student> students;
-    while (query.next()) {
-        Student student;
-        student.studentID = query.value(0).toString();
-        student.name = query.value(1).toString();
-        student.birthDate = query.value(2).toDate();
-        student.gender = query.value(3).toString();
-        student.addressName = query.value(4).toString();
-        student.addressCoordX = query.value(5).toInt();
-        student.addressCoordY = query.value(6).toInt();
-        students.append(student);
-    }
-
-    // 更新输出文本
-    QString output = QString("===== Display Sorted by ID (Descending) (Total %1 records) =====\n\n").arg(totalCount);
-    output += formatMultipleStudents(students);
-    displayOutput(output);
-    updateStatus(QString("Display complete (Sorted by ID Descending) - %1 total records").arg(totalCount));
-    updatePageControls();
+    startTableQuery({QString(), QVariant(), "studentID", true},
+                    {"Display Sorted by ID (Descending)",
+                     "Contact list is empty",
+                     QString(),
+                     "Display complete (Sorted by ID Descending) - %1 total records"});
 }
 // ==================== Help Menu Implementation ====================
 
@@ -1071,62 +936,131 @@ void MainWindow::onAbout()
                        "Student Contact Management System\n"
                        "Version 2.0\n\n"
                        "A SQLite database based student information management system optimized for large datasets.\n"
-                       "Refactored to use Qt Designer for UI management and support pagination.\n\n"
+                       "Refactored to use Qt Designer for UI management and show large results in a lazily loaded table.\n\n"
                        "Developer: Student Management Team\n"
                        "License: MIT");
 }
 
-// ==================== Pagination Implementation ====================
+// ==================== Result Table Implementation ====================
 
-void MainWindow::onPrevPage()
+int MainWindow::beginQuery()
 {
-    if (currentPage > 0) {
-        currentPage--;
-        reRunLastQuery();
-    }
+    return latestGeneration->fetchAndAddRelaxed(1) + 1;
 }
 
-void MainWindow::onNextPage()
+/**
+ * @brief 在表格中显示一个列表查询的结果
+ * @param[in] query 查询形状（过滤条件和排序列）
+ * @param[in] view  结果的显示文本
+ *
+ * 记录由 studentModel 随滚动按块读取；总数在工作线程从计数缓存读取，与第一块记录同时进行。
+ */
+void MainWindow::startTableQuery(const StudentTableModel::Query &query, const ResultView &view)
 {
-    if (currentPage < (totalPages - 1)) {
-        currentPage++;
-        reRunLastQuery();
-    }
+    const int generation = beginQuery();
+    tableGeneration = generation;
+    lastTableQuery = query;
+    currentView = view;
+    totalCount = 0;
+    totalIsExact = false;
+    countPending = true;
+
+    studentModel->setQuery(query);
+    ui->resultView->scrollToTop();
+    showResultTable();
+    updateStatus("Querying...");
+    updateResultLabel();
+
+    const bool useCounts = countsReady;
+    std::shared_ptr<QAtomicInt> latest = latestGeneration;
+    (void)QtConcurrent::run([this, query, useCounts, generation, latest]() {
+        int count = 0;
+        bool exact = false;
+        QString error;
+        // 坐标范围查询在R树上统计，其余读取计数缓存
+        const bool success = StudentRepository::count(query, useCounts, count, exact, error);
+
+        QMetaObject::invokeMethod(this, [this, success, count, exact, error, generation, latest]() {
+            if (latest->loadRelaxed() != generation) {
+                return;
+            }
+            countPending = false;
+            if (!success) {
+                QMessageBox::critical(this, "Error", "Failed to query total count: " + error);
+                updateStatus("Query failed");
+                updateResultLabel();
+                return;
+            }
+
+            // 估算期间已加载的行数可能已经超过估算值
+            totalIsExact = exact || studentModel->atEnd();
+            totalCount = exact ? count : std::max(count, studentModel->rowCount());
+            if (totalIsExact && totalCount == 0) {
+                displayOutput(currentView.emptyMessage);
+                if (!currentView.emptyStatus.isEmpty()) {
+                    updateStatus(currentView.emptyStatus);
+                }
+            } else {
+                updateStatus(currentView.doneStatus.arg(totalCountText()));
+            }
+            updateResultLabel();
+
+            // 读取期间计数表已重建完成，把估算值刷新为精确值
+            if (!totalIsExact && countsReady) {
+                refreshTotalCount();
+            }
+        }, Qt::QueuedConnection);
+    });
 }
 
-void MainWindow::updatePageControls()
+void MainWindow::onRowsFetched(int loadedRows, bool atEnd)
 {
-    if (totalCount == 0) {
-        ui->prevPageButton->setEnabled(false);
-        ui->nextPageButton->setEnabled(false);
-        ui->pageLabel->setText("N/A");
+    if (tableGeneration != latestGeneration->loadRelaxed()) {
         return;
     }
 
-    // Update page label
-    ui->pageLabel->setText(
-        QString("Page %1 of %2 (%3 total records)")
-            .arg(currentPage + 1)
-            .arg(totalPages)
-            .arg(totalCount)
-    );
-
-    // Update button states
-    ui->prevPageButton->setEnabled(currentPage > 0);
-    ui->nextPageButton->setEnabled(currentPage < (totalPages - 1));
+    // 计数尚为估算值时，用已确认存在的行数修正；读到末尾时已加载的行数就是精确总数
+    if (!countPending && !totalIsExact) {
+        totalCount = std::max(totalCount, loadedRows);
+        if (atEnd) {
+            totalCount = loadedRows;
+            totalIsExact = true;
+        }
+    }
+
+    if (atEnd && loadedRows == 0 && !countPending) {
+        displayOutput(currentView.emptyMessage);
+        if (!currentView.emptyStatus.isEmpty()) {
+            updateStatus(currentView.emptyStatus);
+        }
+    }
+    updateResultLabel();
+}
+
+void MainWindow::onTableQueryFailed(const QString &error)
+{
+    if (tableGeneration != latestGeneration->loadRelaxed()) {
+        return;
+    }
+    QMessageBox::critical(this, "Error", "Failed to query students: " + error);
+    updateStatus("Query failed");
 }
 
-void MainWindow::reRunLastQuery()
+void MainWindow::updateResultLabel()
 {
-    if (lastQueryType == "queryByName") {
-        onQueryByName(false);
-    } else if (lastQueryType == "queryByAddressCoordX") {
-        onQueryByAddressCoordX(false);
-    } else if (lastQueryType == "displaySortByName") {
-        onDisplaySortByName(false);
-    } else if (lastQueryType == "displaySortByID_ASC") {
-        onDisplaySortByID_ASC(false);
-    } else if (lastQueryType == "displaySortByID_DESC") {
-        onDisplaySortByID_DESC(false);
+    if (tableGeneration == 0) {
+        ui->pageLabel->setText("N/A");
+        return;
+    }
+
+    const int loaded = studentModel->rowCount();
+    if (countPending) {
+        ui->pageLabel->setText(QString("%1: counting... (%2 loaded)").arg(currentView.title).arg(loaded));
+    } else if (totalIsExact) {
+        ui->pageLabel->setText(QString("%1: %2 records (%3 loaded)").arg(currentView.title).arg(totalCount).arg(loaded));
+    } else {
+        // 计数缓存重建期间显示估算值
+        ui->pageLabel->setText(QString("%1: ~%2 records (%3 loaded, counting...)")
+                                   .arg(currentView.title).arg(totalCount).arg(loaded));
     }
 }
@@ -4,20 +4,36 @@
  * @copyright  Copyright (c) 2025
  * @license    MIT
  * @author     lzq
- * @version    1.1 (使用Qt Designer简化)
- * @date       2025-11-13
+ * @version    1.9 (数据访问层)
+ * @date       2026-10-17
  *
  * @par        版本历史:
  *             V1.0: [lzq] [2025-11-13] [创建文件并实现基本功能]
  *             V1.1: [lzq] [2025-11-13] [重构以完全使用Qt Designer，简化代码]
+ *             V1.2: [lzq] [2026-10-17] [分页查询由LIMIT/OFFSET改为基于游标的键集分页]
+ *             V1.3: [lzq] [2026-10-17] [增加由触发器维护的记录数缓存]
+ *             V1.4: [lzq] [2026-10-17] [二级索引的创建/删除独立出来，供批量导入使用]
+ *             V1.5: [lzq] [2026-10-17] [查询改为在工作线程执行，结果分批送回界面，过期请求自动作废]
+ *             V1.6: [lzq] [2026-10-17] [列表结果改用按需加载的表格视图，去掉固定每页100行的翻页]
+ *             V1.7: [lzq] [2026-10-17] [新增坐标R树索引和矩形范围、半径范围、k近邻查询]
+ *             V1.8: [lzq] [2026-10-17] [索引、计数触发器和R树的维护函数移入 StudentSchema]
+ *             V1.9: [lzq] [2026-10-17] [readTotalCount() 移入 StudentRepository::count()]
  */
 
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QAtomicInt>
 #include <QMainWindow>
 #include <QSqlDatabase>
+#include <QVariant>
+#include <QVector>
 #include "student.h" // 确保包含了 student.h
+#include "studenttablemodel.h"
+
+#include <memory>
+
+class QSqlQuery;
 
  // 向前声明 Qt Designer 生成的 UI 类
 QT_BEGIN_NAMESPACE
@@ -58,37 +74,67 @@ private slots:
 
     // Query Menu Slots
     void onQueryByID();
-    void onQueryByName(bool resetPage = true);
-    void onQueryByAddressCoordX(bool resetPage = true);
+    void onQueryByName();
+    void onQueryByAddressCoordX();
     void onQueryYoungestStudent();
+    void onQueryInBox();
+    void onQueryInRadius();
+    void onQueryNearest();
 
     // Display Menu Slots
-    void onDisplaySortByName(bool resetPage = true);
-    void onDisplaySortByID_ASC(bool resetPage = true);
-    void onDisplaySortByID_DESC(bool resetPage = true);
+    void onDisplaySortByName();
+    void onDisplaySortByID_ASC();
+    void onDisplaySortByID_DESC();
 
-    // Pagination Slots
-    void onPrevPage();
-    void onNextPage();
+    // Result Table Slots
+    void onRowsFetched(int loadedRows, bool atEnd);
+    void onTableQueryFailed(const QString& error);
 
     // Help Menu Slots
     void onAbout();
 
 private:
     // 辅助函数保持不变
-    QString formatStudentInfo(const Student& student) const;
-    QString formatMultipleStudents(const QVector<Student>& students) const;
+    static QString formatStudentInfo(const Student& student);
     void updateStatus(const QString& message);
     void displayOutput(const QString& text);
     void appendOutput(const QString& text);
+    void showResultTable();
 
     // SQLite 数据库相关辅助函数
     void initDatabase();
     void createTable();
 
-    // Pagination Helper Functions
-    void updatePageControls();
-    void reRunLastQuery();
+    /**
+     * @struct ResultView
+     * @brief 表格结果的显示文本，由发起查询的槽函数提供
+     */
+    struct ResultView
+    {
+        QString title;         ///< 结果标题，显示在表格上方
+        QString emptyMessage;  ///< 没有记录时显示的内容
+        QString emptyStatus;   ///< 没有记录时的状态栏文本（为空表示不更新）
+        QString doneStatus;    ///< 得到总数后的状态栏文本，%1 为总数
+    };
+
+    // 结果表格: 记录由 studentModel 按需分块读取，这里只负责总数和标签
+    void startTableQuery(const StudentTableModel::Query& query, const ResultView& view);
+    void updateResultLabel();
+
+    // 记录数缓存（由 students 上的触发器维护，见 studentschema.h）
+    void ensureCountCache();
+    void refreshTotalCount();
+    static QString countText(int count, bool exact);
+    QString totalCountText() const;
+
+    // 坐标R树索引（students_rtree，由触发器与 students 同步）
+    void ensureSpatialIndex();
+    bool getCoordinates(const QString& title, const QString& label, int count, int coordinates, QVector<int>& values);
+
+    // 异步查询: 每次查询分配一个序号，结果送回主线程时序号已过期则丢弃
+    int beginQuery();
+    template<typename Result, typename Work, typename Done>
+    void runQueryAsync(Work work, Done done);
 
     // ==================== 成员变量 ====================
 
@@ -98,13 +144,23 @@ private:
     // 核心数据结构 - SQLite 数据库连接
     QSqlDatabase db;
 
-    // 分页相关
-    int currentPage;
-    int totalPages;
+    // 结果表格
+    StudentTableModel* studentModel;       ///< 表格视图的数据模型
+    StudentTableModel::Query lastTableQuery;  ///< 最近一次表格查询，计数就绪后用于刷新总数
+    ResultView currentView;                ///< 最近一次表格查询的显示文本
+    int tableGeneration;                   ///< 最近一次表格查询的序号，0 表示没有
     int totalCount;
-    QString lastQueryType;
-    QVariant lastQueryParam;
-    const int PageSize = 100;
+    bool countPending;                     ///< 总数尚在工作线程中读取
+
+    // 记录数缓存状态
+    bool countsReady;                      ///< 计数表是否已建立并可用
+    bool totalIsExact;                     ///< totalCount 是精确值还是估算值（估算时随已加载的行数抬高）
+
+    // 坐标索引状态
+    bool spatialReady;                     ///< students_rtree 是否已建立并可用，否则坐标范围查询走 X 坐标索引
+
+    // 异步查询状态
+    std::shared_ptr<QAtomicInt> latestGeneration;  ///< 最新查询的序号，工作线程据此放弃过期请求
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,137 @@
+﻿/**
+ * @file       nodearena.h
+ * @brief      树形容器使用的分块节点池（slab arena）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，为二叉搜索树提供基于下标的节点池]
+ *
+ * @par        设计说明:
+ *             节点按固定大小的块（slab）批量分配，块一旦分配就不会移动，因此节点引用在后续
+ *             分配中始终有效；节点之间用32位下标而不是指针互相链接，比shared_ptr少了控制块
+ *             和原子引用计数，也让相邻插入的节点在内存中连续存放。删除的节点进入空闲链表复用，
+ *             clear() 直接整体释放所有块，不会出现递归析构。
+ */
+
+#ifndef NODEARENA_H
+#define NODEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @class NodeArena
+ * @brief 以32位下标寻址的分块节点池
+ *
+ * @tparam NodeT     节点类型，必须可默认构造、可赋值
+ * @tparam ChunkBits 每块容纳 2^ChunkBits 个节点（默认4096个）
+ */
+template<typename NodeT, int ChunkBits = 12>
+class NodeArena
+{
+public:
+    static constexpr int Nil = -1;                        ///< 空链接
+    static constexpr int ChunkSize = 1 << ChunkBits;      ///< 每块节点数
+
+    NodeArena() : used(0), liveCount(0) {}
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    NodeArena(NodeArena&&) = default;
+    NodeArena& operator=(NodeArena&&) = default;
+
+    /**
+     * @brief 分配一个节点
+     * @return 新节点的下标，节点内容为默认构造值
+     * @note 时间复杂度: 均摊O(1)，优先复用已释放的节点
+     */
+    int allocate()
+    {
+        ++liveCount;
+        if (!freeList.empty())
+        {
+            int index = freeList.back();
+            freeList.pop_back();
+            return index;
+        }
+
+        if (used == static_cast<int>(chunks.size()) * ChunkSize)
+        {
+            chunks.emplace_back(new NodeT[ChunkSize]);
+        }
+        return used++;
+    }
+
+    /**
+     * @brief 释放一个节点，使其可被后续 allocate() 复用
+     * @param[in] index 要释放的节点下标
+     * @note 节点内容被重置为默认值，以便及时释放其持有的资源（如QString）
+     */
+    void release(int index)
+    {
+        (*this)[index] = NodeT();
+        freeList.push_back(index);
+        --liveCount;
+    }
+
+    /**
+     * @brief 释放全部节点和内存块
+     * @note 不做任何逐节点的树形遍历，只是依次释放各个块
+     */
+    void clear()
+    {
+        chunks.clear();
+        freeList.clear();
+        used = 0;
+        liveCount = 0;
+    }
+
+    NodeT& operator[](int index)
+    {
+        return chunks[index >> ChunkBits][index & (ChunkSize - 1)];
+    }
+
+    const NodeT& operator[](int index) const
+    {
+        return chunks[index >> ChunkBits][index & (ChunkSize - 1)];
+    }
+
+    /**
+     * @brief 当前在用的节点数
+     */
+    int size() const
+    {
+        return liveCount;
+    }
+
+    /**
+     * @brief 每个节点占用的字节数（不含节点数据自身在堆上的部分，如QString的内容）
+     */
+    static constexpr std::size_t bytesPerNode()
+    {
+        return sizeof(NodeT);
+    }
+
+    /**
+     * @brief 节点池当前占用的总字节数（已分配的块 + 空闲链表 + 块表）
+     */
+    std::size_t memoryUsage() const
+    {
+        return chunks.size() * ChunkSize * sizeof(NodeT)
+             + freeList.capacity() * sizeof(int)
+             + chunks.capacity() * sizeof(std::unique_ptr<NodeT[]>);
+    }
+
+private:
+    std::vector<std::unique_ptr<NodeT[]>> chunks;  ///< 已分配的块，块地址在生命周期内固定
+    std::vector<int> freeList;                     ///< 已释放、待复用的节点下标
+    int used;                                      ///< 已经从块中切出的节点数（含已释放的）
+    int liveCount;                                 ///< 当前在用的节点数
+};
+
+#endif // NODEARENA_H
@@ -0,0 +1,31 @@
+﻿/**
+ * @file       parsebenchmark.h
+ * @brief      导入解析的纯解析基准测试（不写数据库）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，对比 split 解析与各分隔符扫描实现的吞吐量]
+ *
+ * @par        使用方法:
+ *             StudentMessageManagementSystem --parse-benchmark large_data.txt
+ *             在单线程上按导入时的块大小依次解析整个文件，输出每种实现的 GB/s 和行数。
+ */
+
+#ifndef PARSEBENCHMARK_H
+#define PARSEBENCHMARK_H
+
+#include <QString>
+
+/**
+ * @brief 运行纯解析基准测试并把结果输出到标准输出
+ * @param[in] filePath 数据文件路径
+ * @param[in] rounds   每种实现重复的次数，取最快的一次
+ * @return 进程退出码，0 表示成功
+ */
+int runParseBenchmark(const QString& filePath, int rounds = 3);
+
+#endif // PARSEBENCHMARK_H
@@ -0,0 +1,30 @@
+# students 表的数据访问层（StudentRepository）及其依赖的导入/导出/快照流水线，
+# 编译为静态库，由界面程序、基准测试等通过 studentrepository.pri 链接
+QT += core sql concurrent
+QT -= gui
+TARGET = StudentRepository
+TEMPLATE = lib
+CONFIG += c++17 staticlib
+
+SOURCES += \
+    $$PWD/../studentrepository.cpp \
+    $$PWD/../studentimporter.cpp \
+    $$PWD/../studentexporter.cpp \
+    $$PWD/../studentsnapshot.cpp \
+    $$PWD/../studentschema.cpp \
+    $$PWD/../studentdictionary.cpp \
+    $$PWD/../connectionmanager.cpp \
+    $$PWD/../delimiterscanner.cpp
+
+HEADERS += \
+    $$PWD/../studentrepository.h \
+    $$PWD/../student.h \
+    $$PWD/../boundedqueue.h \
+    $$PWD/../csvreader.h \
+    $$PWD/../studentimporter.h \
+    $$PWD/../studentexporter.h \
+    $$PWD/../studentsnapshot.h \
+    $$PWD/../studentschema.h \
+    $$PWD/../studentdictionary.h \
+    $$PWD/../connectionmanager.h \
+    $$PWD/../delimiterscanner.h
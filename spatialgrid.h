@@ -0,0 +1,262 @@
+﻿/**
+ * @file       spatialgrid.h
+ * @brief      二维整数坐标的均匀网格空间索引
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，为内存容器提供矩形、圆形范围查询和k近邻查询]
+ *
+ * @par        设计说明:
+ *             学生地址坐标分布在固定范围 [-10000, 10000] 内，且大致均匀，因此使用均匀网格而不是
+ *             k-d树: 坐标空间按 cellSize 划分为格子，每个格子保存落在其中的 (x, y, 条目) 列表。
+ *             - 插入 O(1)，删除 O(格子内条目数)；
+ *             - 矩形/圆形查询只访问与区域相交的格子，完全落在区域内的格子不再逐点判断矩形条件；
+ *             - k近邻从中心所在格子按环向外扩展，当环的最近可能距离已超过当前第k近的距离时停止。
+ *             超出范围的坐标归入边缘的格子，查询结果仍然正确，只是边缘格子会变大。
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+/**
+ * @class SpatialGrid
+ * @brief 以整数条目（如节点下标）为值的点网格
+ */
+class SpatialGrid
+{
+public:
+    /**
+     * @struct Entry
+     * @brief 网格中的一个点
+     */
+    struct Entry
+    {
+        int x;
+        int y;
+        int item;   ///< 调用方的条目编号
+    };
+
+    /**
+     * @brief 构造网格
+     * @param[in] cellSize 格子边长
+     * @param[in] minCoord 坐标范围下界（两个轴相同）
+     * @param[in] maxCoord 坐标范围上界
+     */
+    explicit SpatialGrid(int cellSize = 256, int minCoord = -10000, int maxCoord = 10000)
+        : cellSize(cellSize),
+          minCoord(minCoord),
+          cellsPerAxis((maxCoord - minCoord) / cellSize + 1),
+          cells(std::size_t(cellsPerAxis) * cellsPerAxis),
+          count(0)
+    {
+    }
+
+    void insert(int x, int y, int item)
+    {
+        cells[cellIndex(cellOf(x), cellOf(y))].push_back({x, y, item});
+        ++count;
+    }
+
+    /**
+     * @brief 删除一个点（顺序不保留，与最后一个交换后弹出）
+     * @return 找到并删除返回true
+     */
+    bool remove(int x, int y, int item)
+    {
+        std::vector<Entry>& cell = cells[cellIndex(cellOf(x), cellOf(y))];
+        for (std::size_t i = 0; i < cell.size(); ++i)
+        {
+            if (cell[i].item == item)
+            {
+                cell[i] = cell.back();
+                cell.pop_back();
+                --count;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        for (std::vector<Entry>& cell : cells)
+        {
+            std::vector<Entry>().swap(cell);
+        }
+        count = 0;
+    }
+
+    int size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief 访问矩形 [minX, maxX] × [minY, maxY]（含边界）内的所有点
+     * @param[in] visit 对每个点调用 visit(const Entry&)
+     */
+    template<typename Visit>
+    void visitBox(int minX, int minY, int maxX, int maxY, Visit visit) const
+    {
+        if (minX > maxX || minY > maxY) return;
+
+        const int firstX = cellOf(minX), lastX = cellOf(maxX);
+        const int firstY = cellOf(minY), lastY = cellOf(maxY);
+        for (int cy = firstY; cy <= lastY; ++cy)
+        {
+            for (int cx = firstX; cx <= lastX; ++cx)
+            {
+                const std::vector<Entry>& cell = cells[cellIndex(cx, cy)];
+                // 内部格子（不在矩形边缘，也不是收纳越界坐标的边缘格子）中的点必然在矩形内
+                const bool inside = cx > firstX && cx < lastX && cy > firstY && cy < lastY;
+                for (const Entry& entry : cell)
+                {
+                    if (inside || (entry.x >= minX && entry.x <= maxX && entry.y >= minY && entry.y <= maxY))
+                    {
+                        visit(entry);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 访问以 (x, y) 为圆心、距离平方不超过 radius2 的所有点
+     * @param[in] visit 对每个点调用 visit(const Entry&, qint64 distance2)
+     */
+    template<typename Visit>
+    void visitRadius(int x, int y, qint64 radius2, Visit visit) const
+    {
+        if (radius2 < 0) return;
+
+        const qint64 radius = isqrtCeil(radius2);
+        const int minX = int(std::max<qint64>(qint64(x) - radius, INT_MIN));
+        const int maxX = int(std::min<qint64>(qint64(x) + radius, INT_MAX));
+        const int minY = int(std::max<qint64>(qint64(y) - radius, INT_MIN));
+        const int maxY = int(std::min<qint64>(qint64(y) + radius, INT_MAX));
+        for (int cy = cellOf(minY); cy <= cellOf(maxY); ++cy)
+        {
+            for (int cx = cellOf(minX); cx <= cellOf(maxX); ++cx)
+            {
+                for (const Entry& entry : cells[cellIndex(cx, cy)])
+                {
+                    const qint64 d2 = distance2(entry, x, y);
+                    if (d2 <= radius2)
+                    {
+                        visit(entry, d2);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 第k近的点到 (x, y) 的距离平方
+     * @return 点数不足k个时返回最远点的距离平方；网格为空或 k <= 0 时返回 -1
+     * @note 与 visitRadius 配合使用: 半径取该值即可得到全部k近邻（含距离相同的并列点）
+     */
+    qint64 nearestDistance2(int x, int y, int k) const
+    {
+        if (k <= 0 || count == 0) return -1;
+        k = std::min(k, count);
+
+        // 大顶堆保存目前最近的k个距离
+        std::vector<qint64> best;
+        best.reserve(std::size_t(k));
+        const int centerX = cellOf(x), centerY = cellOf(y);
+        for (int ring = 0; ring < cellsPerAxis; ++ring)
+        {
+            // 环上格子到中心点的最近可能距离，超过当前第k近时外面的环都不必再看
+            if (int(best.size()) == k)
+            {
+                const qint64 gap = ringGap(ring);
+                if (gap * gap > best.front()) break;
+            }
+
+            for (int cy = centerY - ring; cy <= centerY + ring; ++cy)
+            {
+                if (cy < 0 || cy >= cellsPerAxis) continue;
+                // 只访问环的边框: 首末行全部，中间行只取两端
+                const bool edgeRow = (cy == centerY - ring || cy == centerY + ring);
+                const int step = edgeRow ? 1 : std::max(1, 2 * ring);
+                for (int cx = centerX - ring; cx <= centerX + ring; cx += step)
+                {
+                    if (cx < 0 || cx >= cellsPerAxis) continue;
+                    for (const Entry& entry : cells[cellIndex(cx, cy)])
+                    {
+                        const qint64 d2 = distance2(entry, x, y);
+                        if (int(best.size()) < k)
+                        {
+                            best.push_back(d2);
+                            std::push_heap(best.begin(), best.end());
+                        }
+                        else if (d2 < best.front())
+                        {
+                            std::pop_heap(best.begin(), best.end());
+                            best.back() = d2;
+                            std::push_heap(best.begin(), best.end());
+                        }
+                    }
+                }
+            }
+        }
+        return best.front();
+    }
+
+private:
+    int cellOf(int coord) const
+    {
+        const qint64 cell = (qint64(coord) - minCoord) / cellSize;
+        return int(std::min<qint64>(std::max<qint64>(cell, 0), cellsPerAxis - 1));
+    }
+
+    std::size_t cellIndex(int cx, int cy) const
+    {
+        return std::size_t(cy) * std::size_t(cellsPerAxis) + std::size_t(cx);
+    }
+
+    static qint64 distance2(const Entry& entry, int x, int y)
+    {
+        const qint64 dx = qint64(entry.x) - x;
+        const qint64 dy = qint64(entry.y) - y;
+        return dx * dx + dy * dy;
+    }
+
+    /**
+     * @brief 第 ring 环上的点到中心点距离的下界
+     *
+     * 环 ring 上的格子与中心格子之间至少隔着 ring - 1 个完整格子。越界坐标只会被归入
+     * 更外侧的边缘格子，不会让这个下界失效。
+     */
+    qint64 ringGap(int ring) const
+    {
+        return ring <= 1 ? 0 : qint64(ring - 1) * cellSize;
+    }
+
+    static qint64 isqrtCeil(qint64 value)
+    {
+        qint64 root = qint64(std::sqrt(double(value)));
+        while (root * root < value) ++root;
+        while (root > 0 && (root - 1) * (root - 1) >= value) --root;
+        return root;
+    }
+
+    int cellSize;
+    int minCoord;
+    int cellsPerAxis;
+    std::vector<std::vector<Entry>> cells;  ///< 按行存放的格子
+    int count;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,112 @@
+﻿/**
+ * @file       stringpool.h
+ * @brief      紧凑学生记录使用的字符串池（字符串驻留）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，相同的字符串只保存一份，记录中只存32位编号]
+ *
+ * @par        设计说明:
+ *             姓名、地址这类重复度很高的字段在每条记录中各存一个 QString，即使内容相同，
+ *             导入时也会各自分配一块 UTF-16 堆内存。字符串池为每个不同的字符串分配一个
+ *             从0开始的连续编号，记录只保存编号；编号到字符串是数组下标，字符串到编号是
+ *             一次哈希查找。两个方向共用同一个 QString（隐式共享），每个字符串只有一份数据。
+ *             编号0固定为空字符串。池只增不减，不是线程安全的。
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @class StringPool
+ * @brief 字符串 <-> 连续编号的双向映射
+ */
+class StringPool
+{
+public:
+    static constexpr quint32 NotFound = 0xFFFFFFFFu;  ///< find() 未找到时的返回值
+
+    StringPool()
+    {
+        intern(QString());
+    }
+
+    /**
+     * @brief 取得字符串的编号，不存在时加入池中
+     * @note 时间复杂度: 均摊O(字符串长度)
+     */
+    quint32 intern(const QString& text)
+    {
+        auto it = ids.constFind(text);
+        if (it != ids.constEnd())
+        {
+            return it.value();
+        }
+        const quint32 id = quint32(strings.size());
+        strings.append(text);
+        ids.insert(text, id);
+        return id;
+    }
+
+    /**
+     * @brief 查找字符串的编号，不修改池
+     * @return 编号，不存在时返回 NotFound
+     */
+    quint32 find(const QString& text) const
+    {
+        return ids.value(text, NotFound);
+    }
+
+    /**
+     * @brief 按编号取字符串，编号无效时返回空字符串
+     */
+    QString string(quint32 id) const
+    {
+        return id < quint32(strings.size()) ? strings.at(int(id)) : QString();
+    }
+
+    /**
+     * @brief 池中不同字符串的个数（包括空字符串）
+     */
+    int size() const
+    {
+        return strings.size();
+    }
+
+    /**
+     * @brief 池占用内存的估算值（字符串数据 + 数组 + 哈希表），单位字节
+     */
+    qint64 memoryUsage() const
+    {
+        qint64 bytes = qint64(strings.capacity()) * qint64(sizeof(QString));
+        for (const QString& text : strings)
+        {
+            bytes += qint64(text.capacity() + 1) * qint64(sizeof(QChar));
+        }
+        // QHash 每个节点: 键 + 值 + next/hash，桶数组按每项一个指针估算
+        bytes += qint64(ids.size()) * qint64(sizeof(QString) + sizeof(quint32) + 2 * sizeof(void*));
+        return bytes;
+    }
+
+    void clear()
+    {
+        strings.clear();
+        ids.clear();
+        intern(QString());
+    }
+
+private:
+    QVector<QString> strings;      ///< 编号 -> 字符串
+    QHash<QString, quint32> ids;   ///< 字符串 -> 编号
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,652 @@
+﻿/**
+ * @file       studentbenchmark.cpp
+ * @brief      端到端基准测试的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [所有数据库访问改为通过 StudentRepository，增加全表流式扫描]
+ */
+
+#include "studentbenchmark.h"
+#include "binarysearchtree.h"
+#include "connectionmanager.h"
+#include "delimiterscanner.h"
+#include "studentexporter.h"
+#include "studentrepository.h"
+#include "studentschema.h"
+
+#include <QByteArray>
+#include <QDate>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+
+namespace
+{
+    const quint64 DatasetSeed = 20251113;
+
+    // 与 generate_data.py 相同的取值范围
+    const char* const Surnames[] = {"张", "李", "王", "赵", "刘", "陈", "杨", "黄", "吴", "周"};
+    const char* const GivenNames[] = {"三", "四", "五", "六", "七", "八", "九", "十", "明", "伟", "芳", "秀英"};
+    const char* const Genders[] = {"男", "女"};
+    const char* const Addresses[] = {"北京市", "上海市", "广州市", "深圳市", "杭州市", "南京市", "武汉市", "成都市"};
+
+    /**
+     * @class DatasetGenerator
+     * @brief 按 generate_data.py 的格式逐行生成学生数据，种子相同时结果相同
+     *
+     * 学号为 "2025" + 7位序号，按行号递增；其余字段均匀随机。所有文本事先生成好，
+     * 每行只需几次随机数和字节拷贝，千万行的数据几秒内即可生成。
+     */
+    class DatasetGenerator
+    {
+    public:
+        struct Row
+        {
+            qint64 index;
+            int name;      ///< names 中的下标
+            int day;       ///< 相对 1995-01-01 的天数
+            int gender;
+            int address;
+            int coordX;
+            int coordY;
+        };
+
+        explicit DatasetGenerator(quint64 seed)
+            : engine(seed), firstDay(QDate(1995, 1, 1).toJulianDay())
+        {
+            for (const char* surname : Surnames) {
+                for (const char* givenName : GivenNames) {
+                    const QByteArray name = QByteArray(surname) + givenName;
+                    nameBytes.append(name);
+                    names.append(QString::fromUtf8(name));
+                }
+            }
+            const qint64 lastDay = QDate(2005, 12, 31).toJulianDay();
+            for (qint64 day = firstDay; day <= lastDay; ++day) {
+                const QDate date = QDate::fromJulianDay(day);
+                dates.append(date);
+                dateBytes.append(date.toString("yyyy-MM-dd").toUtf8());
+            }
+            for (const char* gender : Genders) {
+                genders.append(QString::fromUtf8(gender));
+            }
+            for (const char* address : Addresses) {
+                addresses.append(QString::fromUtf8(address));
+            }
+        }
+
+        Row next(qint64 index)
+        {
+            Row row;
+            row.index = index;
+            row.name = int(engine() % quint64(names.size()));
+            row.day = int(engine() % quint64(dates.size()));
+            row.gender = int(engine() % quint64(genders.size()));
+            row.address = int(engine() % quint64(addresses.size()));
+            row.coordX = int(engine() % 20001) - 10000;
+            row.coordY = int(engine() % 20001) - 10000;
+            return row;
+        }
+
+        static QString studentID(qint64 index)
+        {
+            return QString("2025%1").arg(index, 7, 10, QLatin1Char('0'));
+        }
+
+        void appendLine(const Row& row, QByteArray& out) const
+        {
+            char digits[20];
+            int length = 0;
+            for (qint64 value = row.index; length < 7 || value > 0; value /= 10) {
+                digits[length++] = char('0' + value % 10);
+            }
+            out.append("2025", 4);
+            while (length > 0) {
+                out.append(digits[--length]);
+            }
+            out.append(',');
+            out.append(nameBytes[row.name]);
+            out.append(',');
+            out.append(dateBytes[row.day]);
+            out.append(',');
+            out.append(Genders[row.gender]);
+            out.append(',');
+            out.append(Addresses[row.address]);
+            out.append(',');
+            StudentExporter::appendInt(out, row.coordX);
+            out.append(',');
+            StudentExporter::appendInt(out, row.coordY);
+            out.append('\n');
+        }
+
+        Student student(const Row& row) const
+        {
+            return Student(studentID(row.index), names[row.name], dates[row.day],
+                           genders[row.gender], addresses[row.address], row.coordX, row.coordY);
+        }
+
+    private:
+        std::mt19937_64 engine;
+        qint64 firstDay;
+        QVector<QByteArray> nameBytes;
+        QVector<QString> names;
+        QVector<QByteArray> dateBytes;
+        QVector<QDate> dates;
+        QVector<QString> genders;
+        QVector<QString> addresses;
+    };
+
+    /**
+     * @brief 生成 rows 行数据文件
+     * @return 写入的字节数，失败时返回 -1
+     */
+    qint64 writeDataset(const QString& filePath, qint64 rows, QString& error)
+    {
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            error = file.errorString();
+            return -1;
+        }
+
+        const int flushBytes = 1 << 20;
+        DatasetGenerator generator(DatasetSeed);
+        QByteArray buffer;
+        buffer.reserve(flushBytes + 256);
+        qint64 written = 0;
+        for (qint64 i = 0; i < rows; ++i) {
+            generator.appendLine(generator.next(i), buffer);
+            if (buffer.size() >= flushBytes || i + 1 == rows) {
+                if (file.write(buffer) != buffer.size()) {
+                    error = file.errorString();
+                    return -1;
+                }
+                written += buffer.size();
+                buffer.clear();
+            }
+        }
+        return written;
+    }
+
+    double elapsedSeconds(const QElapsedTimer& timer)
+    {
+        return timer.nsecsElapsed() / 1e9;
+    }
+
+    struct Sample
+    {
+        double best = 0;
+        double median = 0;
+    };
+
+    /**
+     * @brief 重复运行 rounds 次，返回中位数和最快一次的耗时
+     */
+    template<typename Fn>
+    Sample repeat(int rounds, Fn fn)
+    {
+        QVector<double> times;
+        for (int round = 0; round < std::max(rounds, 1); ++round) {
+            QElapsedTimer timer;
+            timer.start();
+            fn();
+            times.append(elapsedSeconds(timer));
+        }
+        std::sort(times.begin(), times.end());
+        return {times.first(), times[times.size() / 2]};
+    }
+
+    QJsonObject result(const QString& name, qint64 rows, double seconds)
+    {
+        QJsonObject object;
+        object["name"] = name;
+        object["rows"] = rows;
+        object["seconds"] = seconds;
+        object["rows_per_second"] = seconds > 0 ? rows / seconds : 0.0;
+        return object;
+    }
+
+    QJsonObject result(const QString& name, qint64 rows, const Sample& sample, int rounds)
+    {
+        QJsonObject object = result(name, rows, sample.median);
+        object["best_seconds"] = sample.best;
+        object["rounds"] = rounds;
+        return object;
+    }
+
+    /**
+     * @class DatasetRun
+     * @brief 一种数据规模上的全部测量
+     */
+    class DatasetRun
+    {
+    public:
+        DatasetRun(QSqlDatabase& database, const QDir& dir, qint64 rows, bool spatial,
+                   const BenchmarkOptions& options, QTextStream& log)
+            : database(database), dir(dir), rows(rows), spatial(spatial), options(options), log(log)
+        {
+        }
+
+        bool run(QJsonArray& results);
+
+    private:
+        bool importExport(QJsonArray& results);
+        bool pages(QJsonArray& results);
+        bool queries(QJsonArray& results);
+        void tree(QJsonArray& results);
+
+        bool importFile(const QString& name, const QString& filePath, QJsonArray& results);
+        bool readPage(const StudentRepository::Query& query, const StudentRepository::Cursor* after,
+                      int limit, QVector<Student>& page);
+        bool locatePages(const StudentRepository::Query& query, qint64& total,
+                         QVector<StudentRepository::Cursor>& pageEnds);
+
+        QString path(const QString& suffix) const
+        {
+            return dir.filePath(QString("benchmark_%1%2").arg(rows).arg(suffix));
+        }
+
+        QSqlDatabase& database;
+        const QDir& dir;
+        const qint64 rows;
+        const bool spatial;
+        const BenchmarkOptions& options;
+        QTextStream& log;
+        QString error;
+    };
+
+    bool DatasetRun::run(QJsonArray& results)
+    {
+        log << "== " << rows << " rows ==" << Qt::endl;
+        const bool success = importExport(results) && pages(results) && queries(results);
+        if (success) {
+            tree(results);
+        }
+        if (!options.keepFiles) {
+            QFile::remove(path(".txt"));
+            QFile::remove(path("_export.txt"));
+            QFile::remove(path(".snap"));
+        }
+        if (!success) {
+            log << "Benchmark failed: " << error << Qt::endl;
+        }
+        return success;
+    }
+
+    bool DatasetRun::importFile(const QString& name, const QString& filePath, QJsonArray& results)
+    {
+        if (!StudentSchema::clear(database, spatial, error)) {
+            return false;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        const ImportResult imported = StudentRepository::importFile(database, filePath);
+        const double seconds = elapsedSeconds(timer);
+        if (imported.status != ImportResult::Ok) {
+            error = imported.error;
+            return false;
+        }
+
+        QJsonObject object = result(name, imported.successCount, seconds);
+        object["failed_rows"] = imported.failCount;
+        object["bytes"] = QFileInfo(filePath).size();
+        results.append(object);
+        log << name << ": " << seconds << " s" << Qt::endl;
+        return true;
+    }
+
+    bool DatasetRun::importExport(QJsonArray& results)
+    {
+        // 数据生成本身不属于被测代码，只记录以便核对
+        QElapsedTimer timer;
+        timer.start();
+        const qint64 bytes = writeDataset(path(".txt"), rows, error);
+        if (bytes < 0) {
+            return false;
+        }
+        QJsonObject generated = result("generate_dataset", rows, elapsedSeconds(timer));
+        generated["bytes"] = bytes;
+        results.append(generated);
+
+        // 导入到空表: 与界面的“从文件读取”相同，走批量导入
+        if (!importFile("import_csv", path(".txt"), results)) {
+            return false;
+        }
+
+        timer.start();
+        const ExportResult exported = StudentRepository::exportFile(path("_export.txt"));
+        if (exported.status != ExportResult::Ok) {
+            error = exported.error;
+            return false;
+        }
+        QJsonObject exportObject = result("export_csv", exported.recordCount, elapsedSeconds(timer));
+        exportObject["bytes"] = exported.bytesWritten;
+        results.append(exportObject);
+
+        timer.start();
+        const ExportResult saved = StudentRepository::exportFile(path(".snap"));
+        if (saved.status != ExportResult::Ok) {
+            error = saved.error;
+            return false;
+        }
+        QJsonObject snapshotObject = result("export_snapshot", saved.recordCount, elapsedSeconds(timer));
+        snapshotObject["bytes"] = saved.bytesWritten;
+        results.append(snapshotObject);
+
+        // 从快照恢复后数据库内容与CSV导入后相同，后续查询在此基础上进行
+        return importFile("import_snapshot", path(".snap"), results);
+    }
+
+    bool DatasetRun::readPage(const StudentRepository::Query& query, const StudentRepository::Cursor* after,
+                              int limit, QVector<Student>& page)
+    {
+        page.clear();
+        return StudentRepository::readPage(query, after, limit, page, error);
+    }
+
+    /**
+     * @brief 顺序读完整个结果，记录每一页（DefaultPageRows 行）最后一行的游标
+     *
+     * 第 p 页从 pageEnds[p - 1] 之后开始读取，与表格滚动到该页时的读取完全相同。
+     */
+    bool DatasetRun::locatePages(const StudentRepository::Query& query, qint64& total,
+                                 QVector<StudentRepository::Cursor>& pageEnds)
+    {
+        const int walkRows = 64 * StudentRepository::DefaultPageRows;
+        total = 0;
+        pageEnds.clear();
+
+        QVector<Student> chunk;
+        StudentRepository::Cursor after;
+        bool first = true;
+        do {
+            if (!readPage(query, first ? nullptr : &after, walkRows, chunk)) {
+                return false;
+            }
+            first = false;
+            for (const Student& student : chunk) {
+                if (++total % StudentRepository::DefaultPageRows == 0) {
+                    pageEnds.append(StudentRepository::cursorOf(query, student));
+                }
+            }
+            if (!chunk.isEmpty()) {
+                after = StudentRepository::cursorOf(query, chunk.last());
+            }
+        } while (chunk.size() == walkRows);
+        return true;
+    }
+
+    bool DatasetRun::pages(QJsonArray& results)
+    {
+        typedef StudentRepository::Query Query;
+        struct Shape
+        {
+            const char* name;
+            Query query;
+        };
+        // 界面上的每种列表查询
+        const Shape shapes[] = {
+            {"display_by_id_asc", {QString(), QVariant(), "studentID", false}},
+            {"display_by_id_desc", {QString(), QVariant(), "studentID", true}},
+            {"display_by_name", {QString(), QVariant(), "name", false}},
+            {"query_by_name", {"name", QString::fromUtf8("张三"), "studentID", false}},
+            {"query_by_coord_x", {"addressCoordX", 0, "studentID", false}},
+            {"query_in_box", Query::box(-2000, -2000, 2000, 2000, spatial)},
+            {"query_in_radius", Query::circle(0, 0, 2000LL * 2000, 0, spatial)},
+        };
+
+        for (const Shape& shape : shapes) {
+            qint64 total = 0;
+            QVector<StudentRepository::Cursor> pageEnds;
+            if (!locatePages(shape.query, total, pageEnds)) {
+                return false;
+            }
+
+            const qint64 pageCount = (total + StudentRepository::DefaultPageRows - 1) / StudentRepository::DefaultPageRows;
+            const struct
+            {
+                const char* name;
+                qint64 page;
+            } positions[] = {{"first", 0}, {"middle", pageCount / 2}, {"last", std::max<qint64>(pageCount - 1, 0)}};
+
+            for (const auto& position : positions) {
+                const StudentRepository::Cursor* after = position.page > 0 ? &pageEnds[int(position.page - 1)] : nullptr;
+                QVector<Student> page;
+                bool success = true;
+                const Sample sample = repeat(options.rounds, [&]() {
+                    success = readPage(shape.query, after, StudentRepository::DefaultPageRows, page) && success;
+                });
+                if (!success) {
+                    return false;
+                }
+                QJsonObject object = result(QString("%1_%2_page").arg(shape.name, position.name),
+                                            page.size(), sample, options.rounds);
+                object["page"] = position.page;
+                object["result_rows"] = total;
+                results.append(object);
+            }
+            log << shape.name << ": " << total << " rows, " << pageCount << " pages" << Qt::endl;
+        }
+        return true;
+    }
+
+    bool DatasetRun::queries(QJsonArray& results)
+    {
+        // 与“最年轻的学生”查询相同的语句: 顺序读取 idx_students_birthDate_id 的前 count 项
+        const int counts[] = {1, 100, 1000};
+        for (int count : counts) {
+            int found = 0;
+            bool success = true;
+            const Sample sample = repeat(options.rounds, [&]() {
+                QVector<Student> youngest;
+                success = StudentRepository::youngest(count, youngest, error) && success;
+                found = youngest.size();
+            });
+            if (!success) {
+                return false;
+            }
+            results.append(result(QString("youngest_%1").arg(count), found, sample, options.rounds));
+        }
+
+        // 最近的100名学生: 先求第k近的距离，再按半径查询读取前k名
+        const int k = 100;
+        int found = 0;
+        bool success = true;
+        const Sample sample = repeat(options.rounds, [&]() {
+            qint64 radius2 = -1;
+            QVector<Student> nearest;
+            success = StudentRepository::nearestRadius2(0, 0, k, spatial, radius2, error)
+                      && readPage(StudentRepository::Query::circle(0, 0, std::max<qint64>(radius2, 0), k, spatial),
+                                  nullptr, k, nearest)
+                      && success;
+            found = nearest.size();
+        });
+        if (!success) {
+            return false;
+        }
+        results.append(result(QString("nearest_%1").arg(k), found, sample, options.rounds));
+
+        // 按学号顺序流式读取全表（导出、统计等批处理的读取方式），内存中只有一页
+        qint64 scanned = 0;
+        QElapsedTimer timer;
+        timer.start();
+        const StudentRepository::Query all{QString(), QVariant(), "studentID", false};
+        if (!StudentRepository::scan(all, 4096, [&scanned](const QVector<Student>& page) {
+                scanned += page.size();
+                return true;
+            }, error)) {
+            return false;
+        }
+        results.append(result("scan_by_id", scanned, elapsedSeconds(timer)));
+        return true;
+    }
+
+    void DatasetRun::tree(QJsonArray& results)
+    {
+        DatasetGenerator generator(DatasetSeed);
+        QVector<Student> students;
+        students.reserve(int(rows));
+        for (qint64 i = 0; i < rows; ++i) {
+            students.append(generator.student(generator.next(i)));
+        }
+
+        BinarySearchTree<Student> tree;
+        QElapsedTimer timer;
+        timer.start();
+        for (const Student& student : students) {
+            tree.insert(student);
+        }
+        QJsonObject inserted = result("bst_insert", tree.size(), elapsedSeconds(timer));
+        inserted["bytes"] = qint64(tree.memoryUsage());
+        results.append(inserted);
+        students = QVector<Student>();
+
+        // 随机查找已存在的学号
+        const int lookups = int(std::min<qint64>(rows, 100000));
+        std::mt19937_64 engine(DatasetSeed);
+        QVector<QString> ids;
+        ids.reserve(lookups);
+        for (int i = 0; i < lookups; ++i) {
+            ids.append(DatasetGenerator::studentID(qint64(engine() % quint64(rows))));
+        }
+        int found = 0;
+        const Sample search = repeat(options.rounds, [&]() {
+            found = 0;
+            Student student;
+            for (const QString& id : ids) {
+                found += tree.search(id, student) ? 1 : 0;
+            }
+        });
+        results.append(result("bst_search", found, search, options.rounds));
+
+        qint64 visited = 0;
+        const Sample traversal = repeat(options.rounds, [&]() {
+            visited = 0;
+            qint64 checksum = 0;
+            tree.forEach([&](const Student& student) {
+                checksum += student.addressCoordX;
+                ++visited;
+            });
+            (void)checksum;
+        });
+        results.append(result("bst_inorder", visited, traversal, options.rounds));
+        log << "bst: " << tree.size() << " nodes" << Qt::endl;
+    }
+}
+
+int runBenchmark(const BenchmarkOptions& options)
+{
+    QTextStream log(stderr);
+
+    QDir dir(options.workDir.isEmpty() ? QDir::tempPath() : options.workDir);
+    if (!dir.exists() && !QDir().mkpath(dir.absolutePath())) {
+        log << "Cannot create directory " << dir.absolutePath() << Qt::endl;
+        return 1;
+    }
+
+    // 每次从空数据库开始，表结构与界面程序相同
+    const QString databasePath = dir.filePath("students_benchmark.db");
+    const QString databaseFiles[] = {databasePath, databasePath + "-wal", databasePath + "-shm"};
+    for (const QString& file : databaseFiles) {
+        QFile::remove(file);
+    }
+    ConnectionManager::instance().setDatabaseName(databasePath);
+    QSqlDatabase database = ConnectionManager::instance().connection();
+    if (!database.isOpen()) {
+        log << "Failed to open database: " << database.lastError().text() << Qt::endl;
+        return 1;
+    }
+
+    bool migrated = false;
+    QString error;
+    if (!StudentSchema::create(database, migrated, error)) {
+        log << error << Qt::endl;
+        return 1;
+    }
+    const bool spatial = StudentSchema::createSpatialIndex(database, error);
+    if (!spatial) {
+        log << "Spatial index unavailable, range queries use the X coordinate index: " << error << Qt::endl;
+    }
+
+    QJsonObject environment;
+    {
+        QSqlQuery query(database);
+        environment["sqlite"] = query.exec("SELECT sqlite_version()") && query.next()
+                                    ? query.value(0).toString() : QString();
+    }
+    environment["qt"] = QString(qVersion());
+    environment["os"] = QSysInfo::prettyProductName();
+    environment["cpu"] = QSysInfo::currentCpuArchitecture();
+    environment["threads"] = QThread::idealThreadCount();
+    environment["import_kernel"] = QString(DelimiterScanner::kernelName(DelimiterScanner::bestKernel()));
+    environment["spatial_index"] = spatial;
+    environment["page_rows"] = StudentRepository::DefaultPageRows;
+
+    QJsonArray datasets;
+    bool success = true;
+    for (qint64 rows : options.sizes) {
+        QJsonArray results;
+        DatasetRun run(database, dir, rows, spatial, options, log);
+        if (!run.run(results)) {
+            success = false;
+            break;
+        }
+        QJsonObject dataset;
+        dataset["rows"] = rows;
+        dataset["results"] = results;
+        datasets.append(dataset);
+    }
+
+    database = QSqlDatabase();
+    if (!options.keepFiles) {
+        for (const QString& file : databaseFiles) {
+            QFile::remove(file);
+        }
+    }
+    if (!success) {
+        return 1;
+    }
+
+    QJsonObject report;
+    report["benchmark"] = QString("StudentMessageManagementSystem");
+    report["format_version"] = 1;
+    report["generated"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["rounds"] = options.rounds;
+    report["environment"] = environment;
+    report["datasets"] = datasets;
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    QFile output(options.outputPath);
+    const bool opened = options.outputPath.isEmpty()
+                            ? output.open(stdout, QIODevice::WriteOnly)
+                            : output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!opened || output.write(json) != json.size()) {
+        log << "Cannot write " << options.outputPath << ": " << output.errorString() << Qt::endl;
+        return 1;
+    }
+    if (!options.outputPath.isEmpty()) {
+        log << "Results written to " << options.outputPath << Qt::endl;
+    }
+    return 0;
+}
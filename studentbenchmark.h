@@ -0,0 +1,53 @@
+﻿/**
+ * @file       studentbenchmark.h
+ * @brief      不依赖界面的端到端基准测试（导入、导出、分页查询、最年轻查询、BinarySearchTree）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [改为通过 StudentRepository 访问数据库，增加全表流式扫描]
+ *
+ * @par        使用方法:
+ *             StudentBenchmark [--sizes 10000,1000000,10000000] [--dir 目录] [--output 结果.json]
+ *                              [--rounds 5] [--keep]
+ *             每种规模的数据在进程内按 generate_data.py 的格式生成（固定随机种子，结果可重复），
+ *             然后依次测量:
+ *             - 导入/导出: StudentRepository::importFile()（与“从文件读取”相同，空表走批量导入）、
+ *               StudentRepository::exportFile()（文本和快照）、快照的加载；
+ *             - 分页查询: 界面上每种列表查询（排序显示、按姓名/X坐标、矩形/半径范围）的第一页、
+ *               中间一页和最后一页，各读取 StudentRepository::DefaultPageRows 行；
+ *             - 最年轻的前1/100/1000名学生，最近的100名学生，按学号流式扫描全表；
+ *             - BinarySearchTree: 逐条插入、按学号查找、中序遍历。
+ *             查询类测量重复 rounds 次，记录中位数和最快一次；结果以 JSON 输出，便于跟踪性能回归。
+ */
+
+#ifndef STUDENTBENCHMARK_H
+#define STUDENTBENCHMARK_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @struct BenchmarkOptions
+ * @brief 基准测试的参数
+ */
+struct BenchmarkOptions
+{
+    QVector<qint64> sizes = {10000, 1000000, 10000000};  ///< 数据规模（行数），依次测量
+    QString workDir;      ///< 数据文件和数据库所在目录，为空时使用系统临时目录
+    QString outputPath;   ///< JSON 结果文件，为空时写到标准输出
+    int rounds = 5;       ///< 查询类测量的重复次数
+    bool keepFiles = false;  ///< 结束后保留生成的数据文件和数据库
+};
+
+/**
+ * @brief 运行基准测试，进度输出到标准错误
+ * @return 进程退出码，0 表示成功
+ */
+int runBenchmark(const BenchmarkOptions& options);
+
+#endif // STUDENTBENCHMARK_H
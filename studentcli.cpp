@@ -0,0 +1,502 @@
+﻿/**
+ * @file       studentcli.cpp
+ * @brief      命令行批处理的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "studentcli.h"
+#include "connectionmanager.h"
+#include "studentexporter.h"
+#include "studentrepository.h"
+#include "studentschema.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+#include <QVector>
+#include <QtGlobal>
+
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    const int ScanPageRows = 4096;   ///< 流式输出查询结果时每页的行数
+
+    /**
+     * @struct Report
+     * @brief 一条命令的运行报告
+     */
+    struct Report
+    {
+        QString command;
+        qint64 rows = -1;        ///< 处理的行数，不适用时为 -1
+        qint64 failedRows = 0;
+        qint64 bytes = -1;       ///< 读写的文件大小，不涉及文件时为 -1
+        double seconds = 0;
+    };
+
+    double elapsedSeconds(const QElapsedTimer& timer)
+    {
+        return timer.nsecsElapsed() / 1e9;
+    }
+
+    QString mebibytes(qint64 bytes)
+    {
+        return QString("%1 MiB").arg(bytes / 1048576.0, 0, 'f', 1);
+    }
+
+    /**
+     * @brief 把报告写到标准错误，标准输出只留给查询结果
+     */
+    void printReport(const Report& report, bool json)
+    {
+        const qint64 peak = peakResidentBytes();
+        const double rowsPerSecond = report.seconds > 0 ? std::max<qint64>(report.rows, 0) / report.seconds : 0;
+        QTextStream err(stderr);
+
+        if (json) {
+            QJsonObject object;
+            object["command"] = report.command;
+            if (report.rows >= 0) {
+                object["rows"] = report.rows;
+                object["failed_rows"] = report.failedRows;
+                object["rows_per_second"] = rowsPerSecond;
+            }
+            if (report.bytes >= 0) {
+                object["bytes"] = report.bytes;
+            }
+            object["seconds"] = report.seconds;
+            object["peak_rss_bytes"] = peak;
+            err << QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact)) << Qt::endl;
+            return;
+        }
+
+        err << report.command << ":";
+        if (report.rows >= 0) {
+            err << " " << report.rows << " rows";
+            if (report.failedRows > 0) {
+                err << " (" << report.failedRows << " failed)";
+            }
+        }
+        if (report.bytes >= 0) {
+            err << ", " << mebibytes(report.bytes);
+        }
+        err << " in " << QString::number(report.seconds, 'f', 3) << " s";
+        if (report.rows >= 0) {
+            err << ", " << QString::number(rowsPerSecond, 'f', 0) << " rows/s";
+        }
+        err << ", peak RSS " << (peak >= 0 ? mebibytes(peak) : QString("n/a")) << Qt::endl;
+    }
+
+    /**
+     * @class RowWriter
+     * @brief 把查询结果按导入格式写到标准输出，每页拼成一个缓冲区整块写入
+     */
+    class RowWriter
+    {
+    public:
+        RowWriter()
+        {
+            opened = output.open(stdout, QIODevice::WriteOnly);
+        }
+
+        bool write(const QVector<Student>& rows)
+        {
+            if (!opened) {
+                return false;
+            }
+            buffer.clear();
+            for (const Student& student : rows) {
+                buffer += student.studentID.toUtf8();
+                buffer += ',';
+                buffer += student.name.toUtf8();
+                buffer += ',';
+                buffer += student.birthDate.toString("yyyy-MM-dd").toLatin1();
+                buffer += ',';
+                buffer += student.gender.toUtf8();
+                buffer += ',';
+                buffer += student.addressName.toUtf8();
+                buffer += ',';
+                StudentExporter::appendInt(buffer, student.addressCoordX);
+                buffer += ',';
+                StudentExporter::appendInt(buffer, student.addressCoordY);
+                buffer += '\n';
+            }
+            if (output.write(buffer) != buffer.size()) {
+                opened = false;
+                return false;
+            }
+            rowCount += rows.size();
+            byteCount += buffer.size();
+            return true;
+        }
+
+        bool finish()
+        {
+            return opened && output.flush();
+        }
+
+        qint64 rows() const { return rowCount; }
+        qint64 bytes() const { return byteCount; }
+        QString errorString() const { return output.errorString(); }
+
+    private:
+        QFile output;
+        QByteArray buffer;
+        bool opened = false;
+        qint64 rowCount = 0;
+        qint64 byteCount = 0;
+    };
+
+    /**
+     * @brief 把 args[first] 起的 count 个参数解析为整数，其中前 coordinates 个必须在坐标范围内
+     */
+    bool parseIntegers(const QStringList& args, int first, int count, int coordinates, QVector<int>& values)
+    {
+        if (args.size() != first + count) {
+            return false;
+        }
+        values.clear();
+        for (int i = first; i < args.size(); ++i) {
+            bool ok = false;
+            const int value = args.at(i).toInt(&ok);
+            if (!ok || (i - first < coordinates
+                        && (value < -StudentRepository::CoordLimit || value > StudentRepository::CoordLimit))) {
+                return false;
+            }
+            values.append(value);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 打开数据库并确保表结构、计数表存在（与界面程序启动时相同）
+     * @param[in]  buildSpatial R树不存在时是否立即建立（范围查询需要）
+     * @param[out] spatial      R树是否可用
+     */
+    bool openDatabase(const QString& path, bool buildSpatial, bool& spatial, QTextStream& log)
+    {
+        ConnectionManager::instance().setDatabaseName(path);
+        QSqlDatabase database = ConnectionManager::instance().connection();
+        if (!database.isOpen()) {
+            log << "Failed to open database " << path << ": " << database.lastError().text() << Qt::endl;
+            return false;
+        }
+
+        bool migrated = false;
+        QString error;
+        if (!StudentSchema::create(database, migrated, error)) {
+            log << "Failed to create tables: " << error << Qt::endl;
+            return false;
+        }
+        if (migrated) {
+            log << "Students table converted to the current format" << Qt::endl;
+        }
+
+        QSqlQuery query(database);
+        if (!StudentSchema::hasCountCache(query)) {
+            log << "Rebuilding count tables..." << Qt::endl;
+            if (!StudentSchema::rebuildCountCache(database)) {
+                log << "Failed to rebuild count tables" << Qt::endl;
+                return false;
+            }
+        }
+
+        // R树存在即内容完整；不存在时只在范围查询前建立，SQLite 未编译 rtree 模块时退回X坐标索引
+        if (StudentSchema::hasSpatialTable(query)) {
+            spatial = StudentSchema::createSpatialTriggers(query);
+        } else if (buildSpatial) {
+            log << "Building spatial index..." << Qt::endl;
+            spatial = StudentSchema::createSpatialIndex(database, error);
+            if (!spatial) {
+                log << "Spatial index unavailable, range queries use the X coordinate index: " << error << Qt::endl;
+            }
+        } else {
+            spatial = false;
+        }
+        return true;
+    }
+
+    int importCommand(const CliOptions& options, bool spatial, QTextStream& log)
+    {
+        const QString filePath = options.arguments.at(1);
+        QSqlDatabase database = ConnectionManager::instance().connection();
+        QString error;
+        if (options.replace && !StudentSchema::clear(database, spatial, error)) {
+            log << "Failed to clear students: " << error << Qt::endl;
+            return 1;
+        }
+
+        // 表为空时自动走批量导入（见 StudentImporter::importFile()）
+        QElapsedTimer timer;
+        timer.start();
+        const ImportResult result = StudentRepository::importFile(database, filePath);
+        const double seconds = elapsedSeconds(timer);
+        if (result.status == ImportResult::RebuildFailed) {
+            log << "Import finished, but rebuilding indexes failed: " << result.error << Qt::endl;
+            return 1;
+        }
+        if (result.status == ImportResult::InvalidFormat) {
+            log << "Import failed: invalid or corrupted snapshot: " << result.error << Qt::endl;
+            return 1;
+        }
+        if (result.status != ImportResult::Ok) {
+            log << "Import failed: " << result.error << Qt::endl;
+            return 1;
+        }
+
+        Report report;
+        report.command = "import";
+        report.rows = result.successCount;
+        report.failedRows = result.failCount;
+        report.bytes = QFileInfo(filePath).size();
+        report.seconds = seconds;
+        printReport(report, options.json);
+        return 0;
+    }
+
+    int exportCommand(const CliOptions& options, QTextStream& log)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        const ExportResult result = StudentRepository::exportFile(options.arguments.at(1));
+        const double seconds = elapsedSeconds(timer);
+        if (result.status != ExportResult::Ok) {
+            log << "Export failed: " << result.error << Qt::endl;
+            return 1;
+        }
+        if (result.mixedSnapshot) {
+            log << "Warning: the database changed during export; the file may mix old and new data" << Qt::endl;
+        }
+
+        Report report;
+        report.command = "export";
+        report.rows = result.recordCount;
+        report.bytes = result.bytesWritten;
+        report.seconds = seconds;
+        printReport(report, options.json);
+        return 0;
+    }
+
+    /**
+     * @brief 把 query 命令的参数转换为查询形状（nearest 先求出第k近的距离）
+     * @return 参数错误时返回false，error 为空；查询失败时返回false，error 为错误信息
+     */
+    bool buildQuery(const CliOptions& options, bool spatial, StudentRepository::Query& query, QString& error)
+    {
+        const QStringList& args = options.arguments;
+        const QString kind = args.value(1);
+        QVector<int> v;
+
+        if (kind == "name" && args.size() == 3) {
+            query = {"name", args.at(2), "studentID", false};
+        } else if (kind == "x" && parseIntegers(args, 2, 1, 1, v)) {
+            query = {"addressCoordX", v[0], "studentID", false};
+        } else if (kind == "box" && parseIntegers(args, 2, 4, 4, v)) {
+            query = StudentRepository::Query::box(std::min(v[0], v[2]), std::min(v[1], v[3]),
+                                                  std::max(v[0], v[2]), std::max(v[1], v[3]), spatial);
+        } else if (kind == "radius" && parseIntegers(args, 2, 3, 2, v) && v[2] >= 0) {
+            query = StudentRepository::Query::circle(v[0], v[1], qint64(v[2]) * v[2], 0, spatial);
+        } else if (kind == "nearest" && parseIntegers(args, 2, 3, 2, v) && v[2] > 0) {
+            qint64 radius2 = -1;
+            if (!StudentRepository::nearestRadius2(v[0], v[1], v[2], spatial, radius2, error)) {
+                return false;
+            }
+            // 没有任何学生时半径为 -1，圆形范围为空
+            query = StudentRepository::Query::circle(v[0], v[1], radius2, v[2], spatial);
+            return true;
+        } else {
+            return false;
+        }
+
+        if (options.limit > 0) {
+            query.maxRows = options.limit;
+        }
+        return true;
+    }
+
+    int queryCommand(const CliOptions& options, bool spatial, QTextStream& log)
+    {
+        const QStringList& args = options.arguments;
+        RowWriter writer;
+        QString error;
+        QElapsedTimer timer;
+        timer.start();
+
+        bool success = true;
+        if (args.value(1) == "id") {
+            if (args.size() < 3) {
+                log << "Usage: query id <studentID>..." << Qt::endl;
+                return 2;
+            }
+            QVector<Student> rows;
+            success = StudentRepository::getByIds(args.mid(2), rows, error) && writer.write(rows);
+        } else {
+            StudentRepository::Query query{QString(), QVariant(), "studentID", false};
+            if (!buildQuery(options, spatial, query, error)) {
+                if (error.isEmpty()) {
+                    log << "Usage: query name <name> | x <X> | box <X1> <Y1> <X2> <Y2> | "
+                           "radius <X> <Y> <R> | nearest <X> <Y> <K>" << Qt::endl
+                        << "Coordinates must be between " << -StudentRepository::CoordLimit
+                        << " and " << StudentRepository::CoordLimit << Qt::endl;
+                    return 2;
+                }
+                success = false;
+            } else {
+                // 逐页读取并写出，内存中只有一页结果
+                success = StudentRepository::scan(query, ScanPageRows, [&writer](const QVector<Student>& page) {
+                    return writer.write(page);
+                }, error);
+            }
+        }
+        const bool written = writer.finish();
+        const double seconds = elapsedSeconds(timer);
+
+        if (!success) {
+            log << "Query failed: " << error << Qt::endl;
+            return 1;
+        }
+        if (!written) {
+            log << "Failed to write results: " << writer.errorString() << Qt::endl;
+            return 1;
+        }
+
+        Report report;
+        report.command = "query " + args.value(1);
+        report.rows = writer.rows();
+        report.bytes = writer.bytes();
+        report.seconds = seconds;
+        printReport(report, options.json);
+        return 0;
+    }
+
+    int statsCommand(const CliOptions& options, QTextStream& log)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        StudentRepository::Statistics statistics;
+        QString error;
+        if (!StudentRepository::statistics(statistics, error)) {
+            log << "Failed to read statistics: " << error << Qt::endl;
+            return 1;
+        }
+        const double seconds = elapsedSeconds(timer);
+
+        QTextStream out(stdout);
+        const QString oldest = statistics.oldestBirthDate.toString("yyyy-MM-dd");
+        const QString youngest = statistics.youngestBirthDate.toString("yyyy-MM-dd");
+        if (options.json) {
+            QJsonObject object;
+            object["database"] = options.databasePath;
+            object["students"] = statistics.students;
+            object["distinct_names"] = statistics.distinctNames;
+            object["distinct_coord_x"] = statistics.distinctCoordX;
+            object["dictionary_strings"] = statistics.dictionaryStrings;
+            object["oldest_birth_date"] = oldest;
+            object["youngest_birth_date"] = youngest;
+            object["database_bytes"] = statistics.databaseBytes;
+            object["counts_cached"] = statistics.countsCached;
+            object["spatial_index"] = statistics.spatialIndex;
+            out << QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact)) << Qt::endl;
+        } else {
+            out << "Database:           " << options.databasePath << '\n'
+                << "Students:           " << statistics.students << '\n'
+                << "Distinct names:     " << statistics.distinctNames << '\n'
+                << "Distinct X:         " << statistics.distinctCoordX << '\n'
+                << "Dictionary strings: " << statistics.dictionaryStrings << '\n'
+                << "Birth dates:        " << (oldest.isEmpty() ? QString("-") : oldest + " .. " + youngest) << '\n'
+                << "Database size:      " << mebibytes(statistics.databaseBytes) << '\n'
+                << "Count tables:       " << (statistics.countsCached ? "yes" : "no") << '\n'
+                << "Spatial index:      " << (statistics.spatialIndex ? "yes" : "no") << Qt::endl;
+        }
+
+        Report report;
+        report.command = "stats";
+        report.seconds = seconds;
+        printReport(report, options.json);
+        return 0;
+    }
+}
+
+int runCli(const CliOptions& options)
+{
+    QTextStream log(stderr);
+    const QString command = options.arguments.value(0);
+    const int argc = options.arguments.size();
+
+    const bool valid = (command == "import" && argc == 2)
+                       || (command == "export" && argc == 2)
+                       || (command == "query" && argc >= 3)
+                       || (command == "stats" && argc == 1);
+    if (!valid) {
+        log << "Usage: StudentCli [options] import <file> | export <file> | query <kind> <args>... | stats" << Qt::endl
+            << "Run StudentCli --help for details." << Qt::endl;
+        return 2;
+    }
+
+    // 范围查询需要R树，其余命令不为此等待
+    const QString kind = options.arguments.value(1);
+    const bool buildSpatial = command == "query" && (kind == "box" || kind == "radius" || kind == "nearest");
+    bool spatial = false;
+    if (!openDatabase(options.databasePath, buildSpatial, spatial, log)) {
+        return 1;
+    }
+
+    if (command == "import") {
+        return importCommand(options, spatial, log);
+    }
+    if (command == "export") {
+        return exportCommand(options, log);
+    }
+    if (command == "query") {
+        return queryCommand(options, spatial, log);
+    }
+    return statsCommand(options, log);
+}
+
+qint64 peakResidentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return -1;
+    }
+    return qint64(counters.PeakWorkingSetSize);
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(Q_OS_DARWIN)
+    return qint64(usage.ru_maxrss);          // macOS 以字节为单位
+#else
+    return qint64(usage.ru_maxrss) * 1024;   // Linux 等以KiB为单位
+#endif
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,63 @@
+﻿/**
+ * @file       studentcli.h
+ * @brief      不依赖界面的命令行批处理：导入、导出、查询和统计
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *
+ * @par        使用方法:
+ *             StudentCli [--db students.db] [--json] [--limit N] [--replace] <命令> [参数]
+ *             - import <文件>                     导入文本或快照文件，--replace 时先清空表（走批量导入）
+ *             - export <文件>                     导出，扩展名为 .snap 时写二进制快照
+ *             - query id <学号>...                按学号查询（可给出多个）
+ *             - query name <姓名>                 按姓名查询，按学号排序
+ *             - query x <X>                       按X坐标查询，按学号排序
+ *             - query box <X1> <Y1> <X2> <Y2>     矩形范围内的学生，按学号排序
+ *             - query radius <X> <Y> <半径>       半径范围内的学生，由近到远
+ *             - query nearest <X> <Y> <K>         最近的K名学生
+ *             - stats                             记录数、字典和数据库大小等概况
+ *             选项必须写在命令之前，命令之后的参数（包括负坐标）都按位置参数处理；
+ *             --limit 限制 name/x/box/radius 查询输出的行数。
+ *             导入导出与界面的“从文件读取/保存到文件”使用同一条流水线（StudentRepository）。
+ *             查询结果按导入格式（每行: 学号,姓名,出生日期,性别,地址,X,Y）分页流式写到标准输出，
+ *             可直接重定向后再导入；运行报告（行数、耗时、行/秒、峰值常驻内存）写到标准错误，
+ *             --json 时报告和 stats 的输出为一行 JSON，便于无人值守的任务收集和比较。
+ */
+
+#ifndef STUDENTCLI_H
+#define STUDENTCLI_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @struct CliOptions
+ * @brief 命令行参数
+ */
+struct CliOptions
+{
+    QString databasePath = "students.db";  ///< 数据库文件（与界面程序的默认值相同）
+    QStringList arguments;                 ///< 命令及其参数
+    int limit = 0;                         ///< 查询最多输出的行数，0 表示不限
+    bool replace = false;                  ///< 导入前清空 students 表
+    bool json = false;                     ///< 报告以 JSON 输出
+};
+
+/**
+ * @brief 执行一条命令
+ * @return 0 表示成功，1 表示执行失败，2 表示参数错误
+ */
+int runCli(const CliOptions& options);
+
+/**
+ * @brief 本进程到目前为止的峰值常驻内存
+ * @return 字节数，平台不支持时返回 -1
+ */
+qint64 peakResidentBytes();
+
+#endif // STUDENTCLI_H
@@ -0,0 +1,170 @@
+﻿/**
+ * @file       studentdictionary.cpp
+ * @brief      低基数文本列字典编码的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "studentdictionary.h"
+#include "connectionmanager.h"
+
+#include <QDebug>
+#include <QReadLocker>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QWriteLocker>
+
+StudentDictionary& StudentDictionary::instance()
+{
+    static StudentDictionary dictionary;
+    return dictionary;
+}
+
+bool StudentDictionary::createTable(QSqlQuery &query)
+{
+    return query.exec("CREATE TABLE IF NOT EXISTS student_strings ("
+                      "id INTEGER PRIMARY KEY,"
+                      "text TEXT NOT NULL UNIQUE"
+                      ");");
+}
+
+bool StudentDictionary::migrateStudentsTable(QSqlDatabase &database, bool &migrated)
+{
+    migrated = false;
+
+    // 新格式的 gender 列声明为 INTEGER
+    QSqlQuery query(database);
+    if (!query.exec("SELECT type FROM pragma_table_info('students') WHERE name = 'gender'")) {
+        qWarning() << "Failed to inspect students table:" << query.lastError().text();
+        return false;
+    }
+    if (!query.next() || query.value(0).toString().compare("TEXT", Qt::CaseInsensitive) != 0) {
+        return true; // 表不存在或已是新格式
+    }
+    query.finish();
+
+    if (!database.transaction()) {
+        return false;
+    }
+    const bool success =
+        query.exec("INSERT OR IGNORE INTO student_strings (text) "
+                   "SELECT gender FROM students UNION SELECT addressName FROM students;")
+        && query.exec("CREATE TABLE students_encoded ("
+                      "studentID TEXT PRIMARY KEY NOT NULL,"
+                      "name TEXT NOT NULL,"
+                      "birthDate TEXT NOT NULL,"
+                      "gender INTEGER NOT NULL,"
+                      "addressName INTEGER NOT NULL,"
+                      "addressCoordX INTEGER NOT NULL,"
+                      "addressCoordY INTEGER NOT NULL"
+                      ");")
+        && query.exec("INSERT INTO students_encoded "
+                      "(rowid, studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY) "
+                      "SELECT s.rowid, s.studentID, s.name, s.birthDate, g.id, a.id, s.addressCoordX, s.addressCoordY "
+                      "FROM students AS s "
+                      "JOIN student_strings AS g ON g.text = s.gender "
+                      "JOIN student_strings AS a ON a.text = s.addressName;")
+        && query.exec("DROP TABLE students;")
+        && query.exec("ALTER TABLE students_encoded RENAME TO students;");
+    if (!success) {
+        qWarning() << "Failed to encode students table:" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+    if (!database.commit()) {
+        return false;
+    }
+    migrated = true;
+    return true;
+}
+
+QString StudentDictionary::text(int id)
+{
+    {
+        QReadLocker locker(&lock);
+        if (id > 0 && id < texts.size()) {
+            return texts.at(id);
+        }
+        if (id <= 0 || id <= loadedMaxID) {
+            return QString(); // 不存在的编号
+        }
+    }
+
+    // 其他连接新提交的字典项
+    if (!loadNewEntries()) {
+        return QString();
+    }
+    QReadLocker locker(&lock);
+    return id < texts.size() ? texts.at(id) : QString();
+}
+
+bool StudentDictionary::loadNewEntries()
+{
+    QWriteLocker locker(&lock);
+    QSqlQuery &query = ConnectionManager::instance().statement(
+        "SELECT id, text FROM student_strings WHERE id > ? ORDER BY id");
+    query.bindValue(0, loadedMaxID);
+    if (!query.exec()) {
+        qWarning() << "Failed to load string dictionary:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        if (id >= texts.size()) {
+            texts.resize(id + 1);
+        }
+        texts[id] = query.value(1).toString();
+        loadedMaxID = id;
+    }
+    query.finish();
+    return true;
+}
+
+StudentDictionary::Encoder::Encoder(QSqlDatabase &database)
+    : insertQuery(database), selectQuery(database)
+{
+    insertQuery.prepare("INSERT OR IGNORE INTO student_strings (text) VALUES (?)");
+    selectQuery.prepare("SELECT id FROM student_strings WHERE text = ?");
+}
+
+bool StudentDictionary::Encoder::encode(const QString &text, int &id)
+{
+    auto it = ids.constFind(text);
+    if (it != ids.constEnd()) {
+        id = it.value();
+        return true;
+    }
+
+    insertQuery.bindValue(0, text);
+    if (!insertQuery.exec()) {
+        error = insertQuery.lastError().text();
+        return false;
+    }
+    selectQuery.bindValue(0, text);
+    if (!selectQuery.exec() || !selectQuery.next()) {
+        error = selectQuery.lastError().text();
+        return false;
+    }
+    id = selectQuery.value(0).toInt();
+    selectQuery.finish();
+    ids.insert(text, id);
+    return true;
+}
+
+bool StudentDictionary::Encoder::encodeColumn(QVariantList &column)
+{
+    for (QVariant &value : column) {
+        int id;
+        if (!encode(value.toString(), id)) {
+            return false;
+        }
+        value = id;
+    }
+    return true;
+}
@@ -0,0 +1,122 @@
+﻿/**
+ * @file       studentdictionary.h
+ * @brief      低基数文本列（性别、地址名）的字典编码
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，students 表的性别和地址名改为存 student_strings 的编号]
+ *
+ * @par        设计说明:
+ *             generate_data.py 生成的百万行数据只有2种性别、8个地址，原表每行都保存完整的
+ *             UTF-8 文本。现在不同的文本只在 student_strings (id, text) 中保存一次，students 的
+ *             gender / addressName 列保存其 id（SQLite 中1字节的整数）。
+ *
+ *             - 解码: StudentDictionary 是进程内唯一的 id -> 文本缓存，读取记录的线程直接查数组；
+ *               遇到未知的 id（其他连接刚提交的新文本）时从本线程的连接增量加载。字典只增不减，
+ *               因此缓存永远不会过期，解码出的同一文本在所有记录中共用一个 QString。
+ *             - 编码: 写入者使用自己的 Encoder，在写入连接（和它的事务）中分配新 id，并在本地
+ *               缓存文本 -> id。新 id 在事务提交前对其他连接不可见，也不会进入共享缓存，
+ *               事务回滚不会留下错误的缓存项。
+ *
+ *             只编码性别和地址名，姓名保持文本: 按姓名排序和键集翻页依赖 (name, studentID) 索引的
+ *             文本顺序，按插入顺序分配的编号没有这种顺序。因此按姓名查询仍是该索引上的文本比较，
+ *             字典编码只减小性别和地址名两列的存储，不改变按姓名查询的速度。
+ */
+
+#ifndef STUDENTDICTIONARY_H
+#define STUDENTDICTIONARY_H
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariantList>
+#include <QVector>
+
+class QSqlDatabase;
+
+/**
+ * @class StudentDictionary
+ * @brief student_strings 表的进程内缓存（id -> 文本）
+ */
+class StudentDictionary
+{
+public:
+    static StudentDictionary& instance();
+
+    /**
+     * @brief 创建 student_strings 表
+     */
+    static bool createTable(QSqlQuery& query);
+
+    /**
+     * @brief 把旧版本中以文本保存性别和地址名的 students 表改写为编号（一次性，在一个事务中完成）
+     * @param[out] migrated 是否执行了改写（表已是新格式时为false）
+     * @return 成功或无需改写返回true
+     * @note 保留原有的 rowid，R树等以 rowid 引用记录的结构不需要重建；
+     *       旧表的索引和触发器随旧表一起删除，由调用者重新创建
+     */
+    static bool migrateStudentsTable(QSqlDatabase& database, bool& migrated);
+
+    /**
+     * @brief 解码一个编号
+     * @return 对应的文本；编号不存在时返回空字符串
+     * @note 线程安全；未知编号时在调用线程的连接上加载新增的字典项
+     */
+    QString text(int id);
+
+    /**
+     * @brief 解码查询结果中的一列编号
+     */
+    QString text(const QVariant& id)
+    {
+        return text(id.toInt());
+    }
+
+    /**
+     * @class Encoder
+     * @brief 写入者使用的编码器（文本 -> 编号），只在一个连接和线程中使用
+     */
+    class Encoder
+    {
+    public:
+        explicit Encoder(QSqlDatabase& database);
+
+        /**
+         * @brief 取得文本的编号，不存在时在 database 上插入
+         * @return 失败返回false，错误信息见 lastError()
+         */
+        bool encode(const QString& text, int& id);
+
+        /**
+         * @brief 把一列文本原地替换为编号（用于 execBatch）
+         */
+        bool encodeColumn(QVariantList& column);
+
+        QString lastError() const { return error; }
+
+    private:
+        QSqlQuery insertQuery;
+        QSqlQuery selectQuery;
+        QHash<QString, int> ids;
+        QString error;
+    };
+
+private:
+    StudentDictionary() = default;
+
+    StudentDictionary(const StudentDictionary&) = delete;
+    StudentDictionary& operator=(const StudentDictionary&) = delete;
+
+    bool loadNewEntries();
+
+    QReadWriteLock lock;
+    QVector<QString> texts;   ///< 下标为 id，不存在的 id 为空字符串
+    int loadedMaxID = 0;      ///< 已加载的最大 id
+};
+
+#endif // STUDENTDICTIONARY_H
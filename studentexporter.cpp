@@ -0,0 +1,288 @@
+﻿/**
+ * @file       studentexporter.cpp
+ * @brief      学生数据导出流水线的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [导出前后比较 data_version，检测并发写入]
+ */
+
+#include "studentexporter.h"
+#include "boundedqueue.h"
+#include "connectionmanager.h"
+#include "studentdictionary.h"
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QSemaphore>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
+namespace
+{
+    /**
+     * @brief 划分线程交给格式化线程的学号区间 (after, last]
+     */
+    struct KeyRange
+    {
+        qint64 sequence = 0;
+        bool hasAfter = false;   ///< 为false时从第一条记录开始
+        QString after;
+        bool hasLast = false;    ///< 为false时一直读到最后一条记录
+        QString last;
+    };
+
+    /**
+     * @brief 格式化线程交给写入线程的一段输出
+     */
+    struct FormattedChunk
+    {
+        qint64 sequence = 0;
+        QByteArray bytes;
+        qint64 rows = 0;
+        QString error;           ///< 非空表示读取失败
+    };
+
+    /**
+     * @brief 当前线程连接看到的 data_version，其他连接每提交一次写入该值就会变化
+     * @return 读取失败时返回 -1
+     */
+    qint64 dataVersion()
+    {
+        QSqlQuery &query = ConnectionManager::instance().statement("PRAGMA data_version");
+        if (!query.exec() || !query.next()) {
+            return -1;
+        }
+        const qint64 version = query.value(0).toLongLong();
+        query.finish();
+        return version;
+    }
+
+    /**
+     * @brief 读取一个区间并格式化为 UTF-8 文本
+     * @param[in,out] textCache 字典编号 -> UTF-8 字节，每个格式化线程一份
+     */
+    void formatRange(const KeyRange& range, FormattedChunk& chunk, QHash<int, QByteArray>& textCache)
+    {
+        QString sql = "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
+                      "FROM students";
+        if (range.hasAfter && range.hasLast) {
+            sql += " WHERE studentID > ? AND studentID <= ?";
+        } else if (range.hasAfter) {
+            sql += " WHERE studentID > ?";
+        } else if (range.hasLast) {
+            sql += " WHERE studentID <= ?";
+        }
+        sql += " ORDER BY studentID";
+
+        // 只向前读取，SQLite 驱动不缓存已读过的行
+        QSqlQuery &query = ConnectionManager::instance().statement(sql);
+        if (!query.isForwardOnly()) {
+            query.setForwardOnly(true);
+        }
+        int bindIndex = 0;
+        if (range.hasAfter) {
+            query.bindValue(bindIndex++, range.after);
+        }
+        if (range.hasLast) {
+            query.bindValue(bindIndex++, range.last);
+        }
+        if (!query.exec()) {
+            chunk.error = query.lastError().text();
+            return;
+        }
+
+        auto appendText = [&](int id) {
+            auto it = textCache.constFind(id);
+            if (it == textCache.constEnd()) {
+                it = textCache.insert(id, StudentDictionary::instance().text(id).toUtf8());
+            }
+            chunk.bytes.append(it.value());
+        };
+
+        // 每行约50字节，预留空间避免缓冲区反复扩容
+        chunk.bytes.reserve(StudentExporter::ChunkRows * 64);
+        while (query.next()) {
+            chunk.bytes.append(query.value(0).toString().toUtf8());
+            chunk.bytes.append(',');
+            chunk.bytes.append(query.value(1).toString().toUtf8());
+            chunk.bytes.append(',');
+            chunk.bytes.append(query.value(2).toString().toLatin1()); // 库中存为 yyyy-MM-dd 文本
+            chunk.bytes.append(',');
+            appendText(query.value(3).toInt());
+            chunk.bytes.append(',');
+            appendText(query.value(4).toInt());
+            chunk.bytes.append(',');
+            StudentExporter::appendInt(chunk.bytes, query.value(5).toLongLong());
+            chunk.bytes.append(',');
+            StudentExporter::appendInt(chunk.bytes, query.value(6).toLongLong());
+            chunk.bytes.append('\n');
+            ++chunk.rows;
+        }
+        query.finish();
+    }
+}
+
+StudentExporter::StudentExporter(int formatterThreads)
+    : formatters(formatterThreads)
+{
+    // 划分线程和写入线程各占一个核
+    if (formatters <= 0) {
+        formatters = std::max(1, QThread::idealThreadCount() - 2);
+    }
+}
+
+void StudentExporter::appendInt(QByteArray &out, qint64 value)
+{
+    char buffer[24];
+    char *end = buffer + sizeof(buffer);
+    char *position = end;
+    quint64 magnitude = value < 0 ? 0 - quint64(value) : quint64(value);
+    do {
+        *--position = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        *--position = '-';
+    }
+    out.append(position, int(end - position));
+}
+
+ExportResult StudentExporter::run(const QString &filePath)
+{
+    ExportResult result;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        result.status = ExportResult::FileOpenFailed;
+        result.error = file.errorString();
+        return result;
+    }
+
+    // 各区间分别在格式化线程的连接上读取，用导出前后的 data_version 发现期间的写入
+    const qint64 versionBefore = dataVersion();
+
+    // 在途区间数上限: 划分线程每产生一个区间占用一个名额，写入线程写完一段后归还
+    const int maxInFlight = 2 * formatters + 2;
+    QSemaphore inFlight(maxInFlight);
+    BoundedQueue<KeyRange> rangeQueue(maxInFlight);
+    BoundedQueue<FormattedChunk> chunkQueue(maxInFlight);
+    QAtomicInt activeFormatters(formatters);
+    QString splitError;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(formatters + 1);
+
+    // --- 1. 划分线程: 在学号唯一索引上每隔 ChunkRows 行取一个边界 ---
+    (void)QtConcurrent::run(&pool, [&]() {
+        KeyRange range;
+        ConnectionManager &connections = ConnectionManager::instance();
+        for (;;) {
+            QSqlQuery &boundary = range.hasAfter
+                ? connections.statement("SELECT studentID FROM students WHERE studentID > ? "
+                                        "ORDER BY studentID LIMIT 1 OFFSET ?")
+                : connections.statement("SELECT studentID FROM students ORDER BY studentID LIMIT 1 OFFSET ?");
+            int bindIndex = 0;
+            if (range.hasAfter) {
+                boundary.bindValue(bindIndex++, range.after);
+            }
+            boundary.bindValue(bindIndex++, ChunkRows - 1);
+            if (!boundary.exec()) {
+                splitError = boundary.lastError().text();
+                break;
+            }
+
+            range.hasLast = boundary.next();
+            range.last = range.hasLast ? boundary.value(0).toString() : QString();
+            boundary.finish();
+
+            inFlight.acquire();
+            rangeQueue.push(range);
+            if (!range.hasLast) {
+                break; // 最后一个区间读到表尾
+            }
+            range.sequence++;
+            range.hasAfter = true;
+            range.after = range.last;
+        }
+        rangeQueue.close();
+    });
+
+    // --- 2. 格式化线程: 区间 -> UTF-8 字节缓冲区 ---
+    for (int i = 0; i < formatters; ++i) {
+        (void)QtConcurrent::run(&pool, [&]() {
+            QHash<int, QByteArray> textCache;
+            KeyRange range;
+            while (rangeQueue.pop(range)) {
+                FormattedChunk chunk;
+                chunk.sequence = range.sequence;
+                formatRange(range, chunk, textCache);
+                chunkQueue.push(std::move(chunk));
+            }
+            // 最后一个退出的格式化线程关闭输出队列
+            if (!activeFormatters.deref()) {
+                chunkQueue.close();
+            }
+        });
+    }
+
+    // --- 3. 写入（当前线程）: 按区间顺序整块写入 ---
+    // 出错后继续取完队列并归还名额，让其他线程正常结束
+    QMap<qint64, FormattedChunk> outOfOrder;
+    qint64 nextSequence = 0;
+    FormattedChunk chunk;
+    while (chunkQueue.pop(chunk)) {
+        outOfOrder.insert(chunk.sequence, std::move(chunk));
+        for (auto it = outOfOrder.find(nextSequence); it != outOfOrder.end(); it = outOfOrder.find(nextSequence)) {
+            const FormattedChunk &ready = it.value();
+            if (result.status == ExportResult::Ok) {
+                if (!ready.error.isEmpty()) {
+                    result.status = ExportResult::QueryFailed;
+                    result.error = ready.error;
+                } else if (file.write(ready.bytes) != ready.bytes.size()) {
+                    result.status = ExportResult::WriteFailed;
+                    result.error = file.errorString();
+                } else {
+                    result.recordCount += ready.rows;
+                    result.bytesWritten += ready.bytes.size();
+                }
+            }
+            outOfOrder.erase(it);
+            ++nextSequence;
+            inFlight.release();
+        }
+    }
+    pool.waitForDone();
+
+    const qint64 versionAfter = dataVersion();
+    result.mixedSnapshot = versionBefore >= 0 && versionAfter != versionBefore;
+
+    if (result.status == ExportResult::Ok && !splitError.isEmpty()) {
+        result.status = ExportResult::QueryFailed;
+        result.error = splitError;
+    }
+    if (!file.flush() && result.status == ExportResult::Ok) {
+        result.status = ExportResult::WriteFailed;
+        result.error = file.errorString();
+    }
+    file.close();
+    if (result.status != ExportResult::Ok) {
+        qWarning() << "Export failed:" << result.error;
+    } else if (result.mixedSnapshot) {
+        qWarning() << "Export finished while other connections were writing; chunks may come from different snapshots";
+    }
+    return result;
+}
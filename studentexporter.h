@@ -0,0 +1,95 @@
+﻿/**
+ * @file       studentexporter.h
+ * @brief      学生数据导出为文本文件的多线程流水线
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，将导出拆分为划分/格式化/写入三级流水线]
+ *             V1.1:[lzq] [2026-10-17] [说明各区间的读快照，增加 mixedSnapshot 检测]
+ *
+ * @par        设计说明:
+ *             与导入流水线（studentimporter.h）对称:
+ *             - 划分线程按学号把表切成每段 ChunkRows 行的区间，区间边界用
+ *               "WHERE studentID > ? ORDER BY studentID LIMIT 1 OFFSET ?" 在学号唯一索引上跳过，
+ *               行数据不经过 Qt；
+ *             - N个格式化线程各用自己的连接（ConnectionManager 按线程提供）读取一个区间，
+ *               直接拼成 UTF-8 字节缓冲区: 整数手工转换，日期按库中的文本原样复制，
+ *               性别和地址名按字典编号缓存其 UTF-8 字节，不再经过 QTextStream；
+ *             - 调用 run() 的线程按区间顺序把缓冲区整块写入文件。
+ *             各级之间用有界队列连接，并用信号量限制在途区间数，内存占用不随表大小增长。
+ *             输出格式与导入格式相同（每行: 学号,姓名,出生日期,性别,地址,X,Y），行尾为 '\n'。
+ *
+ * @par        一致性:
+ *             区间按学号首尾相接，不会重复或遗漏"导出期间没有变化"的记录；但每个区间
+ *             在各自格式化线程的连接上单独读取（各自一个隐式读事务），不共享同一快照。
+ *             导出期间若有其他连接提交写入，文件中不同区间可能反映不同时刻的数据。
+ *             run() 在导出前后比较 PRAGMA data_version，发现有写入提交时置
+ *             ExportResult::mixedSnapshot，由调用方决定是否重新导出。
+ *             GUI 在导出期间禁用主窗口，不会与导出并发写入。
+ */
+
+#ifndef STUDENTEXPORTER_H
+#define STUDENTEXPORTER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @struct ExportResult
+ * @brief 一次导出的结果
+ */
+struct ExportResult
+{
+    enum Status
+    {
+        Ok,              ///< 导出完成
+        FileOpenFailed,  ///< 无法创建输出文件
+        QueryFailed,     ///< 读取数据库失败
+        WriteFailed      ///< 写入文件失败（如磁盘已满）
+    };
+
+    Status status = Ok;
+    qint64 recordCount = 0;
+    qint64 bytesWritten = 0;
+    QString error;
+    bool mixedSnapshot = false;  ///< 导出期间有其他连接提交了写入，各区间可能读自不同时刻的数据
+};
+
+/**
+ * @class StudentExporter
+ * @brief 划分 → 并行读取和格式化 → 顺序写入 的导出流水线
+ */
+class StudentExporter
+{
+public:
+    /**
+     * @param[in] formatterThreads 格式化线程数，<=0 时按CPU核数自动选择
+     */
+    explicit StudentExporter(int formatterThreads = 0);
+
+    /**
+     * @brief 把 students 表按学号顺序导出到文件
+     * @param[in] filePath 输出文件路径，已存在时覆盖
+     * @return 导出结果
+     * @note 所有数据库访问都在流水线自己的线程中进行，调用线程只负责写文件
+     */
+    ExportResult run(const QString& filePath);
+
+    int formatterThreadCount() const { return formatters; }
+
+    /**
+     * @brief 把整数的十进制文本追加到 out
+     */
+    static void appendInt(QByteArray& out, qint64 value);
+
+    static constexpr int ChunkRows = 16384;   ///< 每个区间的行数
+
+private:
+    int formatters;
+};
+
+#endif // STUDENTEXPORTER_H
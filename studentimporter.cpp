@@ -0,0 +1,524 @@
+﻿/**
+ * @file       studentimporter.cpp
+ * @brief      学生数据文件多线程导入流水线的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.10
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，实现读取/解析/写入三级流水线]
+ *             V1.1:[lzq] [2026-10-17] [改为内存映射读取，直接在UTF-8字节上解析字段]
+ *             V1.2:[lzq] [2026-10-17] [字段切分改用向量化分隔符扫描得到的结构索引]
+ *             V1.3:[lzq] [2026-10-17] [增加按学号排序的批量导入模式和 BulkLoadPragmas]
+ *             V1.4:[lzq] [2026-10-17] [写入前把性别和地址名换成字典编号]
+ *             V1.5:[lzq] [2026-10-17] [支持直接导入二进制快照文件，跳过文本解析]
+ *             V1.6:[lzq] [2026-10-17] [批量导入的索引/触发器处理从界面移入 importFile()]
+ *             V1.7:[lzq] [2026-10-17] [UPSERT 语句和批次写入改为公开的静态函数]
+ *             V1.8:[lzq] [2026-10-17] [快照无效或中途解码失败时整体回滚，返回 InvalidFormat]
+ *             V1.9:[lzq] [2026-10-17] [批量导入后的重建放在一个事务中，失败时返回 RebuildFailed]
+ *             V1.10:[lzq] [2026-10-17] [批量导入的排序行先拼成连续块再整块扫描]
+ */
+
+#include "studentimporter.h"
+#include "boundedqueue.h"
+#include "csvreader.h"
+#include "delimiterscanner.h"
+#include "studentdictionary.h"
+#include "studentschema.h"
+#include "studentsnapshot.h"
+
+#include <QAtomicInt>
+#include <QDate>
+#include <QDebug>
+#include <QMap>
+#include <QSemaphore>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief 批量导入时的行索引项: 去掉首尾空白的一行，以及其中学号的长度
+     */
+    struct SortedLine
+    {
+        ByteSpan line;
+        int keyLength = 0;
+    };
+
+    /**
+     * @brief 读取线程交给解析线程的数据块，指向映射区域，不复制数据
+     *
+     * 普通模式下是映射区域上的一段连续字节 [begin, end)；
+     * 批量导入模式下是排序后行索引中的一段 [lines, lines + lineCount)。
+     */
+    struct RawChunk
+    {
+        qint64 sequence = 0;
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        const SortedLine* lines = nullptr;
+        int lineCount = 0;
+    };
+
+    /**
+     * @brief 为 [begin, end) 中的每个非空行建立索引项，并按学号稳定排序
+     *
+     * 学号按字节比较，与SQLite对学号唯一索引的默认BINARY排序一致；稳定排序保证
+     * 重复学号按原顺序写入，UPSERT 后仍是文件中靠后的一行生效。
+     */
+    std::vector<SortedLine> sortLinesByStudentID(const char* begin, const char* end)
+    {
+        std::vector<SortedLine> lines;
+        const char* lineStart = begin;
+        while (lineStart < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', size_t(end - lineStart)));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+
+            SortedLine entry;
+            entry.line = ByteSpan(lineStart, lineEnd).trimmed();
+            lineStart = lineEnd + 1;
+            if (entry.line.isEmpty()) continue;
+
+            const char* comma = static_cast<const char*>(std::memchr(entry.line.data, ',', size_t(entry.line.size)));
+            entry.keyLength = ByteSpan(entry.line.begin(), comma ? comma : entry.line.end()).trimmed().size;
+            lines.push_back(entry);
+        }
+
+        auto keyLess = [](const SortedLine& a, const SortedLine& b) {
+            int common = std::min(a.keyLength, b.keyLength);
+            int order = std::memcmp(a.line.data, b.line.data, size_t(common));
+            return order != 0 ? order < 0 : a.keyLength < b.keyLength;
+        };
+        if (!std::is_sorted(lines.begin(), lines.end(), keyLess)) {
+            std::stable_sort(lines.begin(), lines.end(), keyLess);
+        }
+        return lines;
+    }
+
+    /**
+     * @brief 提交导入事务，失败时回滚并把所有记录计为失败
+     */
+    ImportResult& commitImport(QSqlDatabase& database, ImportResult& result)
+    {
+        if (!database.commit()) {
+            qWarning() << "Transaction commit failed:" << database.lastError().text();
+            result.failCount = result.successCount + result.failCount; // 提交失败，所有都算失败
+            result.successCount = 0;
+            result.error = database.lastError().text();
+            database.rollback();
+        }
+        return result;
+    }
+
+    /**
+     * @brief 批量导入后在一个事务中重建二级索引、计数缓存、R树及其触发器
+     *
+     * 失败时回滚，并把计数缓存和R树标记为不可用: 清空 students_total（hasCountCache() 为false），
+     * 删除 students_rtree（hasSpatialTable() 为false），下次打开数据库时重新统计、重新建立。
+     * 二级索引缺失只影响速度，StudentSchema::create() 会重新建立。
+     */
+    bool finishBulkLoad(QSqlDatabase& database, bool spatial, QString& error)
+    {
+        QSqlQuery ddl(database);
+        if (database.transaction()
+            && StudentSchema::createSecondaryIndexes(ddl)
+            && StudentSchema::recountCountCache(ddl)
+            && StudentSchema::createCountTriggers(ddl)
+            && (!spatial || (StudentSchema::rebuildSpatialIndex(ddl) && StudentSchema::createSpatialTriggers(ddl)))
+            && database.commit()) {
+            return true;
+        }
+
+        error = ddl.lastError().isValid() ? ddl.lastError().text() : database.lastError().text();
+        database.rollback();
+        if (!ddl.exec("DELETE FROM students_total;")
+            || (spatial && !ddl.exec("DROP TABLE IF EXISTS students_rtree;"))) {
+            qWarning() << "Failed to mark count cache / spatial index as stale:" << ddl.lastError().text();
+        }
+        return false;
+    }
+
+    /**
+     * @brief 把快照中的记录按保存顺序分批写入，不经过解析线程
+     * @return 快照结构无效或中途解码失败时返回false，调用者必须回滚事务（整个快照都不导入）
+     */
+    bool writeSnapshot(const char* begin, const char* end, QSqlQuery& query,
+                       StudentDictionary::Encoder& encoder, ImportResult& result)
+    {
+        StudentSnapshotReader reader;
+        if (!reader.open(begin, end)) {
+            result.error = reader.errorString();
+            return false;
+        }
+
+        // 快照按学号键有序保存，各列已是类型化的值，解码只是变长整数读取和字典查找
+        const int batchRows = 8192;
+        StudentColumnBatch batch;
+        Student student;
+        while (reader.next(student)) {
+            batch.append(student);
+            if (batch.size() == batchRows) {
+                StudentImporter::writeBatch(query, encoder, batch, result);
+                batch = StudentColumnBatch();
+            }
+        }
+        StudentImporter::writeBatch(query, encoder, batch, result);
+
+        if (reader.status() != StudentSnapshotReader::Ok) {
+            qWarning() << "Snapshot decoding stopped:" << reader.errorString();
+            result.successCount = 0;
+            result.failCount = int(reader.rowCount());
+            result.error = reader.errorString();
+            return false;
+        }
+        return true;
+    }
+}
+
+StudentImporter::StudentImporter(int parserThreads)
+    : parsers(parserThreads), bulkLoad(false)
+{
+    // 读取线程和写入线程各占一个核
+    if (parsers <= 0) {
+        parsers = std::max(1, QThread::idealThreadCount() - 2);
+    }
+}
+
+void StudentImporter::parseChunk(const char* begin, const char* end, StudentColumnBatch& batch)
+{
+    parseChunk(begin, end, batch, DelimiterScanner::bestKernel());
+}
+
+void StudentImporter::parseChunk(const char* begin, const char* end, StudentColumnBatch& batch,
+                                 DelimiterScanner::Kernel kernel)
+{
+    // 先一次性找出块内所有逗号和换行（结构索引），再按索引切分字段
+    thread_local std::vector<quint32> offsets;
+    const int delimiterCount = DelimiterScanner::scan(kernel, begin, end, offsets);
+
+    ByteSpan fields[7];
+    int fieldCount = 0;
+    const char* fieldStart = begin;
+    for (int i = 0; i <= delimiterCount; ++i) {
+        // 最后一项是块尾，相当于补一个换行符（文件末行可能没有换行）
+        const char* delimiter = (i < delimiterCount) ? begin + offsets[size_t(i)] : end;
+        if (delimiter == end && fieldStart == end && fieldCount == 0) {
+            break;
+        }
+
+        if (fieldCount < 7) {
+            fields[fieldCount] = ByteSpan(fieldStart, delimiter).trimmed();
+        }
+        fieldCount++;
+        fieldStart = delimiter + 1;
+        if (delimiter != end && *delimiter == ',') {
+            continue;
+        }
+
+        // 一行结束: 只含空白的行直接跳过，字段数不是7的行算作失败
+        const int lineFields = fieldCount;
+        fieldCount = 0;
+        if (lineFields == 1 && fields[0].isEmpty()) {
+            continue;
+        }
+        if (lineFields != 7) {
+            batch.failCount++;
+            continue;
+        }
+
+        QDate birthDate = fields[2].toDate();
+        if (fields[0].isEmpty() || !birthDate.isValid()) {
+            batch.failCount++;
+            continue;
+        }
+
+        // 只有需要存储的文本字段才解码为 QString
+        batch.studentIDs.append(fields[0].toString());
+        batch.names.append(fields[1].toString());
+        batch.birthDates.append(birthDate);
+        batch.genders.append(fields[3].toString());
+        batch.addressNames.append(fields[4].toString());
+        batch.coordXs.append(fields[5].toInt());
+        batch.coordYs.append(fields[6].toInt());
+    }
+}
+
+bool StudentImporter::prepareUpsert(QSqlQuery& query)
+{
+    // 使用 UPSERT 而不是 INSERT OR REPLACE: REPLACE 的隐式删除不会触发删除触发器，
+    // 会使计数缓存重复计数
+    return query.prepare("INSERT INTO students (studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY) "
+                         "VALUES (?, ?, ?, ?, ?, ?, ?) "
+                         "ON CONFLICT(studentID) DO UPDATE SET name = excluded.name, birthDate = excluded.birthDate, "
+                         "gender = excluded.gender, addressName = excluded.addressName, "
+                         "addressCoordX = excluded.addressCoordX, addressCoordY = excluded.addressCoordY");
+}
+
+void StudentImporter::writeBatch(QSqlQuery& query, StudentDictionary::Encoder& encoder, StudentColumnBatch& batch,
+                                 ImportResult& result)
+{
+    result.failCount += batch.failCount;
+    if (batch.size() == 0) {
+        return;
+    }
+
+    // 低基数列: 每个不同的文本只在第一次出现时访问 student_strings，其余都是本地哈希查找
+    if (!encoder.encodeColumn(batch.genders) || !encoder.encodeColumn(batch.addressNames)) {
+        qWarning() << "String dictionary update failed:" << encoder.lastError();
+        result.failCount += batch.size();
+        return;
+    }
+
+    query.addBindValue(batch.studentIDs);
+    query.addBindValue(batch.names);
+    query.addBindValue(batch.birthDates);
+    query.addBindValue(batch.genders);
+    query.addBindValue(batch.addressNames);
+    query.addBindValue(batch.coordXs);
+    query.addBindValue(batch.coordYs);
+
+    if (!query.execBatch()) {
+        qWarning() << "Batch insert failed:" << query.lastError().text();
+        result.failCount += batch.size(); // 这批全都算失败
+    } else {
+        result.successCount += batch.size();
+    }
+}
+
+ImportResult StudentImporter::run(QSqlDatabase& database, const QString& filePath)
+{
+    ImportResult result;
+
+    MappedFile file;
+    if (!file.open(filePath)) {
+        result.status = ImportResult::FileOpenFailed;
+        result.error = file.errorString();
+        return result;
+    }
+
+    if (!database.transaction()) {
+        result.status = ImportResult::TransactionFailed;
+        result.error = database.lastError().text();
+        return result;
+    }
+
+    QSqlQuery query(database);
+    prepareUpsert(query);
+    StudentDictionary::Encoder encoder(database);
+
+    // 快照文件: 不需要切块和解析，直接在映射区域上解码写入
+    if (StudentSnapshotReader::isSnapshot(file.begin(), file.end())) {
+        if (!writeSnapshot(file.begin(), file.end(), query, encoder, result)) {
+            database.rollback();
+            result.status = ImportResult::InvalidFormat;
+            return result;
+        }
+        file.close();
+        return commitImport(database, result);
+    }
+
+    // 在途块数上限: 读取线程每读一块占用一个名额，写入线程写完一块后归还。
+    // 两个队列的容量都不小于该上限，因此只有读取线程会因背压而阻塞
+    const int maxInFlight = 2 * parsers + 2;
+    QSemaphore inFlight(maxInFlight);
+    BoundedQueue<RawChunk> chunkQueue(maxInFlight);
+    BoundedQueue<StudentColumnBatch> batchQueue(maxInFlight);
+    QAtomicInt activeParsers(parsers);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(parsers + 1);
+
+    // 批量导入: 先按学号排序行索引，之后按排序后的顺序切块
+    std::vector<SortedLine> sortedLines;
+    if (bulkLoad) {
+        sortedLines = sortLinesByStudentID(file.begin(), file.end());
+    }
+
+    // --- 1. 读取线程: 在映射区域（或排序后的行索引）上按行边界切块 ---
+    (void)QtConcurrent::run(&pool, [&]() {
+        qint64 sequence = 0;
+        if (bulkLoad) {
+            size_t index = 0;
+            while (index < sortedLines.size()) {
+                RawChunk chunk;
+                chunk.sequence = sequence++;
+                chunk.lines = sortedLines.data() + index;
+                int bytes = 0;
+                while (index < sortedLines.size() && bytes < ChunkBytes) {
+                    bytes += sortedLines[index].line.size + 1;
+                    ++chunk.lineCount;
+                    ++index;
+                }
+
+                inFlight.acquire();
+                chunkQueue.push(chunk);
+            }
+            chunkQueue.close();
+            return;
+        }
+
+        const char* position = file.begin();
+        const char* end = file.end();
+        while (position < end) {
+            const char* cut = position + std::min<qint64>(ChunkBytes, end - position);
+            if (cut < end) {
+                // 延伸到下一个换行符之后，保证块内都是完整的行
+                const char* newline = static_cast<const char*>(std::memchr(cut, '\n', size_t(end - cut)));
+                cut = newline ? newline + 1 : end;
+            }
+
+            RawChunk chunk;
+            chunk.sequence = sequence++;
+            chunk.begin = position;
+            chunk.end = cut;
+            position = cut;
+
+            inFlight.acquire();
+            chunkQueue.push(chunk);
+        }
+        chunkQueue.close();
+    });
+
+    // --- 2. 解析线程: 块 -> 按列组织的批次 ---
+    for (int i = 0; i < parsers; ++i) {
+        (void)QtConcurrent::run(&pool, [&]() {
+            RawChunk chunk;
+            std::string gathered;  // 批量导入: 排序后的行拼成的连续块，每个解析线程复用一个缓冲区
+            while (chunkQueue.pop(chunk)) {
+                StudentColumnBatch batch;
+                batch.sequence = chunk.sequence;
+                if (chunk.lines) {
+                    // 排序后的行在映射区域中不相邻，先拷贝成一个连续块，
+                    // 分隔符扫描才能像普通模式一样整块进行，而不是每行启动一次
+                    gathered.clear();
+                    for (int i = 0; i < chunk.lineCount; ++i) {
+                        gathered.append(chunk.lines[i].line.data, size_t(chunk.lines[i].line.size));
+                        gathered.push_back('\n');
+                    }
+                    parseChunk(gathered.data(), gathered.data() + gathered.size(), batch);
+                } else {
+                    parseChunk(chunk.begin, chunk.end, batch);
+                }
+                batchQueue.push(std::move(batch));
+            }
+            // 最后一个退出的解析线程关闭批次队列
+            if (!activeParsers.deref()) {
+                batchQueue.close();
+            }
+        });
+    }
+
+    // --- 3. 写入（当前线程）: 按块序号顺序写入 ---
+    QMap<qint64, StudentColumnBatch> outOfOrder;
+    qint64 nextSequence = 0;
+    StudentColumnBatch batch;
+    while (batchQueue.pop(batch)) {
+        outOfOrder.insert(batch.sequence, std::move(batch));
+        for (auto it = outOfOrder.find(nextSequence); it != outOfOrder.end(); it = outOfOrder.find(nextSequence)) {
+            writeBatch(query, encoder, it.value(), result);
+            outOfOrder.erase(it);
+            ++nextSequence;
+            inFlight.release();
+        }
+    }
+    pool.waitForDone();
+    file.close();
+
+    return commitImport(database, result);
+}
+
+ImportResult StudentImporter::importFile(QSqlDatabase& database, const QString& filePath)
+{
+    bool bulkLoad = false;
+    {
+        QSqlQuery probe(database);
+        bulkLoad = probe.exec("SELECT 1 FROM students LIMIT 1") && !probe.next();
+    }
+
+    std::unique_ptr<BulkLoadPragmas> pragmas;
+    bool spatial = false;
+    if (bulkLoad) {
+        pragmas.reset(new BulkLoadPragmas(database));
+        QSqlQuery ddl(database);
+        spatial = StudentSchema::hasSpatialTable(ddl);
+        if (!StudentSchema::dropSecondaryIndexes(ddl) || !StudentSchema::dropCountTriggers(ddl)
+            || (spatial && !StudentSchema::dropSpatialTriggers(ddl))) {
+            qWarning() << "Bulk load setup failed, using normal import:" << ddl.lastError().text();
+            StudentSchema::createSecondaryIndexes(ddl);
+            StudentSchema::createCountTriggers(ddl);
+            if (spatial) {
+                StudentSchema::createSpatialTriggers(ddl);
+            }
+            bulkLoad = false;
+        }
+    }
+
+    StudentImporter importer;
+    importer.setBulkLoad(bulkLoad);
+    ImportResult result = importer.run(database, filePath);
+
+    // 索引、计数和R树在导入后一次性重建，即使导入本身失败也要恢复被删除的索引和触发器
+    QString error;
+    if (bulkLoad && !finishBulkLoad(database, spatial, error)) {
+        qWarning() << "Failed to rebuild indexes after bulk load:" << error;
+        if (result.status == ImportResult::Ok) {
+            result.status = ImportResult::RebuildFailed;
+            result.error = error;
+        }
+    }
+    return result;
+}
+
+BulkLoadPragmas::BulkLoadPragmas(QSqlDatabase& database)
+    : database(database)
+{
+    QSqlQuery query(database);
+    if (query.exec("PRAGMA journal_mode") && query.next()) {
+        journalMode = query.value(0).toString();
+    }
+    if (query.exec("PRAGMA synchronous") && query.next()) {
+        synchronous = query.value(0).toString();
+    }
+    if (query.exec("PRAGMA cache_size") && query.next()) {
+        cacheSize = query.value(0).toString();
+    }
+
+    // 回滚日志放在内存中、不等待fsync、页缓存放大到256MB，便于最后重建索引时排序。
+    // WAL 模式下写入本身已是顺序追加，而且切出 WAL 需要独占数据库，因此保持不变
+    if (journalMode.compare("wal", Qt::CaseInsensitive) == 0) {
+        journalMode.clear();
+    } else {
+        query.exec("PRAGMA journal_mode = MEMORY");
+    }
+    query.exec("PRAGMA synchronous = OFF");
+    query.exec("PRAGMA cache_size = -262144");
+}
+
+BulkLoadPragmas::~BulkLoadPragmas()
+{
+    QSqlQuery query(database);
+    if (!journalMode.isEmpty()) {
+        query.exec("PRAGMA journal_mode = " + journalMode);
+    }
+    if (!synchronous.isEmpty()) {
+        query.exec("PRAGMA synchronous = " + synchronous);
+    }
+    if (!cacheSize.isEmpty()) {
+        query.exec("PRAGMA cache_size = " + cacheSize);
+    }
+}
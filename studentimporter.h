@@ -0,0 +1,198 @@
+﻿/**
+ * @file       studentimporter.h
+ * @brief      学生数据文件的多线程导入流水线
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.6
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，将导入拆分为读取/解析/写入三级流水线]
+ *             V1.1:[lzq] [2026-10-17] [文件整体内存映射，数据块只是映射区域上的区间]
+ *             V1.2:[lzq] [2026-10-17] [解析时使用 DelimiterScanner 的SIMD分隔符扫描]
+ *             V1.3:[lzq] [2026-10-17] [增加批量导入模式: 按学号排序后写入，并临时调整会话PRAGMA]
+ *             V1.4:[lzq] [2026-10-17] [增加 importFile()，表为空时自动使用批量导入，界面和基准测试共用]
+ *             V1.5:[lzq] [2026-10-17] [公开 prepareUpsert()/writeBatch()，供 StudentRepository::upsert() 复用]
+ *             V1.6:[lzq] [2026-10-17] [增加 ImportResult::InvalidFormat / RebuildFailed]
+ *
+ * @par        设计说明:
+ *             文件整体内存映射（见 csvreader.h），读取线程按行边界把映射区域切成约256KB的区间；
+ *             N个解析线程直接在字节上把块解析成按列组织的批次（QVariantList，可直接用于
+ *             execBatch）；调用 run() 的线程是唯一的SQLite写入者，
+ *             按块的顺序写入，保证文件中重复学号“后者覆盖前者”的语义不变。
+ *             各级之间用有界队列连接，同时用信号量限制在途块数，读取速度超过写入速度时
+ *             读取线程会被阻塞，内存占用不随文件大小增长。
+ *
+ *             批量导入模式（导入到空表时使用）先为所有行建立 (学号, 行) 索引并按学号稳定排序，
+ *             再按排序后的顺序解析和写入，学号唯一索引只在右端追加；每行的索引项只有24字节，
+ *             行内容仍留在映射区域中。输入本来就按学号有序时（如 generate_data.py 的输出）跳过排序。
+ */
+
+#ifndef STUDENTIMPORTER_H
+#define STUDENTIMPORTER_H
+
+#include <QString>
+#include <QVariantList>
+
+#include "delimiterscanner.h"
+#include "student.h"
+#include "studentdictionary.h"
+
+class QSqlDatabase;
+class QSqlQuery;
+
+/**
+ * @struct StudentColumnBatch
+ * @brief 解析线程产出的一批记录，按列存放
+ */
+struct StudentColumnBatch
+{
+    qint64 sequence = 0;          ///< 源数据块的序号，写入线程按此顺序写入
+    QVariantList studentIDs;
+    QVariantList names;
+    QVariantList birthDates;
+    QVariantList genders;
+    QVariantList addressNames;
+    QVariantList coordXs;
+    QVariantList coordYs;
+    int failCount = 0;            ///< 本批中解析失败的行数
+
+    int size() const { return studentIDs.size(); }
+
+    /**
+     * @brief 追加一条已解码的记录
+     */
+    void append(const Student& student)
+    {
+        studentIDs.append(student.studentID);
+        names.append(student.name);
+        birthDates.append(student.birthDate);
+        genders.append(student.gender);
+        addressNames.append(student.addressName);
+        coordXs.append(student.addressCoordX);
+        coordYs.append(student.addressCoordY);
+    }
+};
+
+/**
+ * @struct ImportResult
+ * @brief 一次导入的结果
+ */
+struct ImportResult
+{
+    enum Status
+    {
+        Ok,                 ///< 导入完成（可能有部分行失败）
+        FileOpenFailed,     ///< 无法打开数据文件
+        TransactionFailed,  ///< 无法开启事务
+        InvalidFormat,      ///< 快照文件无效或已损坏，没有写入任何记录（原因见 error）
+        RebuildFailed       ///< 记录已导入，但批量导入后重建索引/计数缓存/R树失败（原因见 error），
+                            ///< 计数缓存和R树已标记为不可用
+    };
+
+    Status status = Ok;
+    int successCount = 0;
+    int failCount = 0;
+    QString error;
+};
+
+/**
+ * @class StudentImporter
+ * @brief 读取 → 并行解析 → 单线程写入 的导入流水线
+ */
+class StudentImporter
+{
+public:
+    /**
+     * @param[in] parserThreads 解析线程数，<=0 时按CPU核数自动选择
+     */
+    explicit StudentImporter(int parserThreads = 0);
+
+    /**
+     * @brief 把文件中的学生记录导入数据库
+     * @param[in] database 已打开的数据库连接，只在调用线程中使用
+     * @param[in] filePath 数据文件路径（每行: 学号,姓名,出生日期,性别,地址,X,Y）
+     * @return 导入结果；学号已存在的记录会被覆盖
+     */
+    ImportResult run(QSqlDatabase& database, const QString& filePath);
+
+    /**
+     * @brief 导入文件的完整流程（界面的“从文件读取”即调用此函数）
+     *
+     * 表为空时使用批量导入: 删除二级索引、计数触发器和R树触发器，按学号顺序写入，
+     * 导入后在一个事务中一次性重建索引（排序构建比逐行维护快得多）、重新统计计数并填充R树；
+     * 重建失败时回滚重建，清空 students_total 并删除 students_rtree（即标记为不可用，
+     * 查询改用 COUNT(*) 和X坐标索引），返回 RebuildFailed。
+     * 表不为空时逐批 UPSERT，由触发器维护计数和R树。
+     * @param[in] database 已打开的数据库连接，只在调用线程中使用
+     */
+    static ImportResult importFile(QSqlDatabase& database, const QString& filePath);
+
+    /**
+     * @brief 解析一个由完整行组成的数据块
+     * @param[in]  begin 块起始地址（UTF-8 编码的若干行）
+     * @param[in]  end   块结束地址
+     * @param[out] batch 解析结果追加到此批次
+     */
+    static void parseChunk(const char* begin, const char* end, StudentColumnBatch& batch);
+
+    /**
+     * @brief 使用指定的分隔符扫描实现解析（用于基准测试对比各实现）
+     */
+    static void parseChunk(const char* begin, const char* end, StudentColumnBatch& batch,
+                           DelimiterScanner::Kernel kernel);
+
+    /**
+     * @brief 在 query 上准备写入 students 的 UPSERT 语句（学号已存在时覆盖其余列）
+     */
+    static bool prepareUpsert(QSqlQuery& query);
+
+    /**
+     * @brief 把一批记录写入数据库，性别和地址名列先原地换成字典编号
+     * @param[in] query prepareUpsert() 准备好的语句；事务由调用者负责
+     * @note 写入失败时整批计入 result.failCount
+     */
+    static void writeBatch(QSqlQuery& query, StudentDictionary::Encoder& encoder, StudentColumnBatch& batch,
+                           ImportResult& result);
+
+    int parserThreadCount() const { return parsers; }
+
+    /**
+     * @brief 设置是否使用批量导入模式（按学号排序后写入）
+     * @note 只在目标表为空时有意义；二级索引和触发器的删除与重建由调用者负责
+     */
+    void setBulkLoad(bool enabled) { bulkLoad = enabled; }
+    bool isBulkLoad() const { return bulkLoad; }
+
+    static constexpr int ChunkBytes = 256 * 1024;   ///< 每个数据块的目标大小
+
+private:
+    int parsers;
+    bool bulkLoad;
+};
+
+/**
+ * @class BulkLoadPragmas
+ * @brief 在作用域内为批量导入调整连接的 journal_mode / synchronous / cache_size，析构时恢复原值
+ *
+ * 必须在事务之外构造和析构（journal_mode 不能在事务中修改）。
+ * 批量导入期间崩溃可能损坏数据库，只应在导入到空表等可以重来的场景使用。
+ */
+class BulkLoadPragmas
+{
+public:
+    explicit BulkLoadPragmas(QSqlDatabase& database);
+    ~BulkLoadPragmas();
+
+    BulkLoadPragmas(const BulkLoadPragmas&) = delete;
+    BulkLoadPragmas& operator=(const BulkLoadPragmas&) = delete;
+
+private:
+    QSqlDatabase& database;
+    QString journalMode;    ///< 原 journal_mode，例如 "delete" 或 "wal"
+    QString synchronous;    ///< 原 synchronous 级别（数字）
+    QString cacheSize;      ///< 原 cache_size（负数表示KiB）
+};
+
+#endif // STUDENTIMPORTER_H
@@ -0,0 +1,794 @@
+﻿/**
+ * @file       studentrepository.cpp
+ * @brief      students 表数据访问层的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.3
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，分页/范围/k近邻查询从 StudentTableModel 移入，
+ *                                      按学号/最年轻/计数/增删查询从 MainWindow 移入]
+ *             V1.1:[lzq] [2026-10-17] [增加 statistics()]
+ *             V1.2:[lzq] [2026-10-17] [R树按 students.id 回表；矩形范围物化到临时表后分页；坐标边界按64位计算]
+ *             V1.3:[lzq] [2026-10-17] [insert() 的字典编码和插入在调用线程的连接上、同一事务中完成]
+ */
+
+#include "studentrepository.h"
+#include "connectionmanager.h"
+#include "studentdictionary.h"
+#include "studentschema.h"
+#include "studentsnapshot.h"
+
+#include <QDebug>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+    /**
+     * @brief 读取 Student 所需的列，顺序与 StudentRepository::readStudent() 一致
+     */
+    const QString StudentColumns =
+        "students.studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY";
+
+    /**
+     * @brief 坐标范围条件的 FROM 子句和 WHERE 条件，绑定顺序为 minX, maxX, minY, maxY
+     *
+     * 用 CROSS JOIN 固定由R树驱动连接: 先在R树中筛出范围内的行号，再按行号回表，
+     * 否则规划器可能为了 ORDER BY 顺序扫描整张表
+     */
+    QString regionSource(bool useRtree)
+    {
+        return useRtree ? "students_rtree AS r CROSS JOIN students ON students.id = r.id"
+                        : "students";
+    }
+
+    QString regionCondition(bool useRtree)
+    {
+        return useRtree ? "r.maxX >= ? AND r.minX <= ? AND r.maxY >= ? AND r.minY <= ?"
+                        : "addressCoordX BETWEEN ? AND ? AND addressCoordY BETWEEN ? AND ?";
+    }
+
+    void bindRegion(QSqlQuery &statement, int &bindIndex, qint64 minX, qint64 maxX, qint64 minY, qint64 maxY)
+    {
+        statement.bindValue(bindIndex++, minX);
+        statement.bindValue(bindIndex++, maxX);
+        statement.bindValue(bindIndex++, minY);
+        statement.bindValue(bindIndex++, maxY);
+    }
+
+    /**
+     * @brief (x, y) 为圆心、矩形内按距离平方排序的第 offset+1 个值的查询
+     */
+    QString nthDistanceSql(bool useRtree)
+    {
+        return QString("SELECT (addressCoordX - ?) * (addressCoordX - ?) + (addressCoordY - ?) * (addressCoordY - ?) AS d2 "
+                       "FROM %1 WHERE %2 ORDER BY d2 LIMIT 1 OFFSET ?")
+            .arg(regionSource(useRtree), regionCondition(useRtree));
+    }
+
+    /**
+     * @brief 执行已绑定参数的语句，把所有结果行解码追加到 rows
+     */
+    bool readAll(QSqlQuery &statement, QVector<Student> &rows, QString &error)
+    {
+        if (!statement.exec()) {
+            error = statement.lastError().text();
+            return false;
+        }
+        while (statement.next()) {
+            rows.append(StudentRepository::readStudent(statement));
+        }
+        statement.finish();
+        return true;
+    }
+
+    /**
+     * @brief 执行只返回一个整数的语句
+     */
+    bool readInteger(const QString &sql, qint64 &value, QString &error)
+    {
+        QSqlQuery &statement = ConnectionManager::instance().statement(sql);
+        if (!statement.exec()) {
+            error = statement.lastError().text();
+            return false;
+        }
+        value = statement.next() ? statement.value(0).toLongLong() : 0;
+        statement.finish();
+        return true;
+    }
+
+    /**
+     * @brief 本线程连接上已物化的矩形范围（temp.students_box 的内容），见 materializeBox()
+     */
+    struct MaterializedBox
+    {
+        QString connection;        ///< 连接名；连接重新打开后临时表已不存在
+        int minX = 0;
+        int maxX = 0;
+        int minY = 0;
+        int maxY = 0;
+        qint64 dataVersion = -1;   ///< PRAGMA data_version，其他连接提交写入后改变
+        qint64 totalChanges = -1;  ///< total_changes()，本连接写入后改变
+    };
+    thread_local MaterializedBox materializedBox;
+
+    /**
+     * @brief 把矩形范围内各行的 (学号, id) 物化到本连接的临时表 temp.students_box（学号为主键）
+     *
+     * R树按空间组织，输出没有学号顺序；直接按学号分页时，每一页都要取出矩形内的全部行重新排序。
+     * 物化后每页只是临时表主键上的一次范围读取再按 id 回表。同一矩形、数据没有变化时
+     * 复用已有的临时表，因此每个查询在每个读取线程上只物化一次。
+     */
+    bool materializeBox(const StudentRepository::Query &query, QString &error)
+    {
+        ConnectionManager &connections = ConnectionManager::instance();
+        QSqlDatabase database = connections.connection();
+
+        auto readVersion = [&](qint64 &dataVersion, qint64 &totalChanges) {
+            QSqlQuery &statement = connections.statement("SELECT data_version, total_changes() FROM pragma_data_version");
+            if (!statement.exec() || !statement.next()) {
+                error = statement.lastError().text();
+                return false;
+            }
+            dataVersion = statement.value(0).toLongLong();
+            totalChanges = statement.value(1).toLongLong();
+            statement.finish();
+            return true;
+        };
+
+        qint64 dataVersion = 0;
+        qint64 totalChanges = 0;
+        if (!readVersion(dataVersion, totalChanges)) {
+            return false;
+        }
+        MaterializedBox &box = materializedBox;
+        if (box.connection == database.connectionName() && box.minX == query.minX && box.maxX == query.maxX
+            && box.minY == query.minY && box.maxY == query.maxY
+            && box.dataVersion == dataVersion && box.totalChanges == totalChanges) {
+            return true;
+        }
+
+        box = MaterializedBox();
+        QSqlQuery ddl(database);
+        if (!ddl.exec("CREATE TEMP TABLE IF NOT EXISTS students_box ("
+                      "studentID TEXT PRIMARY KEY, id INTEGER NOT NULL) WITHOUT ROWID;")
+            || !ddl.exec("DELETE FROM temp.students_box;")) {
+            error = ddl.lastError().text();
+            return false;
+        }
+        QSqlQuery &fill = connections.statement(
+            QString("INSERT INTO temp.students_box (studentID, id) SELECT students.studentID, students.id "
+                    "FROM %1 WHERE %2").arg(regionSource(true), regionCondition(true)));
+        int bindIndex = 0;
+        bindRegion(fill, bindIndex, query.minX, query.maxX, query.minY, query.maxY);
+        if (!fill.exec()) {
+            error = fill.lastError().text();
+            return false;
+        }
+
+        // 版本在写入临时表之后读取，临时表本身的写入计入 total_changes()
+        if (!readVersion(box.dataVersion, box.totalChanges)) {
+            return false;
+        }
+        box.connection = database.connectionName();
+        box.minX = query.minX;
+        box.maxX = query.maxX;
+        box.minY = query.minY;
+        box.maxY = query.maxY;
+        return true;
+    }
+
+    /**
+     * @brief 把坐标边界收窄到 int 范围（圆心加减半宽可能超出 int）
+     */
+    int clampCoordinate(qint64 value)
+    {
+        return int(std::clamp<qint64>(value, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    }
+}
+
+StudentRepository::Query StudentRepository::Query::box(int minX, int minY, int maxX, int maxY, bool useRtree)
+{
+    Query query{QString(), QVariant(), "studentID", false};
+    query.region = BoxRegion;
+    query.minX = minX;
+    query.maxX = maxX;
+    query.minY = minY;
+    query.maxY = maxY;
+    query.useRtree = useRtree;
+    return query;
+}
+
+StudentRepository::Query StudentRepository::Query::circle(int x, int y, qint64 radius2, int maxRows, bool useRtree)
+{
+    // 外接矩形的半宽取 ceil(sqrt(radius2))，并限制在坐标范围内；
+    // 边界在64位上计算后再收窄到 int，圆心接近 int 极值时也不会回绕
+    qint64 half = radius2 > 0 ? qint64(std::ceil(std::sqrt(double(radius2)))) : 0;
+    half = std::min<qint64>(half, 4 * CoordLimit);
+
+    Query query{QString(), QVariant(), "distance", false};
+    query.region = CircleRegion;
+    query.centerX = x;
+    query.centerY = y;
+    query.radius2 = radius2;
+    query.minX = clampCoordinate(x - half);
+    query.maxX = clampCoordinate(x + half);
+    query.minY = clampCoordinate(y - half);
+    query.maxY = clampCoordinate(y + half);
+    query.maxRows = maxRows;
+    query.useRtree = useRtree;
+    return query;
+}
+
+Student StudentRepository::readStudent(const QSqlQuery &query, int firstColumn)
+{
+    StudentDictionary &dictionary = StudentDictionary::instance();
+    Student student;
+    student.studentID = query.value(firstColumn).toString();
+    student.name = query.value(firstColumn + 1).toString();
+    student.birthDate = query.value(firstColumn + 2).toDate();
+    student.gender = dictionary.text(query.value(firstColumn + 3));
+    student.addressName = dictionary.text(query.value(firstColumn + 4));
+    student.addressCoordX = query.value(firstColumn + 5).toInt();
+    student.addressCoordY = query.value(firstColumn + 6).toInt();
+    return student;
+}
+
+// ==================== 读取 ====================
+
+bool StudentRepository::getById(const QString &studentID, Student &student, bool &found, QString &error)
+{
+    QSqlQuery &statement = ConnectionManager::instance().statement(
+        QString("SELECT %1 FROM students WHERE studentID = ?").arg(StudentColumns));
+    statement.bindValue(0, studentID);
+    if (!statement.exec()) {
+        error = statement.lastError().text();
+        found = false;
+        return false;
+    }
+    found = statement.next();
+    if (found) {
+        student = readStudent(statement);
+    }
+    statement.finish();
+    return true;
+}
+
+bool StudentRepository::getByIds(const QStringList &studentIDs, QVector<Student> &rows, QString &error)
+{
+    QStringList placeholders;
+    for (int i = 0; i < IdBatchSize; ++i) {
+        placeholders << "?";
+    }
+    QSqlQuery &statement = ConnectionManager::instance().statement(
+        QString("SELECT %1 FROM students WHERE studentID IN (%2) ORDER BY studentID")
+            .arg(StudentColumns, placeholders.join(", ")));
+
+    // 先去重排序，各批的结果依次追加后整体仍按学号升序
+    QStringList ids = studentIDs;
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    rows.clear();
+    for (int first = 0; first < ids.size(); first += IdBatchSize) {
+        for (int i = 0; i < IdBatchSize; ++i) {
+            const int index = first + i;
+            statement.bindValue(i, index < ids.size() ? QVariant(ids.at(index)) : QVariant());
+        }
+        if (!readAll(statement, rows, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StudentRepository::findByName(const QString &name, int limit, QVector<Student> &rows, QString &error)
+{
+    const Query query{"name", name, "studentID", false};
+    if (limit > 0) {
+        return readPage(query, nullptr, limit, rows, error);
+    }
+
+    rows.clear();
+    return scan(query, 4096, [&rows](const QVector<Student> &page) {
+        rows += page;
+        return true;
+    }, error);
+}
+
+bool StudentRepository::youngest(int count, QVector<Student> &rows, QString &error)
+{
+    QSqlQuery &statement = ConnectionManager::instance().statement(
+        QString("SELECT %1 FROM students ORDER BY birthDate DESC, studentID ASC LIMIT ?").arg(StudentColumns));
+    statement.bindValue(0, count);
+    rows.clear();
+    return readAll(statement, rows, error);
+}
+
+bool StudentRepository::exists(const QString &studentID, bool &found, QString &error)
+{
+    QSqlQuery &statement = ConnectionManager::instance().statement("SELECT 1 FROM students WHERE studentID = ?");
+    statement.bindValue(0, studentID);
+    if (!statement.exec()) {
+        error = statement.lastError().text();
+        return false;
+    }
+    found = statement.next();
+    statement.finish();
+    return true;
+}
+
+// ==================== 分页与扫描 ====================
+
+StudentRepository::Cursor StudentRepository::cursorOf(const Query &query, const Student &student)
+{
+    if (query.sortColumn == "distance") {
+        const qint64 dx = qint64(student.addressCoordX) - query.centerX;
+        const qint64 dy = qint64(student.addressCoordY) - query.centerY;
+        return {QVariant(dx * dx + dy * dy), student.studentID};
+    }
+    return {query.sortColumn == "name" ? QVariant(student.name) : QVariant(), student.studentID};
+}
+
+bool StudentRepository::readPage(const Query &query, const Cursor *after, int limit,
+                                 QVector<Student> &rows, QString &error, const CancelCheck &cancelled)
+{
+    const bool sortByName = (query.sortColumn == "name");
+    const bool sortByDistance = (query.sortColumn == "distance" && query.region == Query::CircleRegion);
+    // 按学号排序的R树矩形查询: 先物化矩形内的学号，再在临时表上分页（见 materializeBox()）
+    const bool materializedRegion = (query.region == Query::BoxRegion && query.useRtree
+                                     && query.filterColumn.isEmpty() && !sortByName);
+    const bool hasRegion = (query.region != Query::NoRegion && !materializedRegion);
+    const QString op = query.descending ? "<" : ">";
+    const QString dir = query.descending ? "DESC" : "ASC";
+
+    QStringList conditions;
+    if (!query.filterColumn.isEmpty()) {
+        conditions << query.filterColumn + " = ?";
+    }
+    if (hasRegion) {
+        conditions << regionCondition(query.useRtree);
+    }
+
+    if (materializedRegion && !materializeBox(query, error)) {
+        return false;
+    }
+
+    QString sql;
+    if (materializedRegion) {
+        sql = QString("SELECT %1 FROM temp.students_box AS b CROSS JOIN students ON students.id = b.id").arg(StudentColumns);
+        if (after) {
+            sql += QString(" WHERE b.studentID %1 ?").arg(op);
+        }
+        sql += QString(" ORDER BY b.studentID %1 LIMIT ?").arg(dir);
+    } else if (sortByDistance) {
+        // 圆形范围: 内层按外接矩形筛选并计算距离平方，外层按距离过滤并以 (d2, 学号) 键集分页
+        QStringList outer;
+        outer << "d2 <= ?";
+        if (after) {
+            outer << QString("(d2, studentID) %1 (?, ?)").arg(op);
+        }
+        sql = QString("SELECT * FROM (SELECT %1, "
+                      "(addressCoordX - ?) * (addressCoordX - ?) + (addressCoordY - ?) * (addressCoordY - ?) AS d2 "
+                      "FROM %2 WHERE %3) WHERE %4 ORDER BY d2 %5, studentID %5 LIMIT ?")
+                  .arg(StudentColumns, regionSource(query.useRtree), conditions.join(" AND "), outer.join(" AND "), dir);
+    } else {
+        if (after) {
+            conditions << (sortByName ? QString("(name, students.studentID) %1 (?, ?)").arg(op)
+                                      : QString("students.studentID %1 ?").arg(op));
+        }
+        sql = QString("SELECT %1 FROM %2").arg(StudentColumns, hasRegion ? regionSource(query.useRtree) : "students");
+        if (!conditions.isEmpty()) {
+            sql += " WHERE " + conditions.join(" AND ");
+        }
+        sql += sortByName ? QString(" ORDER BY name %1, students.studentID %1").arg(dir)
+                          : QString(" ORDER BY students.studentID %1").arg(dir);
+        sql += " LIMIT ?";
+    }
+
+    // 查询形状有限（过滤列 × 范围 × 排序 × 方向 × 是否带游标），每种形状在本连接上只 prepare 一次
+    QSqlQuery &statement = ConnectionManager::instance().statement(sql);
+    int bindIndex = 0;
+    if (sortByDistance) {
+        statement.bindValue(bindIndex++, query.centerX);
+        statement.bindValue(bindIndex++, query.centerX);
+        statement.bindValue(bindIndex++, query.centerY);
+        statement.bindValue(bindIndex++, query.centerY);
+    }
+    if (!query.filterColumn.isEmpty()) {
+        statement.bindValue(bindIndex++, query.filterValue);
+    }
+    if (hasRegion) {
+        bindRegion(statement, bindIndex, query.minX, query.maxX, query.minY, query.maxY);
+    }
+    if (sortByDistance) {
+        statement.bindValue(bindIndex++, query.radius2);
+    }
+    if (after) {
+        if (sortByName || sortByDistance) {
+            statement.bindValue(bindIndex++, after->sortKey);
+        }
+        statement.bindValue(bindIndex++, after->studentID);
+    }
+    statement.bindValue(bindIndex++, limit);
+
+    if (cancelled && cancelled()) {
+        return false;
+    }
+    if (!statement.exec()) {
+        error = statement.lastError().text();
+        return false;
+    }
+
+    rows.clear();
+    rows.reserve(limit);
+    while (statement.next()) {
+        // 每读一行检查一次，被放弃的读取尽快让出线程
+        if (cancelled && cancelled()) {
+            statement.finish();
+            return false;
+        }
+        rows.append(readStudent(statement));
+    }
+    statement.finish();
+    return true;
+}
+
+bool StudentRepository::scan(const Query &query, int pageRows, const PageVisitor &visitor, QString &error)
+{
+    pageRows = std::max(1, pageRows);
+    QVector<Student> page;
+    Cursor after;
+    bool hasCursor = false;
+    int remaining = query.maxRows > 0 ? query.maxRows : -1;
+
+    // 每页都是一次独立的键集查询，页与页之间不保持读事务
+    while (remaining != 0) {
+        const int limit = remaining > 0 ? std::min(pageRows, remaining) : pageRows;
+        if (!readPage(query, hasCursor ? &after : nullptr, limit, page, error)) {
+            return false;
+        }
+        if (page.isEmpty() || !visitor(page)) {
+            break;
+        }
+        if (page.size() < limit) {
+            break;
+        }
+        after = cursorOf(query, page.last());
+        hasCursor = true;
+        if (remaining > 0) {
+            remaining -= page.size();
+        }
+    }
+    return true;
+}
+
+bool StudentRepository::count(const Query &query, bool countsReady, int &count, bool &exact, QString &error)
+{
+    if (query.region != Query::NoRegion) {
+        // 坐标范围查询没有计数缓存，直接在R树上统计（只访问相交的节点）
+        exact = true;
+        return countRegion(query, count, error);
+    }
+
+    ConnectionManager &connections = ConnectionManager::instance();
+    if (countsReady) {
+        QSqlQuery &statement = query.filterColumn.isEmpty()
+                                   ? connections.statement("SELECT cnt FROM students_total WHERE id = 0")
+                               : query.filterColumn == "name"
+                                   ? connections.statement("SELECT cnt FROM students_name_counts WHERE name = ?")
+                                   : connections.statement("SELECT cnt FROM students_coordx_counts WHERE addressCoordX = ?");
+        if (!query.filterColumn.isEmpty()) {
+            statement.bindValue(0, query.filterValue);
+        }
+        if (!statement.exec()) {
+            error = statement.lastError().text();
+            return false;
+        }
+        // 没有计数行表示该键没有任何记录
+        count = statement.next() ? statement.value(0).toInt() : 0;
+        statement.finish();
+        exact = true;
+    } else {
+        // 计数表重建中: 总数用最大 rowid 估算（O(log n)），带过滤条件时先按0估算，
+        // 由调用者根据已读取的行数逐步抬高
+        count = 0;
+        if (query.filterColumn.isEmpty()) {
+            QSqlQuery &statement = connections.statement("SELECT MAX(rowid) FROM students");
+            if (!statement.exec()) {
+                error = statement.lastError().text();
+                return false;
+            }
+            count = statement.next() ? statement.value(0).toInt() : 0;
+            statement.finish();
+        }
+        exact = false;
+    }
+    if (query.maxRows > 0) {
+        count = std::min(count, query.maxRows);
+    }
+    return true;
+}
+
+bool StudentRepository::countRegion(const Query &query, int &count, QString &error)
+{
+    QString sql = QString("SELECT COUNT(*) FROM %1 WHERE %2")
+                      .arg(regionSource(query.useRtree), regionCondition(query.useRtree));
+    if (!query.filterColumn.isEmpty()) {
+        sql += " AND " + query.filterColumn + " = ?";
+    }
+    if (query.region == Query::CircleRegion) {
+        sql += " AND (addressCoordX - ?) * (addressCoordX - ?) + (addressCoordY - ?) * (addressCoordY - ?) <= ?";
+    }
+
+    QSqlQuery &statement = ConnectionManager::instance().statement(sql);
+    int bindIndex = 0;
+    bindRegion(statement, bindIndex, query.minX, query.maxX, query.minY, query.maxY);
+    if (!query.filterColumn.isEmpty()) {
+        statement.bindValue(bindIndex++, query.filterValue);
+    }
+    if (query.region == Query::CircleRegion) {
+        statement.bindValue(bindIndex++, query.centerX);
+        statement.bindValue(bindIndex++, query.centerX);
+        statement.bindValue(bindIndex++, query.centerY);
+        statement.bindValue(bindIndex++, query.centerY);
+        statement.bindValue(bindIndex++, query.radius2);
+    }
+    if (!statement.exec()) {
+        error = statement.lastError().text();
+        return false;
+    }
+    count = statement.next() ? statement.value(0).toInt() : 0;
+    statement.finish();
+    if (query.maxRows > 0) {
+        count = std::min(count, query.maxRows);
+    }
+    return true;
+}
+
+bool StudentRepository::nearestRadius2(int x, int y, int k, bool useRtree, qint64 &radius2, QString &error)
+{
+    radius2 = -1;
+    if (k <= 0) {
+        return true;
+    }
+
+    ConnectionManager &connections = ConnectionManager::instance();
+    const QString countSql = QString("SELECT COUNT(*) FROM %1 WHERE %2")
+                                 .arg(regionSource(useRtree), regionCondition(useRtree));
+
+    // 矩形边长每次放大4倍，覆盖整个坐标范围后停止；边界按64位计算，圆心在范围外也不会溢出
+    const qint64 fullHalf = 2 * qint64(CoordLimit) + std::max(std::abs(qint64(x)), std::abs(qint64(y)));
+    qint64 half = 64;
+    int found = 0;
+    for (;;) {
+        QSqlQuery &counter = connections.statement(countSql);
+        int bindIndex = 0;
+        bindRegion(counter, bindIndex, x - half, x + half, y - half, y + half);
+        if (!counter.exec()) {
+            error = counter.lastError().text();
+            return false;
+        }
+        found = counter.next() ? counter.value(0).toInt() : 0;
+        counter.finish();
+        if (found >= k || half >= fullHalf) {
+            break;
+        }
+        half = std::min(half * 4, fullHalf);
+    }
+    if (found == 0) {
+        return true;
+    }
+
+    auto nthDistance = [&](qint64 searchHalf, int offset, qint64 &d2) {
+        QSqlQuery &statement = connections.statement(nthDistanceSql(useRtree));
+        int bindIndex = 0;
+        statement.bindValue(bindIndex++, x);
+        statement.bindValue(bindIndex++, x);
+        statement.bindValue(bindIndex++, y);
+        statement.bindValue(bindIndex++, y);
+        bindRegion(statement, bindIndex, x - searchHalf, x + searchHalf, y - searchHalf, y + searchHalf);
+        statement.bindValue(bindIndex++, offset);
+        if (!statement.exec()) {
+            error = statement.lastError().text();
+            return false;
+        }
+        d2 = statement.next() ? statement.value(0).toLongLong() : -1;
+        statement.finish();
+        return true;
+    };
+
+    // 矩形内第k近的点不一定是全局第k近: 矩形外的点距离至少为 half，
+    // 只有当第k近的距离不超过 half 时结果才确定，否则按该距离放大矩形重新计算
+    const int offset = std::min(found, k) - 1;
+    if (!nthDistance(half, offset, radius2)) {
+        return false;
+    }
+    if (radius2 > half * half && half < fullHalf) {
+        const qint64 exactHalf = std::min<qint64>(fullHalf, qint64(std::ceil(std::sqrt(double(radius2)))));
+        if (!nthDistance(exactHalf, offset, radius2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StudentRepository::statistics(Statistics &statistics, QString &error)
+{
+    statistics = Statistics();
+    {
+        QSqlQuery query(ConnectionManager::instance().connection());
+        statistics.countsCached = StudentSchema::hasCountCache(query);
+        statistics.spatialIndex = StudentSchema::hasSpatialTable(query);
+    }
+
+    // 计数表中每个姓名/X坐标一行，行数即不同取值的个数
+    const bool counted = statistics.countsCached
+        ? readInteger("SELECT cnt FROM students_total WHERE id = 0", statistics.students, error)
+              && readInteger("SELECT COUNT(*) FROM students_name_counts", statistics.distinctNames, error)
+              && readInteger("SELECT COUNT(*) FROM students_coordx_counts", statistics.distinctCoordX, error)
+        : readInteger("SELECT COUNT(*) FROM students", statistics.students, error)
+              && readInteger("SELECT COUNT(DISTINCT name) FROM students", statistics.distinctNames, error)
+              && readInteger("SELECT COUNT(DISTINCT addressCoordX) FROM students", statistics.distinctCoordX, error);
+    if (!counted) {
+        return false;
+    }
+
+    qint64 pageCount = 0;
+    qint64 pageSize = 0;
+    if (!readInteger("SELECT COUNT(*) FROM student_strings", statistics.dictionaryStrings, error)
+        || !readInteger("PRAGMA page_count", pageCount, error)
+        || !readInteger("PRAGMA page_size", pageSize, error)) {
+        return false;
+    }
+    statistics.databaseBytes = pageCount * pageSize;
+
+    // 两个方向各读取出生日期索引的第一项
+    const char *const ends[] = {
+        "SELECT birthDate FROM students ORDER BY birthDate DESC, studentID ASC LIMIT 1",
+        "SELECT birthDate FROM students ORDER BY birthDate ASC, studentID DESC LIMIT 1"
+    };
+    QDate *const targets[] = {&statistics.youngestBirthDate, &statistics.oldestBirthDate};
+    for (int i = 0; i < 2; ++i) {
+        QSqlQuery &statement = ConnectionManager::instance().statement(ends[i]);
+        if (!statement.exec()) {
+            error = statement.lastError().text();
+            return false;
+        }
+        if (statement.next()) {
+            *targets[i] = statement.value(0).toDate();
+        }
+        statement.finish();
+    }
+    return true;
+}
+
+// ==================== 写入 ====================
+
+bool StudentRepository::insert(const Student &student, QString &error)
+{
+    // 字典编码和插入在同一连接、同一事务中完成: 学号重复等失败时新增的字典项一并回滚
+    QSqlDatabase database = ConnectionManager::instance().connection();
+    if (!database.transaction()) {
+        error = database.lastError().text();
+        return false;
+    }
+
+    // 性别和地址名先换成字典编号
+    StudentDictionary::Encoder encoder(database);
+    int genderID = 0;
+    int addressID = 0;
+    if (!encoder.encode(student.gender, genderID) || !encoder.encode(student.addressName, addressID)) {
+        error = encoder.lastError();
+        database.rollback();
+        return false;
+    }
+
+    // 使用INSERT INTO插入学生数据，不允许覆盖
+    QSqlQuery &statement = ConnectionManager::instance().statement(
+        "INSERT INTO students (studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?)");
+    statement.bindValue(0, student.studentID);
+    statement.bindValue(1, student.name);
+    statement.bindValue(2, student.birthDate); // QDate类型会自动转换为字符串
+    statement.bindValue(3, genderID);
+    statement.bindValue(4, addressID);
+    statement.bindValue(5, student.addressCoordX);
+    statement.bindValue(6, student.addressCoordY);
+    if (!statement.exec()) {
+        error = statement.lastError().text();
+        database.rollback();
+        return false;
+    }
+    if (!database.commit()) {
+        error = database.lastError().text();
+        database.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool StudentRepository::remove(const QString &studentID, bool &removed, QString &error)
+{
+    QSqlQuery &statement = ConnectionManager::instance().statement("DELETE FROM students WHERE studentID = ?");
+    statement.bindValue(0, studentID);
+    if (!statement.exec()) {
+        error = statement.lastError().text();
+        removed = false;
+        return false;
+    }
+    removed = statement.numRowsAffected() > 0;
+    return true;
+}
+
+ImportResult StudentRepository::upsert(QSqlDatabase &database, const QVector<Student> &students)
+{
+    ImportResult result;
+    if (!database.transaction()) {
+        result.status = ImportResult::TransactionFailed;
+        result.error = database.lastError().text();
+        return result;
+    }
+
+    QSqlQuery query(database);
+    StudentImporter::prepareUpsert(query);
+    StudentDictionary::Encoder encoder(database);
+
+    // 与导入流水线相同的按列批次和 execBatch，计数和R树由触发器维护
+    const int batchRows = 8192;
+    StudentColumnBatch batch;
+    for (const Student &student : students) {
+        batch.append(student);
+        if (batch.size() == batchRows) {
+            StudentImporter::writeBatch(query, encoder, batch, result);
+            batch = StudentColumnBatch();
+        }
+    }
+    StudentImporter::writeBatch(query, encoder, batch, result);
+
+    if (!database.commit()) {
+        qWarning() << "Transaction commit failed:" << database.lastError().text();
+        result.failCount += result.successCount; // 提交失败，所有都算失败
+        result.successCount = 0;
+        result.error = database.lastError().text();
+        database.rollback();
+    }
+    return result;
+}
+
+ImportResult StudentRepository::importFile(QSqlDatabase &database, const QString &filePath)
+{
+    return StudentImporter::importFile(database, filePath);
+}
+
+ExportResult StudentRepository::exportFile(const QString &filePath)
+{
+    if (!filePath.endsWith(".snap", Qt::CaseInsensitive)) {
+        // 划分 / 并行格式化 / 顺序写入 流水线，各线程使用连接池中自己的连接
+        StudentExporter exporter;
+        return exporter.run(filePath);
+    }
+
+    // 二进制列式快照，加载时由导入流水线识别
+    const SnapshotResult snapshot = StudentSnapshotWriter::saveDatabase(filePath);
+    ExportResult result;
+    switch (snapshot.status) {
+    case SnapshotResult::Ok:             result.status = ExportResult::Ok; break;
+    case SnapshotResult::FileOpenFailed: result.status = ExportResult::FileOpenFailed; break;
+    case SnapshotResult::QueryFailed:    result.status = ExportResult::QueryFailed; break;
+    case SnapshotResult::WriteFailed:    result.status = ExportResult::WriteFailed; break;
+    }
+    result.recordCount = snapshot.recordCount;
+    result.bytesWritten = snapshot.bytesWritten;
+    result.error = snapshot.error;
+    return result;
+}
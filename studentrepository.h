@@ -0,0 +1,282 @@
+﻿/**
+ * @file       studentrepository.h
+ * @brief      students 表的数据访问层：按学号/姓名查询、键集分页、流式扫描和批量写入
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.3
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，把界面和表格模型中的SQL集中到一个可复用的数据访问层]
+ *             V1.1:[lzq] [2026-10-17] [增加 statistics()，供命令行工具的 stats 命令使用]
+ *             V1.2:[lzq] [2026-10-17] [R树按 students.id 回表；矩形范围先物化再分页]
+ *             V1.3:[lzq] [2026-10-17] [insert() 与 remove()/exists() 一样使用调用线程的连接]
+ *
+ * @par        设计说明:
+ *             界面（MainWindow、StudentTableModel）、基准测试和命令行工具都只通过本类访问 students 表，
+ *             不再各自拼写SQL、各自把结果列复制成 Student。所有函数都是静态的，在调用线程的连接上执行
+ *             （ConnectionManager 按线程提供连接和预编译语句缓存），因此可以在任意工作线程调用，
+ *             异步执行由调用者决定。以后增加结果缓存等机制也只需改动这一处。
+ *
+ *             接口按批量设计:
+ *             - 读取: getById()/getByIds() 按学号取记录，findByName() 等值查询，youngest() 取前N名；
+ *             - 分页: readPage() 以键集游标（Cursor）从任意位置读取一页，cursorOf() 由任意一行构造游标；
+ *             - 扫描: scan() 按排序顺序逐页把整个结果交给回调，内存占用只有一页；
+ *             - 写入: upsert() 在一个事务中批量写入（学号已存在时覆盖），importFile()/exportFile()
+ *               走导入/导出流水线（文本或快照格式由文件决定）。
+ *             失败时函数返回false（或结果中的状态），错误信息写入 error 参数。
+ *
+ *             坐标范围条件由 students_rtree（SQLite rtree 模块的R树）先筛出外接矩形内的行，
+ *             再按 students.id 回表取记录；矩形范围按学号分页时，先把矩形内的 (学号, id) 物化到
+ *             本连接的临时表，之后每页只是临时表上的一次键集读取，不再每页重新排序整个矩形；
+ *             圆形范围在R树筛选的基础上按距离平方过滤，并以 (距离平方, 学号) 作为键集游标，
+ *             由近到远分页读取。k近邻查询先用 nearestRadius2() 求出第k近的距离，再作为圆形范围
+ *             查询读取（maxRows = k）。R树不可用时退回 (addressCoordX, studentID) 索引上的范围扫描。
+ */
+
+#ifndef STUDENTREPOSITORY_H
+#define STUDENTREPOSITORY_H
+
+#include <QDate>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QtGlobal>
+
+#include <functional>
+
+#include "student.h"
+#include "studentexporter.h"
+#include "studentimporter.h"
+
+class QSqlDatabase;
+class QSqlQuery;
+
+/**
+ * @class StudentRepository
+ * @brief students 表的数据访问接口（只含静态函数）
+ */
+class StudentRepository
+{
+public:
+    /**
+     * @struct Query
+     * @brief 查询的形状：可选的等值过滤条件和坐标范围 + 排序列
+     */
+    struct Query
+    {
+        enum Region
+        {
+            NoRegion,      ///< 不限坐标
+            BoxRegion,     ///< 矩形范围 [minX, maxX] x [minY, maxY]
+            CircleRegion   ///< 以 (centerX, centerY) 为圆心、距离平方不超过 radius2 的范围
+        };
+
+        QString filterColumn;  ///< 等值过滤列（为空表示不过滤）
+        QVariant filterValue;  ///< 过滤值
+        QString sortColumn;    ///< 排序列: "studentID"、"name"（以学号作为第二排序键）
+                               ///< 或 "distance"（仅圆形范围，以学号作为第二排序键）
+        bool descending;       ///< 是否降序
+
+        Region region = NoRegion;
+        int minX = 0;              ///< 坐标范围（含边界），圆形范围时为圆的外接矩形
+        int maxX = 0;
+        int minY = 0;
+        int maxY = 0;
+        int centerX = 0;           ///< 圆心，仅圆形范围
+        int centerY = 0;
+        qint64 radius2 = 0;        ///< 半径的平方，仅圆形范围
+        int maxRows = 0;           ///< 最多返回的行数，0 表示不限
+        bool useRtree = true;      ///< 是否通过 students_rtree 筛选坐标范围
+
+        /**
+         * @brief 矩形范围内的学生，按学号升序
+         */
+        static Query box(int minX, int minY, int maxX, int maxY, bool useRtree);
+
+        /**
+         * @brief 圆形范围内的学生，由近到远（同距离按学号）
+         * @param[in] maxRows 最多返回的行数，0 表示不限
+         */
+        static Query circle(int x, int y, qint64 radius2, int maxRows, bool useRtree);
+    };
+
+    /**
+     * @struct Cursor
+     * @brief 键集游标：某一行的 (排序键, 学号)
+     */
+    struct Cursor
+    {
+        QVariant sortKey;   ///< 排序列的值（按学号排序时为空）
+        QString studentID;  ///< 学号，作为排序的最终决胜键
+    };
+
+    /**
+     * @struct Statistics
+     * @brief 数据库的概况
+     */
+    struct Statistics
+    {
+        qint64 students = 0;           ///< 学生记录数
+        qint64 distinctNames = 0;      ///< 不同的姓名数
+        qint64 distinctCoordX = 0;     ///< 不同的X坐标数
+        qint64 dictionaryStrings = 0;  ///< student_strings 中的文本数（性别和地址名）
+        QDate oldestBirthDate;         ///< 最早的出生日期，没有记录时无效
+        QDate youngestBirthDate;       ///< 最晚的出生日期，没有记录时无效
+        qint64 databaseBytes = 0;      ///< 数据库文件的页数 × 页大小
+        bool countsCached = false;     ///< 记录数是否来自计数表（否则为 COUNT 扫描）
+        bool spatialIndex = false;     ///< students_rtree 是否存在
+    };
+
+    /**
+     * @brief 读取过程中检查是否应放弃，返回true时停止读取（例如查询已被新查询取代）
+     */
+    typedef std::function<bool()> CancelCheck;
+
+    /**
+     * @brief scan() 的回调，每页调用一次，返回false时停止扫描
+     */
+    typedef std::function<bool(const QVector<Student>&)> PageVisitor;
+
+    static constexpr int DefaultPageRows = 256;   ///< 分页读取的默认行数
+    static constexpr int IdBatchSize = 64;         ///< getByIds() 每条语句查询的学号数
+    static constexpr int CoordLimit = 10000;       ///< 坐标取值范围 [-CoordLimit, CoordLimit]，界面和命令行据此校验输入
+
+    // ---------- 读取 ----------
+
+    /**
+     * @brief 按学号读取一条记录
+     * @param[out] found 是否找到
+     * @return 查询成功返回true（没有找到也是成功）
+     */
+    static bool getById(const QString& studentID, Student& student, bool& found, QString& error);
+
+    /**
+     * @brief 按学号批量读取记录
+     * @param[out] rows 找到的记录，按学号升序；不存在的学号被忽略
+     * @note 每 IdBatchSize 个学号一条 IN 查询，不足时以 NULL 补齐，语句形状固定只 prepare 一次
+     */
+    static bool getByIds(const QStringList& studentIDs, QVector<Student>& rows, QString& error);
+
+    /**
+     * @brief 姓名等值查询，按学号升序
+     * @param[in] limit 最多读取的行数，<=0 表示不限
+     */
+    static bool findByName(const QString& name, int limit, QVector<Student>& rows, QString& error);
+
+    /**
+     * @brief 最年轻的 count 名学生（出生日期降序，同一天按学号升序）
+     * @note 排序与 idx_students_birthDate_id 一致，只读取索引的前 count 项
+     */
+    static bool youngest(int count, QVector<Student>& rows, QString& error);
+
+    /**
+     * @brief 学号是否已存在
+     */
+    static bool exists(const QString& studentID, bool& found, QString& error);
+
+    // ---------- 分页与扫描 ----------
+
+    /**
+     * @brief 读取一页记录
+     * @param[in]  query     查询形状
+     * @param[in]  after     从该游标之后开始读取，为空表示从头读取
+     * @param[in]  limit     最多读取的行数
+     * @param[out] rows      读取到的记录，按排序顺序排列
+     * @param[out] error     失败时的错误信息
+     * @param[in]  cancelled 可选的放弃检查，执行前和每读一行时调用一次
+     * @return 读取完成返回true；失败或被放弃返回false（被放弃时 error 为空）
+     */
+    static bool readPage(const Query& query, const Cursor* after, int limit,
+                         QVector<Student>& rows, QString& error,
+                         const CancelCheck& cancelled = CancelCheck());
+
+    /**
+     * @brief 以 student 这一行作为键集游标，readPage() 从它之后继续读取
+     */
+    static Cursor cursorOf(const Query& query, const Student& student);
+
+    /**
+     * @brief 按排序顺序逐页读取整个查询结果（遵守 query.maxRows）
+     * @param[in] pageRows 每页的行数
+     * @param[in] visitor  每页调用一次，返回false时提前结束（仍返回true）
+     */
+    static bool scan(const Query& query, int pageRows, const PageVisitor& visitor, QString& error);
+
+    /**
+     * @brief 查询结果的总行数
+     * @param[in]  countsReady 计数表是否可用，不可用时没有坐标范围的查询返回估算值
+     * @param[out] exact       count 是否为精确值
+     * @note 没有坐标范围时读取触发器维护的计数表（一次主键查找）；
+     *       有坐标范围时在R树上统计（不超过 query.maxRows）
+     */
+    static bool count(const Query& query, bool countsReady, int& count, bool& exact, QString& error);
+
+    /**
+     * @brief 统计坐标范围查询的结果行数（不超过 query.maxRows）
+     */
+    static bool countRegion(const Query& query, int& count, QString& error);
+
+    /**
+     * @brief 求到 (x, y) 第k近的学生的距离平方
+     * @param[out] radius2 第k近（不足k名时为最远一名）的距离平方，没有任何学生时为 -1
+     * @note 从小矩形开始逐步放大，直到矩形内至少有k名学生，再取其中第k近的距离；
+     *       该距离超过矩形的半宽时矩形外可能有更近的学生，按该距离放大矩形再取一次
+     */
+    static bool nearestRadius2(int x, int y, int k, bool useRtree, qint64& radius2, QString& error);
+
+    /**
+     * @brief 读取数据库概况
+     * @note 计数表可用时记录数都是主键查找，出生日期范围读取 idx_students_birthDate_id 的两端
+     */
+    static bool statistics(Statistics& statistics, QString& error);
+
+    // ---------- 写入 ----------
+
+    /**
+     * @brief 插入一名学生，学号已存在时失败（不覆盖）
+     * @note 性别/地址名的字典编码和插入在同一事务中，失败时都不保留
+     */
+    static bool insert(const Student& student, QString& error);
+
+    /**
+     * @brief 删除一名学生
+     * @param[out] removed 是否确实删除了记录
+     */
+    static bool remove(const QString& studentID, bool& removed, QString& error);
+
+    /**
+     * @brief 在一个事务中批量写入，学号已存在的记录被覆盖
+     * @param[in] database 已打开的数据库连接，只在调用线程中使用
+     * @return 写入结果，每批失败时整批计入 failCount
+     */
+    static ImportResult upsert(QSqlDatabase& database, const QVector<Student>& students);
+
+    /**
+     * @brief 从文本或快照文件导入，见 StudentImporter::importFile()
+     */
+    static ImportResult importFile(QSqlDatabase& database, const QString& filePath);
+
+    /**
+     * @brief 按学号顺序导出到文件
+     *
+     * 扩展名为 .snap 时写二进制列式快照（StudentSnapshotWriter），否则由 StudentExporter
+     * 写文本；快照的结果也按 ExportResult 返回。
+     */
+    static ExportResult exportFile(const QString& filePath);
+
+    /**
+     * @brief 把查询结果当前行从 firstColumn 开始的7列解码为 Student
+     *
+     * 列顺序为 studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY，
+     * 性别和地址名是 student_strings 中的编号。
+     */
+    static Student readStudent(const QSqlQuery& query, int firstColumn = 0);
+
+private:
+    StudentRepository() = delete;
+};
+
+#endif // STUDENTREPOSITORY_H
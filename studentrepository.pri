@@ -0,0 +1,15 @@
+# 链接 StudentRepository 静态库，由 StudentMessageManagemantSystem.pro 下的各子项目包含
+# 静态库在构建目录的 repository/ 子目录中生成（见 repository/StudentRepository.pro），
+# 用 shadowed() 从源码根目录换算出构建目录，不依赖包含本文件的子项目所在的层级
+QT += sql concurrent
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+STUDENT_REPOSITORY_DIR = $$shadowed($$PWD)/repository
+win32:CONFIG(release, debug|release): STUDENT_REPOSITORY_DIR = $$STUDENT_REPOSITORY_DIR/release
+else:win32:CONFIG(debug, debug|release): STUDENT_REPOSITORY_DIR = $$STUDENT_REPOSITORY_DIR/debug
+
+LIBS += -L$$STUDENT_REPOSITORY_DIR -lStudentRepository
+
+win32-msvc*: PRE_TARGETDEPS += $$STUDENT_REPOSITORY_DIR/StudentRepository.lib
+else: PRE_TARGETDEPS += $$STUDENT_REPOSITORY_DIR/libStudentRepository.a
@@ -0,0 +1,313 @@
+﻿/**
+ * @file       studentschema.cpp
+ * @brief      students 数据库结构维护函数的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.2
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [拆出不带事务的 recountCountCache()，供批量导入在同一事务中重建]
+ *             V1.2:[lzq] [2026-10-17] [students 增加 id INTEGER PRIMARY KEY，学号改为唯一键，R树以 id 引用记录]
+ */
+
+#include "studentschema.h"
+#include "studentdictionary.h"
+
+#include <QDebug>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace
+{
+    /**
+     * @brief students 表的建表语句
+     *
+     * id 是 rowid 的别名（INTEGER PRIMARY KEY），VACUUM 和表重建都不会改变它，R树以它引用记录；
+     * 学号是唯一键（UPSERT 的冲突目标），gender / addressName 保存 student_strings 的编号
+     */
+    QString studentsTableSql(const QString &table)
+    {
+        return QString("CREATE TABLE IF NOT EXISTS %1 ("
+                       "id INTEGER PRIMARY KEY,"
+                       "studentID TEXT NOT NULL UNIQUE,"
+                       "name TEXT NOT NULL,"
+                       "birthDate TEXT NOT NULL,"
+                       "gender INTEGER NOT NULL,"
+                       "addressName INTEGER NOT NULL,"
+                       "addressCoordX INTEGER NOT NULL,"
+                       "addressCoordY INTEGER NOT NULL"
+                       ");").arg(table);
+    }
+
+    /**
+     * @brief 把以学号为主键、没有 id 列的旧表改写为当前格式（一次性，在一个事务中完成）
+     *
+     * 旧表的 rowid 是隐式列，VACUUM 可能重新编号，以 rowid 引用记录的R树随之失效。
+     * 改写时 id 取原 rowid，并按新的 id 重新填充R树；旧表的索引和触发器随旧表一起删除，
+     * 由调用者重新创建
+     */
+    bool addIdColumn(QSqlDatabase &database, bool &migrated, QString &error)
+    {
+        QSqlQuery query(database);
+        if (!query.exec("SELECT 1 FROM pragma_table_info('students') WHERE name = 'id'")) {
+            error = query.lastError().text();
+            return false;
+        }
+        if (query.next()) {
+            return true; // 已是新格式
+        }
+        query.finish();
+
+        if (!database.transaction()) {
+            error = database.lastError().text();
+            return false;
+        }
+        const bool spatial = StudentSchema::hasSpatialTable(query);
+        const bool success =
+            query.exec(studentsTableSql("students_keyed"))
+            && query.exec("INSERT INTO students_keyed "
+                          "(id, studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY) "
+                          "SELECT rowid, studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
+                          "FROM students;")
+            && query.exec("DROP TABLE students;")
+            && query.exec("ALTER TABLE students_keyed RENAME TO students;")
+            && (!spatial || StudentSchema::rebuildSpatialIndex(query));
+        if (!success) {
+            error = query.lastError().text();
+            database.rollback();
+            return false;
+        }
+        if (!database.commit()) {
+            error = database.lastError().text();
+            return false;
+        }
+        migrated = true;
+        return true;
+    }
+}
+
+bool StudentSchema::create(QSqlDatabase &database, bool &migrated, QString &error)
+{
+    QSqlQuery query(database);
+
+    // 性别和地址名的字典（见 studentdictionary.h），旧版本以文本保存的表在这里一次性转换
+    migrated = false;
+    if (!StudentDictionary::createTable(query) || !StudentDictionary::migrateStudentsTable(database, migrated)) {
+        error = "Failed to prepare string dictionary: " + query.lastError().text();
+        return false;
+    }
+
+    // 创建学生表（见 studentsTableSql()），以学号为主键的旧表在这里改写为带 id 列的新表
+    bool success = query.exec(studentsTableSql("students"));
+    if (!success) {
+        error = "Failed to create students table: " + query.lastError().text();
+        return false;
+    }
+    if (!addIdColumn(database, migrated, error)) {
+        error = "Failed to add id column to students table: " + error;
+        return false;
+    }
+
+    if (!createSecondaryIndexes(query)) {
+        error = "Failed to create indexes: " + query.lastError().text();
+        return false;
+    }
+
+    // 旧版本的单列索引已被上面的复合索引覆盖，删除以减少写入开销
+    query.exec("DROP INDEX IF EXISTS idx_students_name;");
+    query.exec("DROP INDEX IF EXISTS idx_students_addressCoordX;");
+
+    // 记录数缓存: 总数（单行）、按姓名计数、按X坐标计数
+    success = query.exec("CREATE TABLE IF NOT EXISTS students_total ("
+                         "id INTEGER PRIMARY KEY CHECK (id = 0),"
+                         "cnt INTEGER NOT NULL"
+                         ");")
+              && query.exec("CREATE TABLE IF NOT EXISTS students_name_counts ("
+                            "name TEXT PRIMARY KEY NOT NULL,"
+                            "cnt INTEGER NOT NULL"
+                            ") WITHOUT ROWID;")
+              && query.exec("CREATE TABLE IF NOT EXISTS students_coordx_counts ("
+                            "addressCoordX INTEGER PRIMARY KEY NOT NULL,"
+                            "cnt INTEGER NOT NULL"
+                            ");");
+    if (!success || !createCountTriggers(query)) {
+        error = "Failed to create count cache: " + query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool StudentSchema::createSecondaryIndexes(QSqlQuery &query)
+{
+    // 为(name, studentID)创建复合索引: 既服务于按姓名等值查询，也让键集分页的
+    // "ORDER BY name, studentID" 和 "WHERE name = ? AND studentID > ?" 直接走索引；
+    // (addressCoordX, studentID) 同理服务于按坐标查询的键集分页。
+    // (birthDate DESC, studentID) 的顺序就是"从年轻到年长、同日按学号"，
+    // 最年轻的前N名学生只需顺序读取索引的前N项，不再全表扫描排序
+    return query.exec("CREATE INDEX IF NOT EXISTS idx_students_name_id ON students(name, studentID);")
+        && query.exec("CREATE INDEX IF NOT EXISTS idx_students_addressCoordX_id ON students(addressCoordX, studentID);")
+        && query.exec("CREATE INDEX IF NOT EXISTS idx_students_birthDate_id ON students(birthDate DESC, studentID);");
+}
+
+bool StudentSchema::dropSecondaryIndexes(QSqlQuery &query)
+{
+    return query.exec("DROP INDEX IF EXISTS idx_students_name_id;")
+        && query.exec("DROP INDEX IF EXISTS idx_students_addressCoordX_id;")
+        && query.exec("DROP INDEX IF EXISTS idx_students_birthDate_id;");
+}
+
+bool StudentSchema::createCountTriggers(QSqlQuery &query)
+{
+    // 插入: 总数和对应的姓名/坐标计数加一（UPSERT，计数行不存在时创建）
+    return query.exec("CREATE TRIGGER IF NOT EXISTS trg_students_count_insert AFTER INSERT ON students BEGIN "
+                      "UPDATE students_total SET cnt = cnt + 1 WHERE id = 0; "
+                      "INSERT INTO students_name_counts (name, cnt) VALUES (NEW.name, 1) "
+                      "ON CONFLICT(name) DO UPDATE SET cnt = cnt + 1; "
+                      "INSERT INTO students_coordx_counts (addressCoordX, cnt) VALUES (NEW.addressCoordX, 1) "
+                      "ON CONFLICT(addressCoordX) DO UPDATE SET cnt = cnt + 1; "
+                      "END;")
+        // 删除: 计数减一，归零的计数行一并删除
+        && query.exec("CREATE TRIGGER IF NOT EXISTS trg_students_count_delete AFTER DELETE ON students BEGIN "
+                      "UPDATE students_total SET cnt = cnt - 1 WHERE id = 0; "
+                      "UPDATE students_name_counts SET cnt = cnt - 1 WHERE name = OLD.name; "
+                      "DELETE FROM students_name_counts WHERE name = OLD.name AND cnt <= 0; "
+                      "UPDATE students_coordx_counts SET cnt = cnt - 1 WHERE addressCoordX = OLD.addressCoordX; "
+                      "DELETE FROM students_coordx_counts WHERE addressCoordX = OLD.addressCoordX AND cnt <= 0; "
+                      "END;")
+        // 更新（导入时的 UPSERT 覆盖已有学号）: 从旧键移到新键
+        && query.exec("CREATE TRIGGER IF NOT EXISTS trg_students_count_update AFTER UPDATE OF name, addressCoordX ON students BEGIN "
+                      "UPDATE students_name_counts SET cnt = cnt - 1 WHERE name = OLD.name; "
+                      "DELETE FROM students_name_counts WHERE name = OLD.name AND cnt <= 0; "
+                      "INSERT INTO students_name_counts (name, cnt) VALUES (NEW.name, 1) "
+                      "ON CONFLICT(name) DO UPDATE SET cnt = cnt + 1; "
+                      "UPDATE students_coordx_counts SET cnt = cnt - 1 WHERE addressCoordX = OLD.addressCoordX; "
+                      "DELETE FROM students_coordx_counts WHERE addressCoordX = OLD.addressCoordX AND cnt <= 0; "
+                      "INSERT INTO students_coordx_counts (addressCoordX, cnt) VALUES (NEW.addressCoordX, 1) "
+                      "ON CONFLICT(addressCoordX) DO UPDATE SET cnt = cnt + 1; "
+                      "END;");
+}
+
+bool StudentSchema::dropCountTriggers(QSqlQuery &query)
+{
+    return query.exec("DROP TRIGGER IF EXISTS trg_students_count_insert;")
+        && query.exec("DROP TRIGGER IF EXISTS trg_students_count_delete;")
+        && query.exec("DROP TRIGGER IF EXISTS trg_students_count_update;");
+}
+
+bool StudentSchema::hasCountCache(QSqlQuery &query)
+{
+    return query.exec("SELECT cnt FROM students_total WHERE id = 0") && query.next();
+}
+
+bool StudentSchema::rebuildCountCache(QSqlDatabase &database)
+{
+    // 在一个事务中用 GROUP BY 重新统计，写锁保证期间的插入/删除不会被遗漏或重复计算
+    if (!database.transaction()) {
+        return false;
+    }
+
+    QSqlQuery query(database);
+    if (!recountCountCache(query)) {
+        qWarning() << "Failed to rebuild count cache:" << query.lastError().text();
+        database.rollback();
+        return false;
+    }
+    return database.commit();
+}
+
+bool StudentSchema::recountCountCache(QSqlQuery &query)
+{
+    return query.exec("DELETE FROM students_name_counts;")
+        && query.exec("DELETE FROM students_coordx_counts;")
+        && query.exec("INSERT INTO students_name_counts (name, cnt) "
+                      "SELECT name, COUNT(*) FROM students GROUP BY name;")
+        && query.exec("INSERT INTO students_coordx_counts (addressCoordX, cnt) "
+                      "SELECT addressCoordX, COUNT(*) FROM students GROUP BY addressCoordX;")
+        && query.exec("INSERT OR REPLACE INTO students_total (id, cnt) "
+                      "SELECT 0, COUNT(*) FROM students;");
+}
+
+bool StudentSchema::hasSpatialTable(QSqlQuery &query)
+{
+    return query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'students_rtree'") && query.next();
+}
+
+bool StudentSchema::createSpatialTriggers(QSqlQuery &query)
+{
+    // R树的 id 即 students.id；坐标是点，外接矩形的最小值和最大值相同
+    return query.exec("CREATE TRIGGER IF NOT EXISTS trg_students_rtree_insert AFTER INSERT ON students BEGIN "
+                      "INSERT OR REPLACE INTO students_rtree (id, minX, maxX, minY, maxY) VALUES "
+                      "(NEW.id, NEW.addressCoordX, NEW.addressCoordX, NEW.addressCoordY, NEW.addressCoordY); "
+                      "END;")
+        && query.exec("CREATE TRIGGER IF NOT EXISTS trg_students_rtree_delete AFTER DELETE ON students BEGIN "
+                      "DELETE FROM students_rtree WHERE id = OLD.id; "
+                      "END;")
+        && query.exec("CREATE TRIGGER IF NOT EXISTS trg_students_rtree_update AFTER UPDATE OF addressCoordX, addressCoordY ON students BEGIN "
+                      "UPDATE students_rtree SET minX = NEW.addressCoordX, maxX = NEW.addressCoordX, "
+                      "minY = NEW.addressCoordY, maxY = NEW.addressCoordY WHERE id = NEW.id; "
+                      "END;");
+}
+
+bool StudentSchema::dropSpatialTriggers(QSqlQuery &query)
+{
+    return query.exec("DROP TRIGGER IF EXISTS trg_students_rtree_insert;")
+        && query.exec("DROP TRIGGER IF EXISTS trg_students_rtree_delete;")
+        && query.exec("DROP TRIGGER IF EXISTS trg_students_rtree_update;");
+}
+
+bool StudentSchema::rebuildSpatialIndex(QSqlQuery &query)
+{
+    return query.exec("DELETE FROM students_rtree;")
+        && query.exec("INSERT INTO students_rtree (id, minX, maxX, minY, maxY) "
+                      "SELECT id, addressCoordX, addressCoordX, addressCoordY, addressCoordY FROM students;");
+}
+
+bool StudentSchema::createSpatialIndex(QSqlDatabase &database, QString &error)
+{
+    if (!database.transaction()) {
+        error = database.lastError().text();
+        return false;
+    }
+
+    QSqlQuery ddl(database);
+    const bool success = ddl.exec("CREATE VIRTUAL TABLE IF NOT EXISTS students_rtree "
+                                  "USING rtree_i32(id, minX, maxX, minY, maxY);")
+                         && createSpatialTriggers(ddl)
+                         && rebuildSpatialIndex(ddl);
+    if (!success) {
+        error = ddl.lastError().text();
+        database.rollback();
+        return false;
+    }
+    if (!database.commit()) {
+        error = database.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool StudentSchema::clear(QSqlDatabase &database, bool spatial, QString &error)
+{
+    // 清空时暂时移除计数和R树触发器，避免逐行维护，随后直接把计数表置零、清空R树
+    QSqlQuery query(database);
+    const bool success = database.transaction()
+                         && dropCountTriggers(query)
+                         && (!spatial || dropSpatialTriggers(query))
+                         && query.exec("DELETE FROM students;")
+                         && (!spatial || query.exec("DELETE FROM students_rtree;"))
+                         && (!spatial || createSpatialTriggers(query))
+                         && query.exec("DELETE FROM students_name_counts;")
+                         && query.exec("DELETE FROM students_coordx_counts;")
+                         && query.exec("INSERT OR REPLACE INTO students_total (id, cnt) VALUES (0, 0);")
+                         && createCountTriggers(query)
+                         && database.commit();
+    if (!success) {
+        error = query.lastError().isValid() ? query.lastError().text() : database.lastError().text();
+        database.rollback();
+    }
+    return success;
+}
@@ -0,0 +1,91 @@
+﻿/**
+ * @file       studentschema.h
+ * @brief      students 数据库的表结构、二级索引、计数缓存和R树的建立与维护
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，表结构相关的函数从 MainWindow 中移出，供界面以外的程序使用]
+ *             V1.1:[lzq] [2026-10-17] [students 以 id INTEGER PRIMARY KEY 为主键，R树以 id 引用记录]
+ *
+ * @par        设计说明:
+ *             所有函数都是静态的、不持有状态，只在调用者传入的连接上执行，
+ *             可以在任意线程使用（使用该线程自己的连接）。
+ *             - 计数缓存: students_total / students_name_counts / students_coordx_counts，由触发器维护；
+ *             - 主键: students.id（INTEGER PRIMARY KEY，即 rowid 的别名），VACUUM 和表重建都不会改变，
+ *               学号 studentID 是唯一键；
+ *             - R树: students_rtree（rtree_i32），id 即 students.id，由触发器同步；
+ *             - 批量导入时先删除二级索引和触发器，导入后再重建（见 StudentImporter::importFile()）。
+ */
+
+#ifndef STUDENTSCHEMA_H
+#define STUDENTSCHEMA_H
+
+#include <QString>
+
+class QSqlDatabase;
+class QSqlQuery;
+
+/**
+ * @class StudentSchema
+ * @brief students 数据库的结构维护函数
+ */
+class StudentSchema
+{
+public:
+    /**
+     * @brief 建立字典表、students 表、二级索引和计数表（已存在的对象保持不变）
+     * @param[out] migrated 旧版本的表（以文本保存性别/地址名，或以学号为主键）是否在本次转换为当前格式
+     * @param[out] error    失败时的错误信息
+     * @return 全部建立成功返回true
+     * @note 不建立R树，R树由 createSpatialIndex() 单独建立（大表上耗时较长，适合放到后台）
+     */
+    static bool create(QSqlDatabase& database, bool& migrated, QString& error);
+
+    // 二级索引（批量导入时先删除，导入后重建）
+    static bool createSecondaryIndexes(QSqlQuery& query);
+    static bool dropSecondaryIndexes(QSqlQuery& query);
+
+    // 记录数缓存（由 students 上的触发器维护）
+    static bool createCountTriggers(QSqlQuery& query);
+    static bool dropCountTriggers(QSqlQuery& query);
+
+    /**
+     * @brief students_total 中有记录时计数表已建立，并由触发器维护至今
+     */
+    static bool hasCountCache(QSqlQuery& query);
+
+    /**
+     * @brief 在一个事务中用 GROUP BY 重新统计全部计数
+     */
+    static bool rebuildCountCache(QSqlDatabase& database);
+
+    /**
+     * @brief 用 GROUP BY 重新统计全部计数，事务由调用者负责
+     */
+    static bool recountCountCache(QSqlQuery& query);
+
+    // 坐标R树索引（students_rtree，由触发器与 students 同步）
+    static bool hasSpatialTable(QSqlQuery& query);
+    static bool createSpatialTriggers(QSqlQuery& query);
+    static bool dropSpatialTriggers(QSqlQuery& query);
+    static bool rebuildSpatialIndex(QSqlQuery& query);
+
+    /**
+     * @brief 在一个事务中建立R树、触发器并填充，表存在即说明内容完整
+     * @return 成功返回true；SQLite 未编译 rtree 模块时返回false，范围查询继续使用 X 坐标索引
+     */
+    static bool createSpatialIndex(QSqlDatabase& database, QString& error);
+
+    /**
+     * @brief 删除全部学生记录，计数表置零、R树清空
+     * @param[in] spatial students_rtree 是否存在
+     * @note 期间暂时移除计数和R树触发器，避免逐行维护
+     */
+    static bool clear(QSqlDatabase& database, bool spatial, QString& error);
+};
+
+#endif // STUDENTSCHEMA_H
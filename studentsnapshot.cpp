@@ -0,0 +1,517 @@
+﻿/**
+ * @file       studentsnapshot.cpp
+ * @brief      二进制列式快照的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.1
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [打开时校验各列长度与行数一致]
+ */
+
+#include "studentsnapshot.h"
+#include "connectionmanager.h"
+#include "studentdictionary.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QIODevice>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtEndian>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+    const char Magic[8] = {'S', 'M', 'S', 'S', 'N', 'A', 'P', '\0'};
+    const quint32 FormatVersion = 1;
+
+    enum SectionType : quint32
+    {
+        StringsSection = 1,
+        GendersSection,
+        IdsSection,
+        NamesSection,
+        AddressesSection,
+        GenderCodesSection,
+        BirthDaysSection,
+        CoordXSection,
+        CoordYSection
+    };
+    const int SectionCount = 9;
+
+    const int FileHeaderSize = 8 + 4 + 4 + 8;
+    const int SectionEntrySize = 4 + 4 + 8 + 8;
+    const int HeaderSize = FileHeaderSize + SectionCount * SectionEntrySize + 4;  ///< 含头部CRC
+
+    /**
+     * @brief CRC-32（IEEE 802.3 多项式，与 zlib 相同）
+     */
+    quint32 crc32(const char* data, qint64 size)
+    {
+        static const std::array<quint32, 256> table = [] {
+            std::array<quint32, 256> entries{};
+            for (quint32 i = 0; i < 256; ++i) {
+                quint32 value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                }
+                entries[i] = value;
+            }
+            return entries;
+        }();
+
+        quint32 crc = 0xFFFFFFFFu;
+        const uchar* bytes = reinterpret_cast<const uchar*>(data);
+        for (qint64 i = 0; i < size; ++i) {
+            crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    quint64 zigzag(qint64 value)
+    {
+        return (quint64(value) << 1) ^ quint64(value >> 63);
+    }
+
+    qint64 unzigzag(quint64 value)
+    {
+        return qint64(value >> 1) ^ -qint64(value & 1);
+    }
+
+    void appendVarint(QByteArray& out, quint64 value)
+    {
+        char buffer[10];
+        int length = 0;
+        while (value >= 0x80) {
+            buffer[length++] = char((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        buffer[length++] = char(value);
+        out.append(buffer, length);
+    }
+
+    template<typename T>
+    void appendLittleEndian(QByteArray& out, T value)
+    {
+        char buffer[sizeof(T)];
+        qToLittleEndian(value, buffer);
+        out.append(buffer, int(sizeof(T)));
+    }
+
+    void appendPool(QByteArray& out, const StringPool& pool)
+    {
+        appendLittleEndian<quint32>(out, quint32(pool.size()));
+        for (int id = 0; id < pool.size(); ++id) {
+            const QByteArray text = pool.string(quint32(id)).toUtf8();
+            appendVarint(out, quint64(text.size()));
+            out.append(text);
+        }
+    }
+
+    /**
+     * @brief 定长坐标列: 最小值 + 每值字节数，之后每行 (值 - 最小值)
+     */
+    template<typename Get>
+    QByteArray packCoordinates(const QVector<CompactStudent>& rows, Get get)
+    {
+        qint32 minimum = 0;
+        qint32 maximum = 0;
+        if (!rows.isEmpty()) {
+            minimum = maximum = get(rows.first());
+            for (const CompactStudent& row : rows) {
+                minimum = std::min(minimum, get(row));
+                maximum = std::max(maximum, get(row));
+            }
+        }
+        const quint64 range = quint64(qint64(maximum) - minimum);
+        const quint32 width = range <= 0xFF ? 1 : range <= 0xFFFF ? 2 : 4;
+
+        QByteArray out;
+        out.reserve(8 + rows.size() * int(width));
+        appendLittleEndian<qint32>(out, minimum);
+        appendLittleEndian<quint32>(out, width);
+        for (const CompactStudent& row : rows) {
+            const quint32 offset = quint32(qint64(get(row)) - minimum);
+            char buffer[4];
+            qToLittleEndian(offset, buffer);
+            out.append(buffer, int(width));
+        }
+        return out;
+    }
+}
+
+// ==================== StudentSnapshotWriter ====================
+
+bool StudentSnapshotWriter::append(const Student &student)
+{
+    CompactStudent record;
+    if (!CompactStudent::fromStudent(student, stringPool, record)) {
+        return false;
+    }
+    rows.append(record);
+    return true;
+}
+
+qint64 StudentSnapshotWriter::write(QIODevice &device) const
+{
+    QByteArray sections[SectionCount];
+    const SectionType types[SectionCount] = {
+        StringsSection, GendersSection, IdsSection, NamesSection, AddressesSection,
+        GenderCodesSection, BirthDaysSection, CoordXSection, CoordYSection
+    };
+
+    appendPool(sections[0], stringPool.text);
+    appendPool(sections[1], stringPool.genders);
+
+    qint32 dayBase = 0;
+    bool haveDay = false;
+    for (const CompactStudent &row : rows) {
+        if (row.birthDay != CompactStudent::InvalidDay && (!haveDay || row.birthDay < dayBase)) {
+            dayBase = row.birthDay;
+            haveDay = true;
+        }
+    }
+    appendLittleEndian<qint32>(sections[6], dayBase);
+
+    quint64 previousID = 0;
+    for (const CompactStudent &row : rows) {
+        appendVarint(sections[2], zigzag(qint64(row.id - previousID)));
+        previousID = row.id;
+        appendVarint(sections[3], row.name);
+        appendVarint(sections[4], row.address);
+        sections[5].append(char(row.gender));
+        appendVarint(sections[6], row.birthDay == CompactStudent::InvalidDay
+                                      ? 0 : quint64(qint64(row.birthDay) - dayBase + 1));
+    }
+    sections[7] = packCoordinates(rows, [](const CompactStudent &row) { return row.coordX; });
+    sections[8] = packCoordinates(rows, [](const CompactStudent &row) { return row.coordY; });
+
+    // 文件头 + 段表 + 头部CRC，段数据从8字节对齐处开始
+    QByteArray header;
+    header.append(Magic, sizeof(Magic));
+    appendLittleEndian<quint32>(header, FormatVersion);
+    appendLittleEndian<quint32>(header, quint32(SectionCount));
+    appendLittleEndian<quint64>(header, quint64(rows.size()));
+
+    quint64 offset = (HeaderSize + 7) & ~quint64(7);
+    for (int i = 0; i < SectionCount; ++i) {
+        appendLittleEndian<quint32>(header, types[i]);
+        appendLittleEndian<quint32>(header, crc32(sections[i].constData(), sections[i].size()));
+        appendLittleEndian<quint64>(header, offset);
+        appendLittleEndian<quint64>(header, quint64(sections[i].size()));
+        offset = (offset + quint64(sections[i].size()) + 7) & ~quint64(7);
+    }
+    appendLittleEndian<quint32>(header, crc32(header.constData(), header.size()));
+
+    qint64 written = 0;
+    auto writeBytes = [&](const QByteArray &bytes) {
+        const qint64 padding = (8 - (written + bytes.size()) % 8) % 8;
+        if (device.write(bytes) != bytes.size()) {
+            return false;
+        }
+        if (padding > 0 && device.write(QByteArray(int(padding), '\0')) != padding) {
+            return false;
+        }
+        written += bytes.size() + padding;
+        return true;
+    };
+    if (!writeBytes(header)) {
+        return -1;
+    }
+    for (const QByteArray &section : sections) {
+        if (!writeBytes(section)) {
+            return -1;
+        }
+    }
+    return written;
+}
+
+SnapshotResult StudentSnapshotWriter::saveDatabase(const QString &filePath)
+{
+    SnapshotResult result;
+    StudentSnapshotWriter writer;
+    StudentStringPool &pool = writer.pool();
+
+    // 库中的性别/地址编号 -> 快照字典编号，每个不同的值只解码一次
+    QHash<int, quint32> addressIDs;
+    QHash<int, quint8> genderCodes;
+    StudentDictionary &dictionary = StudentDictionary::instance();
+
+    QSqlQuery &query = ConnectionManager::instance().statement(
+        "SELECT studentID, name, birthDate, gender, addressName, addressCoordX, addressCoordY "
+        "FROM students ORDER BY studentID");
+    if (!query.isForwardOnly()) {
+        query.setForwardOnly(true);
+    }
+    if (!query.exec()) {
+        result.status = SnapshotResult::QueryFailed;
+        result.error = query.lastError().text();
+        return result;
+    }
+
+    while (query.next()) {
+        CompactStudent record;
+        record.id = CompactStudent::encodeID(query.value(0).toString(), pool);
+        record.name = pool.text.intern(query.value(1).toString());
+
+        const QDate birthDate = query.value(2).toDate();
+        record.birthDay = birthDate.isValid() ? qint32(birthDate.toJulianDay()) : CompactStudent::InvalidDay;
+
+        const int genderID = query.value(3).toInt();
+        auto gender = genderCodes.constFind(genderID);
+        if (gender == genderCodes.constEnd()) {
+            quint8 code;
+            if (!pool.internGender(dictionary.text(genderID), code)) {
+                query.finish();
+                result.status = SnapshotResult::QueryFailed;
+                result.error = "Too many distinct gender values for the snapshot format";
+                return result;
+            }
+            gender = genderCodes.insert(genderID, code);
+        }
+        record.gender = gender.value();
+
+        const int addressID = query.value(4).toInt();
+        auto address = addressIDs.constFind(addressID);
+        if (address == addressIDs.constEnd()) {
+            address = addressIDs.insert(addressID, pool.text.intern(dictionary.text(addressID)));
+        }
+        record.address = address.value();
+
+        record.coordX = query.value(5).toInt();
+        record.coordY = query.value(6).toInt();
+        writer.append(record);
+    }
+    query.finish();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        result.status = SnapshotResult::FileOpenFailed;
+        result.error = file.errorString();
+        return result;
+    }
+    result.bytesWritten = writer.write(file);
+    if (result.bytesWritten < 0 || !file.flush()) {
+        result.status = SnapshotResult::WriteFailed;
+        result.error = file.errorString();
+        result.bytesWritten = 0;
+        return result;
+    }
+    result.recordCount = writer.rowCount();
+    return result;
+}
+
+// ==================== StudentSnapshotReader ====================
+
+StudentSnapshotReader::StudentSnapshotReader()
+    : state(Ok), rows(0), decoded(0), lastID(0), dayBase(0), minX(0), minY(0), widthX(1), widthY(1)
+{
+}
+
+bool StudentSnapshotReader::isSnapshot(const char *begin, const char *end)
+{
+    return end - begin >= qint64(sizeof(Magic)) && std::memcmp(begin, Magic, sizeof(Magic)) == 0;
+}
+
+bool StudentSnapshotReader::fail(Status status, const QString &message)
+{
+    state = status;
+    error = message;
+    return false;
+}
+
+bool StudentSnapshotReader::open(const QString &filePath)
+{
+    if (!file.open(filePath)) {
+        return fail(FileOpenFailed, file.errorString());
+    }
+    return open(file.begin(), file.end());
+}
+
+bool StudentSnapshotReader::open(const char *begin, const char *end)
+{
+    state = Ok;
+    error.clear();
+    stringPool.clear();
+    rows = 0;
+    decoded = 0;
+    lastID = 0;
+
+    const qint64 length = end - begin;
+    if (!isSnapshot(begin, end) || length < HeaderSize) {
+        return fail(FormatError, "Not a student snapshot file");
+    }
+    const quint32 version = qFromLittleEndian<quint32>(begin + 8);
+    const quint32 sections = qFromLittleEndian<quint32>(begin + 12);
+    if (version != FormatVersion || sections != quint32(SectionCount)) {
+        return fail(FormatError, QString("Unsupported snapshot version %1").arg(version));
+    }
+    if (qFromLittleEndian<quint32>(begin + HeaderSize - 4) != crc32(begin, HeaderSize - 4)) {
+        return fail(ChecksumMismatch, "Snapshot header is corrupted");
+    }
+    const quint64 rowCount = qFromLittleEndian<quint64>(begin + 16);
+    if (rowCount > quint64(length)) {  // 每行至少占若干字节
+        return fail(FormatError, "Invalid row count");
+    }
+    rows = qint64(rowCount);
+
+    // 定位并校验各段
+    Column columns[SectionCount];
+    for (int i = 0; i < SectionCount; ++i) {
+        const char *entry = begin + FileHeaderSize + i * SectionEntrySize;
+        const quint32 type = qFromLittleEndian<quint32>(entry);
+        const quint32 crc = qFromLittleEndian<quint32>(entry + 4);
+        const quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+        const quint64 size = qFromLittleEndian<quint64>(entry + 16);
+        if (type != quint32(StringsSection + i) || offset > quint64(length) || size > quint64(length) - offset) {
+            return fail(FormatError, "Invalid section table");
+        }
+        columns[i].position = begin + offset;
+        columns[i].end = begin + offset + size;
+        if (crc32(columns[i].position, qint64(size)) != crc) {
+            return fail(ChecksumMismatch, QString("Snapshot section %1 is corrupted").arg(type));
+        }
+    }
+
+    // 字典: 按编号顺序重建，编号必须与文件中的顺序一致
+    auto readPool = [&](Column &column, StringPool &pool, quint32 maxCount) {
+        if (column.end - column.position < 4) {
+            return false;
+        }
+        const quint32 count = qFromLittleEndian<quint32>(column.position);
+        column.position += 4;
+        if (count == 0 || count > maxCount) {
+            return false;
+        }
+        for (quint32 id = 0; id < count; ++id) {
+            quint64 size;
+            if (!readVarint(column, size) || size > quint64(column.end - column.position)) {
+                return false;
+            }
+            const QString text = QString::fromUtf8(column.position, int(size));
+            column.position += size;
+            if (pool.intern(text) != id) {
+                return false; // 重复的字典项
+            }
+        }
+        return true;
+    };
+    if (!readPool(columns[0], stringPool.text, 0xFFFFFFFFu)
+        || !readPool(columns[1], stringPool.genders, StudentStringPool::MaxGenders)) {
+        return fail(FormatError, "Invalid string dictionary");
+    }
+
+    // 定长列的长度必须与行数一致，变长列每行至少1字节；不一致说明文件被截断或拼接，
+    // 在解码任何一行之前就拒绝，而不是导入到一半才失败
+    const quint64 rowBytes = rowCount;
+    auto columnSize = [&](int index) { return quint64(columns[index].end - columns[index].position); };
+    if (columnSize(2) < rowBytes || columnSize(3) < rowBytes || columnSize(4) < rowBytes
+        || columnSize(5) != rowBytes || columnSize(6) < 4 + rowBytes) {
+        return fail(FormatError, "Column length does not match row count");
+    }
+
+    ids = columns[2];
+    names = columns[3];
+    addresses = columns[4];
+    genders = columns[5];
+    birthDays = columns[6];
+    coordXs = columns[7];
+    coordYs = columns[8];
+
+    auto readCoordinateHeader = [rowCount](Column &column, qint32 &minimum, int &width) {
+        if (column.end - column.position < 8) {
+            return false;
+        }
+        minimum = qFromLittleEndian<qint32>(column.position);
+        width = int(qFromLittleEndian<quint32>(column.position + 4));
+        column.position += 8;
+        return (width == 1 || width == 2 || width == 4)
+               && quint64(column.end - column.position) == rowCount * quint64(width);
+    };
+    if (!readCoordinateHeader(coordXs, minX, widthX)
+        || !readCoordinateHeader(coordYs, minY, widthY)) {
+        return fail(FormatError, "Invalid column header");
+    }
+    dayBase = qFromLittleEndian<qint32>(birthDays.position);
+    birthDays.position += 4;
+    return true;
+}
+
+bool StudentSnapshotReader::readVarint(Column &column, quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && column.position < column.end; shift += 7) {
+        const uchar byte = uchar(*column.position++);
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StudentSnapshotReader::readFixed(Column &column, int width, qint32 minimum, qint32 &value)
+{
+    if (column.end - column.position < width) {
+        return false;
+    }
+    quint32 offset = 0;
+    switch (width) {
+    case 1: offset = uchar(*column.position); break;
+    case 2: offset = qFromLittleEndian<quint16>(column.position); break;
+    default: offset = qFromLittleEndian<quint32>(column.position); break;
+    }
+    column.position += width;
+    value = qint32(qint64(minimum) + offset);
+    return true;
+}
+
+bool StudentSnapshotReader::next(CompactStudent &record)
+{
+    if (state != Ok || decoded >= rows) {
+        return false;
+    }
+
+    quint64 delta, name, address, day;
+    if (!readVarint(ids, delta) || !readVarint(names, name) || !readVarint(addresses, address)
+        || !readVarint(birthDays, day) || genders.position >= genders.end
+        || !readFixed(coordXs, widthX, minX, record.coordX)
+        || !readFixed(coordYs, widthY, minY, record.coordY)) {
+        return fail(FormatError, QString("Snapshot truncated at row %1").arg(decoded));
+    }
+
+    lastID += quint64(unzigzag(delta));
+    record.id = lastID;
+    record.name = quint32(name);
+    record.address = quint32(address);
+    record.gender = quint8(*genders.position++);
+    record.birthDay = day == 0 ? CompactStudent::InvalidDay : qint32(qint64(dayBase) + qint64(day) - 1);
+
+    const quint64 textCount = quint64(stringPool.text.size());
+    if (name >= textCount || address >= textCount || record.gender >= stringPool.genders.size()
+        || ((record.id & CompactStudent::PooledIDFlag) && (record.id & ~CompactStudent::PooledIDFlag) >= textCount)) {
+        return fail(FormatError, QString("Invalid dictionary reference at row %1").arg(decoded));
+    }
+
+    ++decoded;
+    return true;
+}
+
+bool StudentSnapshotReader::next(Student &student)
+{
+    CompactStudent record;
+    if (!next(record)) {
+        return false;
+    }
+    student = record.toStudent(stringPool);
+    return true;
+}
@@ -0,0 +1,188 @@
+﻿/**
+ * @file       studentsnapshot.h
+ * @brief      整个通讯录的二进制列式快照（保存与恢复）
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，定义快照格式及其读写]
+ *
+ * @par        文件格式（版本1，所有整数均为小端）:
+ *             文件头: 魔数 "SMSSNAP\0"(8) | 版本 quint32 | 段数 quint32 | 行数 quint64
+ *             段表:   每段 { 类型 quint32 | CRC32 quint32 | 偏移 quint64 | 长度 quint64 }
+ *             文件头和段表之后是它们的 CRC32(quint32)，随后是各段数据（8字节对齐）:
+ *             - Strings / Genders: 字典，quint32 个数，之后每项为 varint 长度 + UTF-8 字节；
+ *               姓名、地址、非数字学号共用 Strings，性别单独一个字典（见 compactstudent.h）
+ *             - IDs:       学号按 CompactStudent 编码为64位整数，逐行存与上一行之差的 zigzag varint；
+ *                          按学号排序保存时相邻差值很小，通常每行1字节
+ *             - Names / Addresses: 字典编号的 varint
+ *             - GenderCodes: 每行1字节
+ *             - BirthDays: qint32 基准日，之后每行 varint(儒略日 - 基准日 + 1)，0 表示无效日期
+ *             - CoordX / CoordY: qint32 最小值 + quint32 每值字节数(1/2/4)，之后定长存放 (值 - 最小值)
+ *             每段单独校验CRC32，读取时任一段损坏都会报告 ChecksumMismatch。
+ *
+ * @par        设计说明:
+ *             按列存放让同类数据相邻，字典编号和差值都能用很少的字节表示，百万行快照只有
+ *             文本导出文件的几分之一。读取时文件整体内存映射（MappedFile），
+ *             StudentSnapshotReader 在映射区域上按列游标逐行解码，不需要先把整个文件读入内存。
+ *             写入需要先收集全部行（按 CompactStudent 每行32字节）再按列输出。
+ */
+
+#ifndef STUDENTSNAPSHOT_H
+#define STUDENTSNAPSHOT_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "compactstudent.h"
+#include "csvreader.h"
+
+class QIODevice;
+
+/**
+ * @struct SnapshotResult
+ * @brief 一次快照保存的结果
+ */
+struct SnapshotResult
+{
+    enum Status
+    {
+        Ok,              ///< 完成
+        FileOpenFailed,  ///< 无法创建或打开文件
+        QueryFailed,     ///< 读取数据库失败
+        WriteFailed      ///< 写入文件失败
+    };
+
+    Status status = Ok;
+    qint64 recordCount = 0;
+    qint64 bytesWritten = 0;
+    QString error;
+};
+
+/**
+ * @class StudentSnapshotWriter
+ * @brief 收集紧凑记录并按列写出快照
+ */
+class StudentSnapshotWriter
+{
+public:
+    /**
+     * @brief 追加一条记录，字符串字段加入快照的字典
+     * @return 性别种类超过256时返回false
+     */
+    bool append(const Student& student);
+
+    /**
+     * @brief 追加一条已按 pool() 编码的记录
+     */
+    void append(const CompactStudent& record) { rows.append(record); }
+
+    StudentStringPool& pool() { return stringPool; }
+    qint64 rowCount() const { return rows.size(); }
+
+    /**
+     * @brief 把快照写入设备
+     * @return 写入的字节数，失败时返回 -1
+     */
+    qint64 write(QIODevice& device) const;
+
+    /**
+     * @brief 把 students 表按学号顺序保存为快照文件（在调用线程的连接上读取）
+     */
+    static SnapshotResult saveDatabase(const QString& filePath);
+
+private:
+    StudentStringPool stringPool;
+    QVector<CompactStudent> rows;
+};
+
+/**
+ * @class StudentSnapshotReader
+ * @brief 在内存映射的快照上逐行解码
+ */
+class StudentSnapshotReader
+{
+public:
+    enum Status
+    {
+        Ok,
+        FileOpenFailed,    ///< 无法打开文件
+        FormatError,       ///< 不是快照文件、版本不支持或结构不完整
+        ChecksumMismatch   ///< 校验和不符，文件已损坏
+    };
+
+    StudentSnapshotReader();
+
+    /**
+     * @brief 判断数据是否以快照魔数开头
+     */
+    static bool isSnapshot(const char* begin, const char* end);
+
+    /**
+     * @brief 打开快照文件（内存映射）并校验
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 在调用者提供的内存区域上打开快照并校验，区域在读取期间必须保持有效
+     */
+    bool open(const char* begin, const char* end);
+
+    Status status() const { return state; }
+    QString errorString() const { return error; }
+
+    qint64 rowCount() const { return rows; }
+    const StudentStringPool& pool() const { return stringPool; }
+
+    /**
+     * @brief 按保存顺序解码下一条记录
+     * @return 已读完或数据损坏时返回false（损坏时 status() 为 FormatError）
+     */
+    bool next(CompactStudent& record);
+
+    /**
+     * @brief 按保存顺序解码下一条记录并还原为 Student
+     */
+    bool next(Student& student);
+
+private:
+    /**
+     * @brief 列游标: 指向某一段中下一个待解码的字节
+     */
+    struct Column
+    {
+        const char* position = nullptr;
+        const char* end = nullptr;
+    };
+
+    bool fail(Status status, const QString& message);
+    bool readVarint(Column& column, quint64& value);
+    bool readFixed(Column& column, int width, qint32 minimum, qint32& value);
+
+    MappedFile file;
+    StudentStringPool stringPool;
+    Status state;
+    QString error;
+    qint64 rows;
+    qint64 decoded;
+
+    Column ids;
+    Column names;
+    Column addresses;
+    Column genders;
+    Column birthDays;
+    Column coordXs;
+    Column coordYs;
+    quint64 lastID;
+    qint32 dayBase;
+    qint32 minX;
+    qint32 minY;
+    int widthX;
+    int widthY;
+};
+
+#endif // STUDENTSNAPSHOT_H
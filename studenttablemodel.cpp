@@ -0,0 +1,258 @@
+﻿/**
+ * @file       studenttablemodel.cpp
+ * @brief      按需分块加载查询结果的表格模型的实现
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.3
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *             V1.1:[lzq] [2026-10-17] [增加坐标范围条件、按距离排序和k近邻半径查询]
+ *             V1.2:[lzq] [2026-10-17] [cursorOf() 改为静态函数，供基准测试定位任意一页]
+ *             V1.3:[lzq] [2026-10-17] [SQL 移入 StudentRepository，readBlock() 只保留放弃检查]
+ */
+
+#include "studenttablemodel.h"
+
+#include <QMetaObject>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+StudentTableModel::StudentTableModel(QObject *parent)
+    : QAbstractTableModel(parent),
+      currentQuery{QString(), QVariant(), "studentID", false},
+      active(false),
+      reachedEnd(true),
+      appendPending(false),
+      loadedRows(0),
+      blocks(MaxCachedBlocks),
+      generation(std::make_shared<QAtomicInt>(0))
+{
+}
+
+void StudentTableModel::setQuery(const Query &query)
+{
+    beginResetModel();
+    generation->ref();
+    currentQuery = query;
+    active = true;
+    reachedEnd = false;
+    appendPending = false;
+    loadedRows = 0;
+    blockEnds.clear();
+    blocks.clear();
+    pendingBlocks.clear();
+    endResetModel();
+
+    // 不等视图布局，立即开始读取第一块
+    fetchMore(QModelIndex());
+}
+
+void StudentTableModel::clear()
+{
+    beginResetModel();
+    generation->ref();
+    active = false;
+    reachedEnd = true;
+    appendPending = false;
+    loadedRows = 0;
+    blockEnds.clear();
+    blocks.clear();
+    pendingBlocks.clear();
+    endResetModel();
+}
+
+int StudentTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : loadedRows;
+}
+
+int StudentTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    // 距离列只对圆形范围查询有意义
+    return currentQuery.region == Query::CircleRegion ? ColumnCount : DistanceColumn;
+}
+
+QVariant StudentTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= loadedRows) {
+        return QVariant();
+    }
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() >= CoordXColumn ? QVariant(int(Qt::AlignRight | Qt::AlignVCenter)) : QVariant();
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const int block = index.row() / BlockRows;
+    const QVector<Student> *rows = blocks.object(block);
+    if (!rows) {
+        // 块已被淘汰: 在后台重新读取，完成后通过 dataChanged 刷新。
+        // data() 必须是 const，这里只改变缓存，不改变模型对外的内容
+        const_cast<StudentTableModel *>(this)->loadBlock(block);
+        return QVariant();
+    }
+
+    const int offset = index.row() % BlockRows;
+    if (offset >= rows->size()) {
+        return QVariant(); // 重新读取时数据已变少（期间删除了记录）
+    }
+
+    const Student &student = rows->at(offset);
+    switch (index.column()) {
+    case IdColumn:        return student.studentID;
+    case NameColumn:      return student.name;
+    case BirthDateColumn: return student.birthDate.toString("yyyy-MM-dd");
+    case GenderColumn:    return student.gender;
+    case AddressColumn:   return student.addressName;
+    case CoordXColumn:    return student.addressCoordX;
+    case CoordYColumn:    return student.addressCoordY;
+    case DistanceColumn: {
+        const qint64 dx = qint64(student.addressCoordX) - currentQuery.centerX;
+        const qint64 dy = qint64(student.addressCoordY) - currentQuery.centerY;
+        return QString::number(std::sqrt(double(dx * dx + dy * dy)), 'f', 1);
+    }
+    default:              return QVariant();
+    }
+}
+
+QVariant StudentTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+
+    switch (section) {
+    case IdColumn:        return "ID";
+    case NameColumn:      return "Name";
+    case BirthDateColumn: return "Birth Date";
+    case GenderColumn:    return "Gender";
+    case AddressColumn:   return "Address";
+    case CoordXColumn:    return "X";
+    case CoordYColumn:    return "Y";
+    case DistanceColumn:  return "Distance";
+    default:              return QVariant();
+    }
+}
+
+bool StudentTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && active && !reachedEnd && !appendPending;
+}
+
+void StudentTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    appendPending = true;
+    loadBlock(blockEnds.size());
+}
+
+/**
+ * @brief 第 block 块应读取的行数，有 maxRows 限制时最后一块可能不足 BlockRows
+ */
+int StudentTableModel::blockLimit(int block) const
+{
+    if (currentQuery.maxRows <= 0) {
+        return BlockRows;
+    }
+    return std::max(0, std::min(BlockRows, currentQuery.maxRows - block * BlockRows));
+}
+
+/**
+ * @brief 在工作线程读取第 block 块；block 等于已发现的块数时是追加，否则是重新读取被淘汰的块
+ */
+void StudentTableModel::loadBlock(int block)
+{
+    if (block < blockEnds.size()) {
+        if (pendingBlocks.contains(block)) {
+            return;
+        }
+        pendingBlocks.insert(block);
+    }
+
+    const Query query = currentQuery;
+    const int limit = blockLimit(block);
+    const bool hasCursor = block > 0;
+    const Cursor after = hasCursor ? blockEnds.at(block - 1) : Cursor();
+    const int current = generation->loadRelaxed();
+    std::shared_ptr<QAtomicInt> latest = generation;
+
+    (void)QtConcurrent::run([this, query, limit, hasCursor, after, block, current, latest]() {
+        QVector<Student> rows;
+        QString error;
+        if (!readBlock(query, hasCursor ? &after : nullptr, limit, *latest, current, rows, error)
+            && error.isEmpty()) {
+            return; // 已被新查询取代
+        }
+        QMetaObject::invokeMethod(this, [this, current, block, rows, error]() {
+            onBlockLoaded(current, block, rows, error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void StudentTableModel::onBlockLoaded(int loadGeneration, int block, const QVector<Student> &rows, const QString &error)
+{
+    if (loadGeneration != generation->loadRelaxed()) {
+        return;
+    }
+
+    const bool append = (block == blockEnds.size());
+    if (append) {
+        appendPending = false;
+    } else {
+        pendingBlocks.remove(block);
+    }
+
+    if (!error.isEmpty()) {
+        if (append) {
+            reachedEnd = true; // 不再自动重试，避免视图反复调用 fetchMore
+        }
+        emit queryFailed(error);
+        return;
+    }
+
+    if (!append) {
+        blocks.insert(block, new QVector<Student>(rows));
+        const int first = block * BlockRows;
+        const int last = std::min(loadedRows, first + BlockRows) - 1;
+        if (first <= last) {
+            emit dataChanged(index(first, 0), index(last, columnCount() - 1));
+        }
+        return;
+    }
+
+    // 不足一块，或已读满 maxRows 行，说明已经读到末尾
+    reachedEnd = rows.size() < BlockRows
+                 || (currentQuery.maxRows > 0 && loadedRows + rows.size() >= currentQuery.maxRows);
+    if (!rows.isEmpty()) {
+        beginInsertRows(QModelIndex(), loadedRows, loadedRows + rows.size() - 1);
+        blockEnds.append(StudentRepository::cursorOf(currentQuery, rows.last()));
+        blocks.insert(block, new QVector<Student>(rows));
+        loadedRows += rows.size();
+        endInsertRows();
+    }
+    emit rowsFetched(loadedRows, reachedEnd);
+}
+
+bool StudentTableModel::readBlock(const Query &query, const Cursor *after, int limit,
+                                  const QAtomicInt &latest, int generation,
+                                  QVector<Student> &rows, QString &error)
+{
+    // 执行前和每读一行检查一次，切换查询后旧的读取尽快让出线程
+    return StudentRepository::readPage(query, after, limit, rows, error, [&latest, generation]() {
+        return latest.loadRelaxed() != generation;
+    });
+}
@@ -0,0 +1,137 @@
+﻿/**
+ * @file       studenttablemodel.h
+ * @brief      按需分块加载查询结果的表格模型
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.3
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件，用表格视图代替固定100行一页的文本输出]
+ *             V1.1:[lzq] [2026-10-17] [查询支持坐标的矩形/圆形范围条件，圆形范围按距离排序，支持k近邻]
+ *             V1.2:[lzq] [2026-10-17] [公开 cursorOf()，可从任意一行构造键集游标]
+ *             V1.3:[lzq] [2026-10-17] [查询形状、SQL 和范围/k近邻查询移入 StudentRepository，模型只负责分块缓存]
+ *
+ * @par        设计说明:
+ *             结果按 BlockRows 行分块，从数据库读取时以键集游标定位（与原分页查询相同）:
+ *             - 视图滚动到已加载行的末尾时调用 fetchMore()，在工作线程读取下一块并追加，
+ *               canFetchMore() 在读到不足一块时返回false；
+ *             - 块的内容放在有界的 QCache 中，最多 MaxCachedBlocks 块，超出时淘汰最久未用的块；
+ *             - 每块只永久保留最后一行的游标（几十字节），被淘汰的块再次可见时从前一块的游标
+ *               重新读取，读取完成前对应单元格为空，完成后发出 dataChanged。
+ *             因此无论滚动多远，内存中的记录数都不超过 BlockRows * MaxCachedBlocks，
+ *             视图只为可见的行调用 data()，渲染代价与结果总数无关。
+ *             所有读取都在 QtConcurrent 线程池中用该线程的连接执行，界面线程不等待SQLite；
+ *             setQuery()/clear() 后尚未完成的读取结果会被丢弃。
+ *
+ *             每块由 StudentRepository::readPage() 读取，查询形状（过滤条件、坐标范围、排序）
+ *             和键集游标都沿用 StudentRepository 的定义，见 studentrepository.h。
+ */
+
+#ifndef STUDENTTABLEMODEL_H
+#define STUDENTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QAtomicInt>
+#include <QCache>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <QtGlobal>
+
+#include <memory>
+
+#include "student.h"
+#include "studentrepository.h"
+
+/**
+ * @class StudentTableModel
+ * @brief 学生记录的只读表格模型，每行一名学生，每列一个字段
+ */
+class StudentTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    typedef StudentRepository::Query Query;
+    typedef StudentRepository::Cursor Cursor;
+
+    enum Column
+    {
+        IdColumn,
+        NameColumn,
+        BirthDateColumn,
+        GenderColumn,
+        AddressColumn,
+        CoordXColumn,
+        CoordYColumn,
+        DistanceColumn,  ///< 到圆心的距离，仅圆形范围查询显示
+        ColumnCount
+    };
+
+    static constexpr int BlockRows = StudentRepository::DefaultPageRows;  ///< 每次读取的行数
+    static constexpr int MaxCachedBlocks = 64;   ///< 内存中最多保留的块数
+
+    explicit StudentTableModel(QObject* parent = nullptr);
+
+    /**
+     * @brief 切换到新的查询，清空已加载的行并开始读取第一块
+     */
+    void setQuery(const Query& query);
+
+    /**
+     * @brief 清空模型，丢弃尚未完成的读取
+     */
+    void clear();
+
+    bool isActive() const { return active; }
+    bool atEnd() const { return reachedEnd; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    /**
+     * @brief 读取一块记录（在调用线程的连接上执行）
+     * @param[in] latest     最新查询的序号，与 generation 不一致时放弃读取
+     * @param[in] generation 本次读取所属查询的序号
+     * @return 读取完成返回true；失败或被放弃返回false（被放弃时 error 为空）
+     * @see StudentRepository::readPage()
+     */
+    static bool readBlock(const Query& query, const Cursor* after, int limit,
+                          const QAtomicInt& latest, int generation,
+                          QVector<Student>& rows, QString& error);
+
+signals:
+    /**
+     * @brief fetchMore() 追加的一块读取完成
+     * @param loadedRows 当前已发现的总行数
+     * @param atEnd      是否已读到结果末尾
+     */
+    void rowsFetched(int loadedRows, bool atEnd);
+
+    void queryFailed(const QString& error);
+
+private:
+    int blockLimit(int block) const;
+    void loadBlock(int block);
+    void onBlockLoaded(int generation, int block, const QVector<Student>& rows, const QString& error);
+
+    Query currentQuery;
+    bool active;
+    bool reachedEnd;
+    bool appendPending;                       ///< fetchMore() 发起的读取尚未完成
+    int loadedRows;                           ///< 已发现的行数，即 rowCount()
+    QVector<Cursor> blockEnds;                ///< 每个已发现块的最后一行
+    mutable QCache<int, QVector<Student>> blocks;  ///< 块号 -> 块内记录（有界）
+    QSet<int> pendingBlocks;                  ///< 正在重新读取的块
+    std::shared_ptr<QAtomicInt> generation;   ///< 当前查询的序号，工作线程据此放弃过期读取
+};
+
+#endif // STUDENTTABLEMODEL_H
@@ -0,0 +1,56 @@
+﻿/**
+ * @file       testcheck.h
+ * @brief      单元测试使用的最小断言工具
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *
+ * @par        设计说明:
+ *             测试程序不依赖 QtTest: CHECK 失败时打印位置和表达式并计数，main() 最后返回
+ *             testResult()，有失败时为非零，qmake 的 make check 据此判断测试是否通过。
+ */
+
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <cstdio>
+
+/**
+ * @brief 本测试程序中失败的检查数
+ */
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * @brief 检查条件，失败时打印位置并继续执行后面的检查
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++testFailures(); \
+        } \
+    } while (0)
+
+/**
+ * @brief 打印结果并返回进程退出码
+ */
+inline int testResult(const char* name)
+{
+    if (testFailures() == 0) {
+        std::printf("PASS %s\n", name);
+        return 0;
+    }
+    std::printf("FAIL %s: %d check(s) failed\n", name, testFailures());
+    return 1;
+}
+
+#endif // TESTCHECK_H
@@ -0,0 +1,11 @@
+# 测试程序的公共配置，由 tests/ 下的各测试项目包含
+QT += core
+QT -= gui
+TEMPLATE = app
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD $$PWD/..
+DEPENDPATH += $$PWD/..
+
+HEADERS += $$PWD/testcheck.h
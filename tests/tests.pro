@@ -0,0 +1,4 @@
+# 单元测试: 每个测试是一个返回非零表示失败的控制台程序，在构建目录中执行 make check 运行全部测试
+TEMPLATE = subdirs
+
+SUBDIRS += tst_binarysearchtree tst_bplustree tst_compactstudent tst_delimiterscanner tst_studentsnapshot tst_counttriggers
@@ -0,0 +1,187 @@
+﻿/**
+ * @file       tst_binarysearchtree.cpp
+ * @brief      BinarySearchTree 的AVL平衡和顺序统计测试
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ *
+ * @par        用法:
+ *             tst_binarysearchtree [有序插入的记录数]，默认100万条（make check 使用），
+ *             需要验证千万级时传入 10000000（约需1.5GB内存）。
+ */
+
+#include "binarysearchtree.h"
+#include "student.h"
+#include "testcheck.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+    QString studentID(int i)
+    {
+        // 位数相同，字符串顺序与数值顺序一致
+        return QString::number(qint64(2025000000) + i);
+    }
+
+    Student makeStudent(int i)
+    {
+        Student student;
+        student.studentID = studentID(i);
+        return student;
+    }
+
+    /**
+     * @brief AVL树高的上界 1.44 * log2(n + 2)
+     */
+    double heightBound(int n)
+    {
+        return 1.44 * std::log2(double(n) + 2);
+    }
+
+    /**
+     * @brief 按学号递增顺序插入 n 条记录，树高仍受AVL上界约束，迭代和顺序统计结果正确
+     */
+    void testSortedInsert(int n)
+    {
+        BinarySearchTree<Student> tree;
+        int rejected = 0;
+        for (int i = 0; i < n; ++i) {
+            if (!tree.insert(makeStudent(i))) {
+                ++rejected;
+            }
+        }
+        CHECK(rejected == 0);
+        CHECK(tree.size() == n);
+        CHECK(tree.height() <= heightBound(n));
+        CHECK(!tree.insert(makeStudent(n / 2)));
+
+        int position = 0;
+        bool ordered = true;
+        for (const Student &student : tree) {
+            ordered = ordered && student.studentID == studentID(position);
+            ++position;
+        }
+        CHECK(ordered);
+        CHECK(position == n);
+
+        for (int k : {0, 1, n / 3, n / 2, n - 2, n - 1}) {
+            Student student;
+            CHECK(tree.select(k, student) && student.studentID == studentID(k));
+            CHECK(tree.rank(studentID(k)) == k);
+        }
+        Student student;
+        CHECK(!tree.select(n, student));
+        CHECK(tree.rank(studentID(n)) == -1);
+    }
+
+    /**
+     * @brief 按学号递减顺序插入，再从两端交替删除，每一步之后树高都受AVL上界约束
+     */
+    void testDescendingInsertAndDelete(int n)
+    {
+        BinarySearchTree<Student> tree;
+        for (int i = n - 1; i >= 0; --i) {
+            tree.insert(makeStudent(i));
+        }
+        CHECK(tree.size() == n);
+        CHECK(tree.height() <= heightBound(n));
+
+        bool balanced = true;
+        for (int low = 0, high = n - 1; low < high; ++low, --high) {
+            CHECK(tree.deleteStudent(studentID(low)));
+            CHECK(tree.deleteStudent(studentID(high)));
+            balanced = balanced && tree.height() <= heightBound(tree.size());
+        }
+        CHECK(balanced);
+        CHECK(tree.size() == n % 2);
+    }
+
+    /**
+     * @brief 随机交替插入和删除，定期与有序的参照模型比较 size/rank/select
+     */
+    void testInterleavedDeletes()
+    {
+        const int universe = 20000;
+        const int steps = 200000;
+        std::mt19937 random(20261017);
+        std::uniform_int_distribution<int> pick(0, universe - 1);
+
+        BinarySearchTree<Student> tree;
+        std::vector<bool> present(universe, false);
+        int presentCount = 0;
+
+        for (int step = 1; step <= steps; ++step) {
+            const int i = pick(random);
+            if (present[i]) {
+                CHECK(!tree.insert(makeStudent(i)));
+                CHECK(tree.deleteStudent(studentID(i)));
+                CHECK(!tree.deleteStudent(studentID(i)));
+                --presentCount;
+            } else {
+                CHECK(!tree.deleteStudent(studentID(i)));
+                CHECK(tree.insert(makeStudent(i)));
+                ++presentCount;
+            }
+            present[i] = !present[i];
+
+            if (step % 5000 != 0) {
+                continue;
+            }
+
+            // 参照模型: 按学号升序排列的现存记录
+            std::vector<int> ordered;
+            for (int j = 0; j < universe; ++j) {
+                if (present[j]) {
+                    ordered.push_back(j);
+                }
+            }
+            CHECK(tree.size() == presentCount);
+            CHECK(tree.size() == int(ordered.size()));
+            CHECK(tree.height() <= heightBound(tree.size()));
+
+            bool statisticsMatch = true;
+            for (int k = 0; k < int(ordered.size()); k += 97) {
+                Student student;
+                statisticsMatch = statisticsMatch
+                    && tree.select(k, student) && student.studentID == studentID(ordered[k])
+                    && tree.rank(studentID(ordered[k])) == k;
+            }
+            CHECK(statisticsMatch);
+
+            bool absentHaveNoRank = true;
+            for (int j = 0; j < universe; j += 101) {
+                absentHaveNoRank = absentHaveNoRank && (present[j] || tree.rank(studentID(j)) == -1);
+            }
+            CHECK(absentHaveNoRank);
+
+            int position = 0;
+            bool iterationMatches = true;
+            for (const Student &student : tree) {
+                iterationMatches = iterationMatches && position < int(ordered.size())
+                    && student.studentID == studentID(ordered[position]);
+                ++position;
+            }
+            CHECK(iterationMatches);
+            CHECK(position == int(ordered.size()));
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int sortedCount = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    testInterleavedDeletes();
+    testDescendingInsertAndDelete(100000);
+    testSortedInsert(sortedCount);
+    return testResult("tst_binarysearchtree");
+}
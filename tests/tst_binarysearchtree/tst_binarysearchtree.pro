@@ -0,0 +1,6 @@
+TARGET = tst_binarysearchtree
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_binarysearchtree.cpp
@@ -0,0 +1,172 @@
+﻿/**
+ * @file       tst_bplustree.cpp
+ * @brief      BPlusTree 的分裂、借键、合并后的结构不变式测试
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "bplustree.h"
+#include "student.h"
+#include "testcheck.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// 节点容量取下限8，几千条记录就有四五层，删除时频繁借键和合并内部节点
+    typedef BPlusTree<QString, Student, StudentIDKey, 64> SmallTree;
+    typedef BPlusTree<QString, Student> DefaultTree;
+
+    QString studentID(int i)
+    {
+        return QString::number(qint64(2025000000) + i);
+    }
+
+    Student makeStudent(int i)
+    {
+        Student student;
+        student.studentID = studentID(i);
+        return student;
+    }
+
+    /**
+     * @brief 树中的记录与参照模型（按学号升序的编号）完全一致
+     */
+    template<typename Tree>
+    bool matches(const Tree &tree, const std::vector<int> &ordered)
+    {
+        if (tree.size() != int(ordered.size())) {
+            return false;
+        }
+        std::size_t position = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it, ++position) {
+            if (position >= ordered.size() || it.key() != studentID(ordered[position])
+                || it->studentID != it.key()) {
+                return false;
+            }
+        }
+        return position == ordered.size();
+    }
+
+    /**
+     * @brief 顺序追加（右侧分裂让左节点满载）后按各种顺序删除，每批删除后检查不变式
+     */
+    template<typename Tree>
+    void testAppendThenDelete(int n)
+    {
+        Tree tree;
+        for (int i = 0; i < n; ++i) {
+            tree.insert(makeStudent(i));
+        }
+        CHECK(tree.isValid());
+        CHECK(tree.size() == n);
+
+        std::vector<bool> present(n, true);
+        auto remaining = [&]() {
+            std::vector<int> ordered;
+            for (int i = 0; i < n; ++i) {
+                if (present[i]) {
+                    ordered.push_back(i);
+                }
+            }
+            return ordered;
+        };
+
+        // 删除每隔一条的记录: 几乎每个叶子都下溢，先借键后合并
+        for (int i = 0; i < n; i += 2) {
+            CHECK(tree.deleteStudent(studentID(i)));
+            present[i] = false;
+        }
+        CHECK(tree.isValid());
+        CHECK(matches(tree, remaining()));
+
+        // 从左端删除一段连续区间: 左侧节点整片合并，内部节点跟着下溢
+        for (int i = 1; i < n / 2; i += 2) {
+            CHECK(tree.deleteStudent(studentID(i)));
+            present[i] = false;
+        }
+        CHECK(tree.isValid());
+        CHECK(matches(tree, remaining()));
+
+        // 区间扫描只访问 [low, high] 内的记录
+        const std::vector<int> ordered = remaining();
+        if (ordered.size() > 10) {
+            const int low = ordered[3];
+            const int high = ordered[ordered.size() - 4];
+            int visited = tree.rangeScan(studentID(low), studentID(high), [](const Student &) {});
+            CHECK(visited == int(ordered.size()) - 6);
+        }
+
+        // 删空后树高回到0
+        for (int i : ordered) {
+            CHECK(tree.deleteStudent(studentID(i)));
+        }
+        CHECK(tree.isValid());
+        CHECK(tree.isEmpty());
+        CHECK(tree.height() == 0);
+        CHECK(tree.begin() == tree.end());
+    }
+
+    /**
+     * @brief 随机交替插入和删除，定期检查不变式并与参照模型比较
+     */
+    template<typename Tree>
+    void testRandomOperations(int universe, int steps)
+    {
+        std::mt19937 random(20261017);
+        std::uniform_int_distribution<int> pick(0, universe - 1);
+
+        Tree tree;
+        std::vector<bool> present(universe, false);
+        bool valid = true;
+        bool consistent = true;
+
+        for (int step = 1; step <= steps; ++step) {
+            const int i = pick(random);
+            if (present[i]) {
+                consistent = consistent && !tree.insert(makeStudent(i)) && tree.deleteStudent(studentID(i));
+            } else {
+                consistent = consistent && !tree.deleteStudent(studentID(i)) && tree.insert(makeStudent(i));
+            }
+            present[i] = !present[i];
+
+            if (step % 1000 == 0) {
+                valid = valid && tree.isValid();
+                std::vector<int> ordered;
+                for (int j = 0; j < universe; ++j) {
+                    if (present[j]) {
+                        ordered.push_back(j);
+                    }
+                }
+                consistent = consistent && matches(tree, ordered);
+            }
+        }
+        CHECK(valid);
+        CHECK(consistent);
+
+        bool lookups = true;
+        for (int i = 0; i < universe; ++i) {
+            Student student;
+            const bool found = tree.search(studentID(i), student);
+            lookups = lookups && found == bool(present[i]) && tree.contains(studentID(i)) == bool(present[i])
+                && (!found || student.studentID == studentID(i));
+        }
+        CHECK(lookups);
+    }
+}
+
+int main()
+{
+    testAppendThenDelete<SmallTree>(5000);
+    testAppendThenDelete<DefaultTree>(50000);
+    testRandomOperations<SmallTree>(3000, 60000);
+    testRandomOperations<DefaultTree>(20000, 100000);
+    return testResult("tst_bplustree");
+}
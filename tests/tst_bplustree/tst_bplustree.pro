@@ -0,0 +1,6 @@
+TARGET = tst_bplustree
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_bplustree.cpp
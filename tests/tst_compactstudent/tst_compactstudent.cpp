@@ -0,0 +1,150 @@
+﻿/**
+ * @file       tst_compactstudent.cpp
+ * @brief      CompactStudent 学号编码的边界情况和往返还原测试
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "compactstudent.h"
+#include "student.h"
+#include "testcheck.h"
+
+#include <QDate>
+#include <QString>
+
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief 编码后再解码得到原学号，且查找用的编码与插入时一致
+     */
+    bool roundTrips(const QString &studentID, StudentStringPool &pool)
+    {
+        const quint64 key = CompactStudent::encodeID(studentID, pool);
+        quint64 found = 0;
+        return CompactStudent::decodeID(key, pool) == studentID
+            && CompactStudent::findID(studentID, pool, found) && found == key;
+    }
+
+    bool isNumeric(const QString &studentID)
+    {
+        quint64 key;
+        return CompactStudent::encodeNumericID(studentID, key);
+    }
+
+    /**
+     * @brief 纯数字学号的边界: 前导零、全零、恰好17位；18位和空学号改存字符串池
+     */
+    void testBoundaries()
+    {
+        StudentStringPool pool;
+
+        // 前导零保留在位数里，"0012"、"012"、"12" 是三个不同的学号
+        quint64 a, b, c;
+        CHECK(CompactStudent::encodeNumericID("0012", a));
+        CHECK(CompactStudent::encodeNumericID("012", b));
+        CHECK(CompactStudent::encodeNumericID("12", c));
+        CHECK(a != b && b != c && a != c);
+        CHECK(a == ((quint64(4) << CompactStudent::DigitShift) | 12));
+        CHECK(roundTrips("0012", pool));
+        CHECK(roundTrips("0", pool));
+        CHECK(roundTrips("0000", pool));
+
+        // 恰好17位仍是数字编码，最大值不溢出到位数字段
+        CHECK(isNumeric("12345678901234567"));
+        CHECK(isNumeric("99999999999999999"));
+        CHECK(isNumeric("00000000000000001"));
+        CHECK(roundTrips("12345678901234567", pool));
+        CHECK(roundTrips("99999999999999999", pool));
+        CHECK(roundTrips("00000000000000001", pool));
+
+        // 18位超出 MaxDigits，改存字符串池，同样无损还原
+        const int pooledBefore = pool.text.size();
+        CHECK(!isNumeric("123456789012345678"));
+        const quint64 pooled = CompactStudent::encodeID("123456789012345678", pool);
+        CHECK((pooled & CompactStudent::PooledIDFlag) != 0);
+        CHECK(pool.text.size() == pooledBefore + 1);
+        CHECK(roundTrips("123456789012345678", pool));
+        CHECK(roundTrips("999999999999999999", pool));
+
+        // 空学号和非数字学号也走字符串池，空字符串固定为编号0
+        CHECK(!isNumeric(""));
+        CHECK(CompactStudent::encodeID("", pool) == CompactStudent::PooledIDFlag);
+        CHECK(roundTrips("", pool));
+        CHECK(!isNumeric("12a4"));
+        CHECK(!isNumeric("-12"));
+        CHECK(roundTrips("12a4", pool));
+        CHECK(roundTrips("X2025", pool));
+
+        // 查找不修改池: 从未插入的非数字学号找不到
+        quint64 key;
+        const int poolSize = pool.text.size();
+        CHECK(!CompactStudent::findID("never-inserted", pool, key));
+        CHECK(!CompactStudent::findID("1234567890123456789", pool, key));
+        CHECK(pool.text.size() == poolSize);
+    }
+
+    /**
+     * @brief 编码顺序: 位数相同时与字符串顺序一致，短的在前，非数字学号排在所有数字学号之后
+     */
+    void testOrdering()
+    {
+        StudentStringPool pool;
+        const std::vector<QString> ordered = {
+            "0", "9", "00", "09", "10", "0012", "2025000001", "2025000002",
+            "00000000000000000", "99999999999999999"
+        };
+        bool ascending = true;
+        for (std::size_t i = 1; i < ordered.size(); ++i) {
+            ascending = ascending
+                && CompactStudent::encodeID(ordered[i - 1], pool) < CompactStudent::encodeID(ordered[i], pool);
+        }
+        CHECK(ascending);
+
+        const quint64 largestNumeric = CompactStudent::encodeID("99999999999999999", pool);
+        CHECK(CompactStudent::encodeID("", pool) > largestNumeric);
+        CHECK(CompactStudent::encodeID("123456789012345678", pool) > largestNumeric);
+        CHECK(CompactStudent::encodeID("A", pool) > largestNumeric);
+    }
+
+    /**
+     * @brief 整条记录经 fromStudent/toStudent 往返后各字段不变，包括无效出生日期
+     */
+    void testStudentRoundTrip()
+    {
+        StudentStringPool pool;
+        const std::vector<Student> students = {
+            Student("0012", "张三", QDate(2005, 3, 1), "男", "北京", 10, -20),
+            Student("12345678901234567", "李四", QDate(), "女", "上海", -1000000, 1000000),
+            Student("123456789012345678", "", QDate(1999, 12, 31), "", "", 0, 0),
+            Student("", "王五", QDate(2000, 1, 1), "男", "广州", 5, 5)
+        };
+        bool same = true;
+        for (const Student &student : students) {
+            CompactStudent record;
+            CHECK(CompactStudent::fromStudent(student, pool, record));
+            const Student restored = record.toStudent(pool);
+            same = same && restored.studentID == student.studentID && restored.name == student.name
+                && restored.birthDate == student.birthDate && restored.gender == student.gender
+                && restored.addressName == student.addressName
+                && restored.addressCoordX == student.addressCoordX
+                && restored.addressCoordY == student.addressCoordY;
+        }
+        CHECK(same);
+    }
+}
+
+int main()
+{
+    testBoundaries();
+    testOrdering();
+    testStudentRoundTrip();
+    return testResult("tst_compactstudent");
+}
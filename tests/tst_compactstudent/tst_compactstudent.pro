@@ -0,0 +1,6 @@
+TARGET = tst_compactstudent
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_compactstudent.cpp
@@ -0,0 +1,230 @@
+﻿/**
+ * @file       tst_counttriggers.cpp
+ * @brief      计数缓存和R树触发器在 UPSERT、删除、批量导入和清空之后与 students 表保持一致
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "connectionmanager.h"
+#include "studentrepository.h"
+#include "studentschema.h"
+#include "student.h"
+#include "testcheck.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDate>
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include <cstdio>
+
+namespace
+{
+    bool spatial = false;   ///< students_rtree 是否可用（SQLite 未编译 rtree 模块时跳过R树检查）
+
+    /**
+     * @brief 执行一条返回单个整数的查询，失败时返回 -1
+     */
+    qint64 scalar(QSqlDatabase &database, const QString &sql)
+    {
+        QSqlQuery query(database);
+        if (!query.exec(sql) || !query.next()) {
+            return -1;
+        }
+        return query.value(0).toLongLong();
+    }
+
+    /**
+     * @brief 计数表、R树与按 students 表重新统计的结果完全一致
+     */
+    bool cachesMatch(QSqlDatabase &database)
+    {
+        const bool totalMatches =
+            scalar(database, "SELECT cnt FROM students_total WHERE id = 0")
+            == scalar(database, "SELECT COUNT(*) FROM students");
+
+        // 对称差为空: 既没有多出的计数行，也没有缺少或数错的
+        const qint64 nameDifference = scalar(database,
+            "SELECT (SELECT COUNT(*) FROM ("
+            "SELECT name, cnt FROM students_name_counts "
+            "EXCEPT SELECT name, COUNT(*) FROM students GROUP BY name)) "
+            "+ (SELECT COUNT(*) FROM ("
+            "SELECT name, COUNT(*) FROM students GROUP BY name "
+            "EXCEPT SELECT name, cnt FROM students_name_counts))");
+        const qint64 coordXDifference = scalar(database,
+            "SELECT (SELECT COUNT(*) FROM ("
+            "SELECT addressCoordX, cnt FROM students_coordx_counts "
+            "EXCEPT SELECT addressCoordX, COUNT(*) FROM students GROUP BY addressCoordX)) "
+            "+ (SELECT COUNT(*) FROM ("
+            "SELECT addressCoordX, COUNT(*) FROM students GROUP BY addressCoordX "
+            "EXCEPT SELECT addressCoordX, cnt FROM students_coordx_counts))");
+
+        bool rtreeMatches = true;
+        if (spatial) {
+            rtreeMatches =
+                scalar(database, "SELECT COUNT(*) FROM students_rtree")
+                    == scalar(database, "SELECT COUNT(*) FROM students")
+                && scalar(database,
+                          "SELECT COUNT(*) FROM students LEFT JOIN students_rtree AS r ON r.id = students.id "
+                          "WHERE r.id IS NULL OR r.minX != students.addressCoordX OR r.maxX != students.addressCoordX "
+                          "OR r.minY != students.addressCoordY OR r.maxY != students.addressCoordY") == 0;
+        }
+        return totalMatches && nameDifference == 0 && coordXDifference == 0 && rtreeMatches;
+    }
+
+    /**
+     * @brief 姓名和X坐标只取少数几个值，让多名学生共用同一计数行
+     */
+    Student makeStudent(int i, int variant)
+    {
+        const char *names[] = { "张三", "李四", "王五", "赵六", "钱七" };
+        const char *genders[] = { "男", "女" };
+        const char *addresses[] = { "北京市", "上海", "广州" };
+        return Student(QString::number(qint64(2025000000) + i),
+                       names[(i + variant) % 5],
+                       QDate(2000 + i % 6, 1 + i % 12, 1 + i % 28),
+                       genders[i % 2],
+                       addresses[(i + variant) % 3],
+                       (i * 7 + variant * 13) % 41 - 20,
+                       (i * 3 + variant) % 19 - 9);
+    }
+
+    QVector<Student> makeStudents(int first, int count, int variant)
+    {
+        QVector<Student> students;
+        for (int i = first; i < first + count; ++i) {
+            students.append(makeStudent(i, variant));
+        }
+        return students;
+    }
+
+    /**
+     * @brief UPSERT 覆盖已有学号时，计数从旧的姓名/坐标移到新的，总数不变
+     */
+    void testUpsert(QSqlDatabase &database)
+    {
+        ImportResult result = StudentRepository::upsert(database, makeStudents(0, 1000, 0));
+        CHECK(result.status == ImportResult::Ok && result.successCount == 1000 && result.failCount == 0);
+        CHECK(scalar(database, "SELECT COUNT(*) FROM students") == 1000);
+        CHECK(cachesMatch(database));
+
+        // 前500条覆盖已有学号（姓名和坐标都变了），后500条是新记录
+        result = StudentRepository::upsert(database, makeStudents(500, 1000, 1));
+        CHECK(result.status == ImportResult::Ok && result.successCount == 1000);
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 1500);
+        CHECK(cachesMatch(database));
+
+        // 原样重复写入同一批，计数不变
+        result = StudentRepository::upsert(database, makeStudents(500, 1000, 1));
+        CHECK(result.status == ImportResult::Ok);
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 1500);
+        CHECK(cachesMatch(database));
+    }
+
+    /**
+     * @brief 删除后计数减一，归零的计数行被删除；重复插入失败且不改变计数，也不留下字典项
+     */
+    void testInsertAndRemove(QSqlDatabase &database)
+    {
+        QString error;
+        bool removed = false;
+        for (int i = 0; i < 1500; i += 3) {
+            CHECK(StudentRepository::remove(QString::number(qint64(2025000000) + i), removed, error) && removed);
+        }
+        CHECK(StudentRepository::remove("no-such-student", removed, error) && !removed);
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 1000);
+        CHECK(scalar(database, "SELECT COUNT(*) FROM students_name_counts WHERE cnt <= 0") == 0);
+        CHECK(scalar(database, "SELECT COUNT(*) FROM students_coordx_counts WHERE cnt <= 0") == 0);
+        CHECK(cachesMatch(database));
+
+        CHECK(StudentRepository::insert(makeStudent(0, 2), error));
+        CHECK(!StudentRepository::insert(makeStudent(1, 2), error));
+
+        // 学号重复时，为新的性别/地址名写入的字典项随插入一起回滚
+        const qint64 dictionaryStrings = scalar(database, "SELECT COUNT(*) FROM student_strings");
+        Student duplicate = makeStudent(1, 2);
+        duplicate.gender = "未填写";
+        duplicate.addressName = "新地址";
+        CHECK(!StudentRepository::insert(duplicate, error));
+        CHECK(scalar(database, "SELECT COUNT(*) FROM student_strings") == dictionaryStrings);
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 1001);
+        CHECK(cachesMatch(database));
+    }
+
+    /**
+     * @brief 清空后计数归零；空表上的文件导入走批量路径（先删触发器，导入后重建），之后计数仍一致
+     */
+    void testClearAndBulkImport(QSqlDatabase &database, const QString &dataPath)
+    {
+        QString error;
+        CHECK(StudentSchema::clear(database, spatial, error));
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 0);
+        CHECK(scalar(database, "SELECT COUNT(*) FROM students_name_counts") == 0);
+        CHECK(cachesMatch(database));
+
+        // 导入格式: 学号,姓名,出生日期,性别,地址,X,Y（UTF-8）
+        QByteArray text;
+        for (const Student &student : makeStudents(0, 3000, 3)) {
+            text += QString("%1,%2,%3,%4,%5,%6,%7\n")
+                        .arg(student.studentID, student.name, student.birthDate.toString("yyyy-MM-dd"),
+                             student.gender, student.addressName)
+                        .arg(student.addressCoordX)
+                        .arg(student.addressCoordY)
+                        .toUtf8();
+        }
+        QFile file(dataPath);
+        CHECK(file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(text) == text.size());
+        file.close();
+
+        const ImportResult result = StudentRepository::importFile(database, dataPath);
+        CHECK(result.status == ImportResult::Ok && result.successCount == 3000 && result.failCount == 0);
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 3000);
+        CHECK(cachesMatch(database));
+
+        // 批量导入后触发器已重建，逐行维护继续生效
+        CHECK(StudentRepository::upsert(database, makeStudents(2500, 1000, 4)).status == ImportResult::Ok);
+        CHECK(scalar(database, "SELECT cnt FROM students_total WHERE id = 0") == 3500);
+        CHECK(cachesMatch(database));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QTemporaryDir directory;
+    CHECK(directory.isValid());
+    ConnectionManager::instance().setDatabaseName(directory.filePath("students.db"));
+    QSqlDatabase database = ConnectionManager::instance().connection();
+    CHECK(database.isOpen());
+
+    bool migrated = false;
+    QString error;
+    CHECK(StudentSchema::create(database, migrated, error));
+    CHECK(!migrated);
+    QSqlQuery query(database);
+    if (!StudentSchema::hasCountCache(query)) {
+        CHECK(StudentSchema::rebuildCountCache(database));
+    }
+    spatial = StudentSchema::createSpatialIndex(database, error);
+    if (!spatial) {
+        std::printf("SKIP R-tree checks: %s\n", qPrintable(error));
+    }
+
+    if (testFailures() == 0) {
+        testUpsert(database);
+        testInsertAndRemove(database);
+        testClearAndBulkImport(database, directory.filePath("students.txt"));
+    }
+    return testResult("tst_counttriggers");
+}
@@ -0,0 +1,7 @@
+TARGET = tst_counttriggers
+
+include(../tests.pri)
+include(../../studentrepository.pri)
+
+SOURCES += \
+    tst_counttriggers.cpp
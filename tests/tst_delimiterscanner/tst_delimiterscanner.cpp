@@ -0,0 +1,131 @@
+﻿/**
+ * @file       tst_delimiterscanner.cpp
+ * @brief      DelimiterScanner 各实现与逐字节参照结果一致性测试
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "delimiterscanner.h"
+#include "testcheck.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const DelimiterScanner::Kernel Kernels[] = {
+        DelimiterScanner::Scalar, DelimiterScanner::SSE2, DelimiterScanner::AVX2
+    };
+
+    std::vector<quint32> reference(const char* begin, const char* end)
+    {
+        std::vector<quint32> offsets;
+        for (const char* p = begin; p < end; ++p) {
+            if (*p == ',' || *p == '\n') {
+                offsets.push_back(quint32(p - begin));
+            }
+        }
+        return offsets;
+    }
+
+    /**
+     * @brief 用指定实现扫描 [begin, end)，结果与参照完全相同
+     * @param[in,out] offsets 在多次调用间复用，检查旧内容不会混入结果
+     */
+    bool scanMatches(DelimiterScanner::Kernel kernel, const char* begin, const char* end,
+                     std::vector<quint32>& offsets)
+    {
+        const std::vector<quint32> expected = reference(begin, end);
+        const int count = DelimiterScanner::scan(kernel, begin, end, offsets);
+        if (count != int(expected.size())) {
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (offsets[i] != expected[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 随机字节，分隔符较密，并混入最高位为1、低7位与分隔符相同的字节
+     */
+    std::vector<char> randomBytes(std::size_t size, unsigned seed)
+    {
+        const char alphabet[] = { ',', '\n', 'a', '0', '\r', char(0xAC), char(0x8A), char(0xE5), char(0xFF), '\0' };
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> pick(0, int(sizeof(alphabet)) - 1);
+        std::vector<char> bytes(size);
+        for (char& byte : bytes) {
+            byte = alphabet[pick(random)];
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief 每种起始对齐和 0~200 字节的长度，覆盖向量循环和标量尾部的所有组合
+     */
+    void testAlignmentsAndTails(DelimiterScanner::Kernel kernel)
+    {
+        const std::vector<char> bytes = randomBytes(4096, 1);
+        std::vector<quint32> offsets;
+        bool allMatch = true;
+        for (int start = 0; start < 64; ++start) {
+            for (int length = 0; length <= 200; ++length) {
+                const char* begin = bytes.data() + start;
+                allMatch = allMatch && scanMatches(kernel, begin, begin + length, offsets);
+            }
+        }
+        CHECK(allMatch);
+    }
+
+    /**
+     * @brief 整块扫描: 大块随机数据、全为分隔符、没有分隔符
+     */
+    void testBlocks(DelimiterScanner::Kernel kernel)
+    {
+        std::vector<quint32> offsets;
+
+        const std::vector<char> large = randomBytes(1 << 20, 2);
+        CHECK(scanMatches(kernel, large.data(), large.data() + large.size(), offsets));
+
+        std::vector<char> dense(4099);
+        for (std::size_t i = 0; i < dense.size(); ++i) {
+            dense[i] = (i % 2) ? ',' : '\n';
+        }
+        CHECK(scanMatches(kernel, dense.data(), dense.data() + dense.size(), offsets));
+        CHECK(DelimiterScanner::scan(kernel, dense.data(), dense.data() + dense.size(), offsets) == int(dense.size()));
+
+        // 缓冲区仍保留上一次的偏移，结果只看返回的前 n 项
+        const std::vector<char> plain(1000, 'x');
+        CHECK(DelimiterScanner::scan(kernel, plain.data(), plain.data() + plain.size(), offsets) == 0);
+
+        const char line[] = "2025000001,张三,2005-03-01,男,北京,10,-20\n";
+        CHECK(scanMatches(kernel, line, line + sizeof(line) - 1, offsets));
+        CHECK(DelimiterScanner::scan(kernel, line, line + sizeof(line) - 1, offsets) == 7);
+    }
+}
+
+int main()
+{
+    CHECK(DelimiterScanner::isSupported(DelimiterScanner::Scalar));
+    CHECK(DelimiterScanner::isSupported(DelimiterScanner::bestKernel()));
+
+    for (DelimiterScanner::Kernel kernel : Kernels) {
+        if (!DelimiterScanner::isSupported(kernel)) {
+            std::printf("SKIP %s: not supported on this CPU or compiler\n", DelimiterScanner::kernelName(kernel));
+            continue;
+        }
+        testAlignmentsAndTails(kernel);
+        testBlocks(kernel);
+    }
+    return testResult("tst_delimiterscanner");
+}
@@ -0,0 +1,7 @@
+TARGET = tst_delimiterscanner
+
+include(../tests.pri)
+include(../../studentrepository.pri)
+
+SOURCES += \
+    tst_delimiterscanner.cpp
@@ -0,0 +1,158 @@
+﻿/**
+ * @file       tst_studentsnapshot.cpp
+ * @brief      列式快照的往返编解码和损坏检测测试
+ * @copyright  Copyright (c) 2026
+ * @license    MIT
+ * @author     lzq
+ * @version    1.0
+ * @date       2026-10-17
+ *
+ * @par        版本历史:
+ *             V1.0:[lzq] [2026-10-17] [创建文件]
+ */
+
+#include "studentsnapshot.h"
+#include "student.h"
+#include "testcheck.h"
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDate>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    bool sameStudent(const Student &a, const Student &b)
+    {
+        return a.studentID == b.studentID && a.name == b.name && a.birthDate == b.birthDate
+            && a.gender == b.gender && a.addressName == b.addressName
+            && a.addressCoordX == b.addressCoordX && a.addressCoordY == b.addressCoordY;
+    }
+
+    /**
+     * @brief 覆盖各种编码分支的记录: 递增/乱序的数字学号、非数字学号、无效日期、负坐标和超出常规范围的坐标
+     */
+    std::vector<Student> makeStudents(int count, unsigned seed)
+    {
+        const char *names[] = { "张三", "李四", "王五", "" };
+        const char *genders[] = { "男", "女", "" };
+        const char *addresses[] = { "北京市", "上海", "广州,天河", "" };
+
+        std::mt19937 random(seed);
+        std::vector<Student> students;
+        for (int i = 0; i < count; ++i) {
+            QString id;
+            if (i % 97 == 0) {
+                id = QString("X") + QString::number(qint64(random() % 100000));
+            } else if (i % 13 == 0) {
+                id = QString::number(qint64(random() % 9000000) + 2025000000); // 与前一行的差为负
+            } else {
+                id = QString::number(qint64(2025000000) + i * 3);
+            }
+            const QDate birthDate = (i % 11 == 0) ? QDate() : QDate::fromJulianDay(2450000 + qint64(random() % 4000));
+            const int x = (i % 17 == 0) ? int(random() % 2000001) - 1000000 : int(random() % 20001) - 10000;
+            const int y = int(random() % 200);
+            students.push_back(Student(id, names[i % 4], birthDate, genders[i % 3], addresses[i % 4], x, y));
+        }
+        return students;
+    }
+
+    QByteArray encode(const std::vector<Student> &students)
+    {
+        StudentSnapshotWriter writer;
+        for (const Student &student : students) {
+            writer.append(student);
+        }
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        const qint64 written = writer.write(buffer);
+        CHECK(written == buffer.data().size());
+        return buffer.data();
+    }
+
+    /**
+     * @brief 打开并解码全部记录
+     * @return 快照被接受且与 expected 完全一致时返回1，被拒绝时返回0，被接受但内容不同时返回-1
+     */
+    int decode(const char *begin, const char *end, const std::vector<Student> &expected)
+    {
+        StudentSnapshotReader reader;
+        if (!reader.open(begin, end)) {
+            return reader.status() == StudentSnapshotReader::Ok ? -1 : 0;
+        }
+        if (reader.rowCount() != qint64(expected.size())) {
+            return -1;
+        }
+        Student student;
+        std::size_t row = 0;
+        bool same = true;
+        while (reader.next(student)) {
+            same = same && row < expected.size() && sameStudent(student, expected[row]);
+            ++row;
+        }
+        if (reader.status() != StudentSnapshotReader::Ok) {
+            return 0;
+        }
+        return same && row == expected.size() ? 1 : -1;
+    }
+
+    void testRoundTrip()
+    {
+        const std::vector<Student> students = makeStudents(50000, 1);
+        const QByteArray bytes = encode(students);
+        CHECK(bytes.size() % 8 == 0);
+        CHECK(StudentSnapshotReader::isSnapshot(bytes.constData(), bytes.constData() + bytes.size()));
+        CHECK(decode(bytes.constData(), bytes.constData() + bytes.size(), students) == 1);
+
+        // 空快照仍是有效文件，没有记录
+        const QByteArray empty = encode(std::vector<Student>());
+        CHECK(decode(empty.constData(), empty.constData() + empty.size(), std::vector<Student>()) == 1);
+
+        const char text[] = "2025000001,张三,2005-03-01,男,北京,10,-20\n";
+        CHECK(!StudentSnapshotReader::isSnapshot(text, text + sizeof(text) - 1));
+        StudentSnapshotReader reader;
+        CHECK(!reader.open(text, text + sizeof(text) - 1));
+        CHECK(reader.status() == StudentSnapshotReader::FormatError);
+    }
+
+    /**
+     * @brief 逐字节翻转和逐长度截断: 损坏的快照要么被拒绝，要么（只改动了段间填充时）解码出原样数据，
+     *        绝不能被接受却解码出不同的记录
+     */
+    void testCorruption()
+    {
+        const std::vector<Student> students = makeStudents(300, 2);
+        const QByteArray bytes = encode(students);
+
+        int rejected = 0;
+        bool neverWrong = true;
+        for (int position = 0; position < bytes.size(); ++position) {
+            for (int flip : { 0x01, 0x80, 0xFF }) {
+                QByteArray damaged = bytes;
+                damaged[position] = char(damaged[position] ^ flip);
+                const int outcome = decode(damaged.constData(), damaged.constData() + damaged.size(), students);
+                neverWrong = neverWrong && outcome >= 0;
+                rejected += outcome == 0;
+            }
+        }
+        CHECK(neverWrong);
+        CHECK(rejected > 0);
+
+        bool truncationRejected = true;
+        for (int length = 0; length < bytes.size(); ++length) {
+            const int outcome = decode(bytes.constData(), bytes.constData() + length, students);
+            // 只截掉末尾的填充字节时数据仍完整
+            truncationRejected = truncationRejected && (outcome == 0 || (outcome == 1 && length > bytes.size() - 8));
+        }
+        CHECK(truncationRejected);
+    }
+}
+
+int main()
+{
+    testRoundTrip();
+    testCorruption();
+    return testResult("tst_studentsnapshot");
+}
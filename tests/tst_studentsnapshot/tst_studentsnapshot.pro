@@ -0,0 +1,7 @@
+TARGET = tst_studentsnapshot
+
+include(../tests.pri)
+include(../../studentrepository.pri)
+
+SOURCES += \
+    tst_studentsnapshot.cpp